@@ -0,0 +1,56 @@
+#version 420 core
+
+in vec3 FragPos;
+
+out vec4 FragColor;
+
+uniform vec4 groundColor = vec4(0.5, 0.5, 0.5, 1.0);   // 地面颜色
+uniform vec4 lineColor = vec4(0.0, 0.0, 0.0, 1.0);     // 网格线颜色
+uniform vec4 xAxisColor = vec4(1.0, 0.0, 0.0, 1.0);    // 第0行（X轴）的格线颜色
+uniform vec4 yAxisColor = vec4(0.0, 0.0, 1.0, 1.0);    // 第0列（Y轴）的格线颜色
+uniform float lineWidth = 1.5;                          // 网格线宽度（像素）
+
+uniform vec3 lightPos;
+uniform vec3 lightColor = vec3(1.0, 1.0, 1.0);
+uniform float ambientStrength = 0.1;
+
+uniform vec2 mapSize;                                   // 地图尺寸（格）
+uniform bool showClearance = false;                     // 叠加到静态障碍物的距离热力图
+uniform sampler2D clearanceMap;                         // 距离场，纹素中心对应格子中心
+uniform float clearanceScale = 8.0;                     // 颜色从红到绿覆盖的距离
+
+void main()
+{
+    // 以格子边界为整数的坐标：格子(x, y)覆盖[x, x + 1) x [y, y + 1)
+    vec2 cellCoord = FragPos.xz + 0.5;
+    vec2 cell = floor(cellCoord);
+    
+    // 到最近格线的距离换算成像素，fwidth保证远近线宽一致且抗锯齿
+    vec2 distToLine = abs(fract(cellCoord - 0.5) - 0.5) / fwidth(cellCoord);
+    float lineMask = 1.0 - clamp(min(distToLine.x, distToLine.y) - lineWidth * 0.5 + 0.5, 0.0, 1.0);
+    
+    // 第0行、第0列的格子边框标记坐标轴方向
+    vec4 edgeColor = lineColor;
+    if (cell.y < 0.5) {
+        edgeColor = xAxisColor;
+    } else if (cell.x < 0.5) {
+        edgeColor = yAxisColor;
+    }
+    
+    // 朝上的平面只需计算漫反射
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(lightDir.y, 0.0);
+    vec3 lighting = ambientStrength * lightColor + diff * lightColor;
+    
+    vec3 baseColor = groundColor.rgb;
+    if (showClearance) {
+        // 距离归一化后映射为红-黄-绿，硬件线性过滤完成格子中心之间的双线性插值
+        float t = clamp(texture(clearanceMap, cellCoord / mapSize).r / clearanceScale, 0.0, 1.0);
+        vec3 heat = t < 0.5 ? mix(vec3(0.9, 0.1, 0.1), vec3(0.9, 0.8, 0.1), t * 2.0)
+                            : mix(vec3(0.9, 0.8, 0.1), vec3(0.1, 0.7, 0.2), t * 2.0 - 1.0);
+        baseColor = mix(baseColor, heat, 0.7);
+    }
+    
+    vec3 color = mix(baseColor * lighting, edgeColor.rgb, lineMask);
+    FragColor = vec4(color, groundColor.a);
+}
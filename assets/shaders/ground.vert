@@ -0,0 +1,18 @@
+#version 420 core
+
+// 单位正方形顶点 [0,1]x[0,1]，按地图尺寸拉伸成整张地面
+layout (location = 0) in vec2 aCorner;
+
+out vec3 FragPos;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec2 mapSize;        // 地图宽高（格数）
+
+void main()
+{
+    // 格子中心位于整数坐标，地面覆盖[-0.5, size - 0.5]
+    vec2 xz = aCorner * mapSize - 0.5;
+    FragPos = vec3(xz.x, 0.0, xz.y);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,559 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "bench/movingAi.h"
+#include "common/profiler.h"
+#include "headless/headlessRunner.h"
+#include "maze/maze.h"
+
+using namespace PathGlyph;
+
+namespace {
+
+// 一个场景文件在一种规划算法下的统计，只有数值字段，可以从子进程按字节传回
+struct PlannerMetrics {
+    size_t queries = 0;          // 实际运行的查询数
+    size_t solved = 0;           // 找到路径的查询数
+    size_t failed = 0;           // A*找到路径但该算法没有找到
+    double firstQueryUs = 0.0;   // 第一次查询耗时（包含JPS+跳跃表、HPA*抽象图等预处理）
+    double meanUs = 0.0;
+    double medianUs = 0.0;
+    double p95Us = 0.0;
+    double maxUs = 0.0;
+    double meanNodes = 0.0;
+    double meanGap = 0.0;        // 相对A*最优代价的平均超出比例
+    double maxGap = 0.0;
+    long peakRssKb = 0;          // 运行该组查询的子进程的峰值常驻内存（含载入的地图和场景）
+};
+
+struct BenchmarkResult : PlannerMetrics {
+    std::string scenario;
+    PlannerType planner = PlannerType::ASTAR;
+};
+
+// 一个场景文件的多代理规划统计（--agents）
+struct MapfMetrics {
+    size_t agents = 0;           // 实际参与的代理数
+    bool solved = false;
+    double timeMs = 0.0;
+    ConflictBasedSearch::Stats stats;
+    long peakRssKb = 0;
+};
+
+struct MapfResult : MapfMetrics {
+    std::string scenario;
+    double suboptimality = 1.0;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <file.scen | directory>...\n"
+              << "  --planner <astar|jps|jps+|dstar|hpa|flow>  planner to run, repeatable (default: all but flow)\n"
+              << "  --map-dir <directory>                 where to look for .map files (default: next to the .scen)\n"
+              << "  --max-queries <n>                     limit queries per scenario file\n"
+              << "  --format <csv|json>                   output format (default csv)\n"
+              << "  --output <file>                       write results to a file instead of stdout\n"
+              << "  --agents <n>                          multi-agent mode: plan the first n usable queries of each\n"
+              << "                                        scenario together as collision-free paths (CBS/ECBS)\n"
+              << "  --suboptimality <w>                   multi-agent bound, 1 for optimal CBS (default 1)\n";
+}
+
+long peakRssKb() {
+#if defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<long>(usage.ru_maxrss / 1024);  // macOS以字节为单位
+#elif defined(__unix__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<long>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+// 在子进程中执行run，把它填好的count个元素按字节传回values。ru_maxrss是只增不减的进程峰值，
+// 每组查询使用新的子进程，峰值才只反映这一组查询（加上fork时父进程已载入的地图和场景）。
+// 父进程只解析文件，不创建迷宫，也就不会启动线程池，fork时没有其他线程；子进程按需创建自己的线程池。
+// 不支持fork的平台直接在本进程执行，峰值内存退化为进程至今的最大值
+template <typename T>
+bool runIsolated(T* values, size_t count, const std::function<void(T*)>& run) {
+    static_assert(std::is_trivially_copyable_v<T>, "values are copied through a pipe");
+#if defined(__unix__) || defined(__APPLE__)
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    const size_t bytes = count * sizeof(T);
+    if (pid == 0) {
+        close(fds[0]);
+        std::vector<T> result(count);
+        run(result.data());
+        const char* data = reinterpret_cast<const char*>(result.data());
+        size_t written = 0;
+        while (written < bytes) {
+            const ssize_t chunk = write(fds[1], data + written, bytes - written);
+            if (chunk <= 0) {
+                break;
+            }
+            written += static_cast<size_t>(chunk);
+        }
+        // 不运行静态对象的析构（子进程的线程池线程不需要回收）
+        _exit(written == bytes ? 0 : 1);
+    }
+
+    close(fds[1]);
+    // values可能是派生结果的基类子对象，先读入完整的局部对象再逐个赋值
+    std::vector<T> result(count);
+    char* data = reinterpret_cast<char*>(result.data());
+    size_t received = 0;
+    while (received < bytes) {
+        const ssize_t chunk = read(fds[0], data + received, bytes - received);
+        if (chunk <= 0) {
+            break;
+        }
+        received += static_cast<size_t>(chunk);
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (received != bytes || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return false;
+    }
+    std::copy(result.begin(), result.end(), values);
+    return true;
+#else
+    run(values);
+    return true;
+#endif
+}
+
+template <typename Metrics>
+bool runIsolated(Metrics& metrics, const std::function<void(Metrics&)>& run) {
+    return runIsolated<Metrics>(&metrics, 1, [&](Metrics* result) { run(*result); });
+}
+
+// 目录展开为其中的所有.scen文件（按文件名排序）
+void collectScenarioFiles(const std::string& path, std::vector<std::string>& files) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error)) {
+        files.push_back(path);
+        return;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".scen") {
+            found.push_back(entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
+
+// 场景文件里的地图路径通常是相对于基准集根目录的，依次在--map-dir、场景文件所在目录中按文件名查找
+std::string resolveMapFile(const std::string& scenarioFile, const std::string& mapName, const std::string& mapDir) {
+    std::filesystem::path fileName = std::filesystem::path(mapName).filename();
+    std::vector<std::filesystem::path> candidates;
+    if (!mapDir.empty()) {
+        candidates.push_back(std::filesystem::path(mapDir) / fileName);
+        candidates.push_back(std::filesystem::path(mapDir) / mapName);
+    }
+    std::filesystem::path scenarioDir = std::filesystem::path(scenarioFile).parent_path();
+    candidates.push_back(scenarioDir / fileName);
+    candidates.push_back(scenarioDir / mapName);
+    candidates.push_back(mapName);
+
+    std::error_code error;
+    for (const auto& candidate : candidates) {
+        if (std::filesystem::is_regular_file(candidate, error)) {
+            return candidate.string();
+        }
+    }
+    return {};
+}
+
+double percentile(std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// A*在本项目的移动规则（8方向、允许切角）下是最优的，作为最优性差距的基准；
+// 场景文件中的参考长度不允许切角，不能直接比较。outCosts按queries的下标写入，没有路径的为负
+void computeReferenceCosts(const BenchmarkMap& map, const std::vector<BenchmarkQuery>& queries, double* outCosts) {
+    Maze reference(map.width, map.height);
+    populateMaze(map, reference);
+    std::vector<PathQuery> referenceQueries;
+    referenceQueries.reserve(queries.size());
+    for (const BenchmarkQuery& query : queries) {
+        referenceQueries.push_back({Point(query.startX, query.startY), Point(query.goalX, query.goalY)});
+    }
+    PathQueryOptions referenceOptions;
+    referenceOptions.storePath = false;
+    std::vector<PathResult> baseline = reference.findPaths(referenceQueries, referenceOptions);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        outCosts[i] = baseline[i].found ? baseline[i].stats.pathCost : -1.0;
+    }
+}
+
+// 在一个新建的迷宫上按顺序运行所有查询，每种算法使用独立的迷宫，预处理开销计入第一次查询。
+// referenceCosts为computeReferenceCosts的结果，每个场景文件只算一次
+PlannerMetrics runPlanner(const BenchmarkMap& map, const std::vector<BenchmarkQuery>& queries, PlannerType planner,
+                          const std::vector<double>& referenceCosts) {
+    PlannerMetrics result;
+
+    std::vector<double> timesUs;
+    std::vector<double> pathCosts;   // 按queries的下标，跳过或没有找到的为负
+    timesUs.reserve(queries.size());
+    pathCosts.assign(queries.size(), -1.0);
+    std::vector<uint8_t> ran(queries.size(), 0);
+    double totalNodes = 0.0;
+
+    Maze maze(map.width, map.height);
+    populateMaze(map, maze);
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const BenchmarkQuery& query = queries[i];
+        Point start(query.startX, query.startY);
+        Point goal(query.goalX, query.goalY);
+        maze.setStart(start);
+        maze.setGoal(goal);
+        // 起点或终点落在障碍物上时setStart/setGoal不生效，跳过该查询
+        if (maze.getStart().distanceTo(start) > 0.0 || maze.getGoal().distanceTo(goal) > 0.0) {
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        bool found = !maze.planPath(planner).empty();
+        double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+        const PlannerStats& stats = maze.getLastPlannerStats();
+        if (result.queries == 0) {
+            result.firstQueryUs = elapsedUs;
+        }
+        ++result.queries;
+        ran[i] = 1;
+        timesUs.push_back(elapsedUs);
+        totalNodes += static_cast<double>(stats.nodesExpanded);
+        if (found) {
+            ++result.solved;
+            pathCosts[i] = stats.pathCost;
+        }
+    }
+    result.peakRssKb = peakRssKb();
+
+    double totalGap = 0.0;
+    size_t gapCount = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        if (!ran[i] || referenceCosts[i] < 0.0) {
+            continue;
+        }
+        if (pathCosts[i] < 0.0) {
+            ++result.failed;
+        } else if (referenceCosts[i] > 0.0) {
+            double gap = pathCosts[i] / referenceCosts[i] - 1.0;
+            totalGap += gap;
+            result.maxGap = std::max(result.maxGap, gap);
+            ++gapCount;
+        }
+    }
+
+    if (result.queries > 0) {
+        double totalUs = 0.0;
+        for (double t : timesUs) {
+            totalUs += t;
+        }
+        result.meanUs = totalUs / static_cast<double>(result.queries);
+        result.meanNodes = totalNodes / static_cast<double>(result.queries);
+        std::sort(timesUs.begin(), timesUs.end());
+        result.medianUs = percentile(timesUs, 0.5);
+        result.p95Us = percentile(timesUs, 0.95);
+        result.maxUs = timesUs.back();
+    }
+    if (gapCount > 0) {
+        result.meanGap = totalGap / static_cast<double>(gapCount);
+    }
+    return result;
+}
+
+// 取前agentCount个起点和目标都可通行、且与已选代理不重复的查询，作为代理同时规划
+MapfMetrics runMultiAgent(const BenchmarkMap& map, const std::vector<BenchmarkQuery>& queries, size_t agentCount,
+                          double suboptimality) {
+    MapfMetrics result;
+
+    Maze maze(map.width, map.height);
+    populateMaze(map, maze);
+
+    std::vector<PathQuery> agents;
+    std::set<std::pair<int, int>> starts;
+    std::set<std::pair<int, int>> goals;
+    for (const BenchmarkQuery& query : queries) {
+        if (agents.size() >= agentCount) {
+            break;
+        }
+        if (!maze.isWalkable(query.startX, query.startY) || !maze.isWalkable(query.goalX, query.goalY) ||
+            starts.count({query.startX, query.startY}) || goals.count({query.goalX, query.goalY})) {
+            continue;
+        }
+        starts.insert({query.startX, query.startY});
+        goals.insert({query.goalX, query.goalY});
+        agents.push_back({Point(query.startX, query.startY), Point(query.goalX, query.goalY)});
+    }
+    result.agents = agents.size();
+
+    ConflictBasedSearch::Params params;
+    params.suboptimality = suboptimality;
+    std::vector<std::vector<Point>> paths;
+    auto begin = std::chrono::steady_clock::now();
+    result.solved = maze.findCollisionFreePaths(agents, params, paths, &result.stats);
+    result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "scenario,planner,queries,solved,failed,first_query_us,mean_us,median_us,p95_us,max_us,"
+           "mean_nodes_expanded,mean_optimality_gap,max_optimality_gap,peak_rss_kb\n";
+    for (const BenchmarkResult& r : results) {
+        out << r.scenario << ',' << HeadlessRunner::plannerName(r.planner) << ','
+            << r.queries << ',' << r.solved << ',' << r.failed << ','
+            << r.firstQueryUs << ',' << r.meanUs << ',' << r.medianUs << ',' << r.p95Us << ',' << r.maxUs << ','
+            << r.meanNodes << ',' << r.meanGap << ',' << r.maxGap << ',' << r.peakRssKb << '\n';
+    }
+}
+
+void writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        // 场景路径里只可能出现反斜杠需要转义（Windows路径）
+        std::string scenario;
+        for (char c : r.scenario) {
+            if (c == '\\' || c == '"') {
+                scenario += '\\';
+            }
+            scenario += c;
+        }
+        out << "  {\"scenario\": \"" << scenario << "\", \"planner\": \"" << HeadlessRunner::plannerName(r.planner)
+            << "\", \"queries\": " << r.queries << ", \"solved\": " << r.solved << ", \"failed\": " << r.failed
+            << ", \"first_query_us\": " << r.firstQueryUs << ", \"mean_us\": " << r.meanUs
+            << ", \"median_us\": " << r.medianUs << ", \"p95_us\": " << r.p95Us << ", \"max_us\": " << r.maxUs
+            << ", \"mean_nodes_expanded\": " << r.meanNodes << ", \"mean_optimality_gap\": " << r.meanGap
+            << ", \"max_optimality_gap\": " << r.maxGap << ", \"peak_rss_kb\": " << r.peakRssKb << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+void writeMapfCsv(std::ostream& out, const std::vector<MapfResult>& results) {
+    out << "scenario,agents,suboptimality,solved,time_ms,sum_of_costs,lower_bound,"
+           "high_level_expanded,low_level_expanded,makespan,peak_rss_kb\n";
+    for (const MapfResult& r : results) {
+        out << r.scenario << ',' << r.agents << ',' << r.suboptimality << ',' << (r.solved ? 1 : 0) << ','
+            << r.timeMs << ',' << r.stats.sumOfCosts << ',' << r.stats.lowerBound << ','
+            << r.stats.highLevelExpanded << ',' << r.stats.lowLevelExpanded << ',' << r.stats.makespan << ','
+            << r.peakRssKb << '\n';
+    }
+}
+
+void writeMapfJson(std::ostream& out, const std::vector<MapfResult>& results) {
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const MapfResult& r = results[i];
+        std::string scenario;
+        for (char c : r.scenario) {
+            if (c == '\\' || c == '"') {
+                scenario += '\\';
+            }
+            scenario += c;
+        }
+        out << "  {\"scenario\": \"" << scenario << "\", \"agents\": " << r.agents
+            << ", \"suboptimality\": " << r.suboptimality << ", \"solved\": " << (r.solved ? "true" : "false")
+            << ", \"time_ms\": " << r.timeMs << ", \"sum_of_costs\": " << r.stats.sumOfCosts
+            << ", \"lower_bound\": " << r.stats.lowerBound << ", \"high_level_expanded\": " << r.stats.highLevelExpanded
+            << ", \"low_level_expanded\": " << r.stats.lowLevelExpanded << ", \"makespan\": " << r.stats.makespan
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<PlannerType> planners;
+    std::string mapDir;
+    std::string format = "csv";
+    std::string outputFile;
+    size_t maxQueries = 0;
+    size_t agentCount = 0;
+    double suboptimality = 1.0;
+    std::vector<std::string> scenarioFiles;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--planner" && hasValue) {
+            PlannerType type;
+            if (!HeadlessRunner::parsePlannerType(argv[++i], type)) {
+                std::cerr << "Unknown planner: " << argv[i] << std::endl;
+                return 1;
+            }
+            planners.push_back(type);
+        } else if (arg == "--map-dir" && hasValue) {
+            mapDir = argv[++i];
+        } else if (arg == "--max-queries" && hasValue) {
+            maxQueries = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--format" && hasValue) {
+            format = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg == "--agents" && hasValue) {
+            agentCount = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--suboptimality" && hasValue) {
+            suboptimality = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            collectScenarioFiles(arg, scenarioFiles);
+        }
+    }
+
+    if (scenarioFiles.empty() || (format != "csv" && format != "json") || !(suboptimality >= 1.0)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (planners.empty()) {
+        planners = {PlannerType::ASTAR, PlannerType::JPS, PlannerType::JPS_PLUS,
+                    PlannerType::DSTAR_LITE, PlannerType::HPA_STAR};
+    }
+
+    // 基准程序没有帧循环，关闭性能面板的计时
+    Profiler::shared().setEnabled(false);
+
+    std::vector<BenchmarkResult> results;
+    std::vector<MapfResult> mapfResults;
+    // 只保留最近一张地图：连续的场景文件使用同一地图时不重复加载，
+    // 父进程的内存也不随已处理的地图数增长（它会计入每个子进程的峰值内存）
+    std::string mapFile;
+    BenchmarkMap map;
+    bool allLoaded = true;
+
+    for (const std::string& scenarioFile : scenarioFiles) {
+        std::vector<BenchmarkQuery> queries;
+        if (!loadBenchmarkScenario(scenarioFile, queries) || queries.empty()) {
+            std::cerr << "Cannot load scenario: " << scenarioFile << std::endl;
+            allLoaded = false;
+            continue;
+        }
+        if (maxQueries > 0 && queries.size() > maxQueries) {
+            queries.resize(maxQueries);
+        }
+
+        const std::string nextMapFile = resolveMapFile(scenarioFile, queries.front().mapName, mapDir);
+        if (nextMapFile.empty() || nextMapFile != mapFile) {
+            mapFile.clear();
+            map = BenchmarkMap{};
+            if (nextMapFile.empty() || !loadBenchmarkMap(nextMapFile, map)) {
+                std::cerr << "Cannot load map " << queries.front().mapName << " for " << scenarioFile << std::endl;
+                allLoaded = false;
+                continue;
+            }
+            mapFile = nextMapFile;
+        }
+
+        if (agentCount > 0) {
+            MapfResult result;
+            result.scenario = scenarioFile;
+            result.suboptimality = suboptimality;
+            if (!runIsolated<MapfMetrics>(result, [&](MapfMetrics& metrics) {
+                    metrics = runMultiAgent(map, queries, agentCount, suboptimality);
+                })) {
+                std::cerr << "Benchmark process failed: " << scenarioFile << std::endl;
+                allLoaded = false;
+                continue;
+            }
+            mapfResults.push_back(result);
+            std::cerr << scenarioFile << " [" << result.agents << " agents, w=" << suboptimality << "] "
+                      << (result.solved ? "solved" : "failed") << " in " << result.timeMs << " ms" << std::endl;
+            continue;
+        }
+
+        // 最优性差距的基准在单独的子进程中算一次，供所有算法的子进程共用
+        std::vector<double> referenceCosts(queries.size(), -1.0);
+        if (!runIsolated<double>(referenceCosts.data(), referenceCosts.size(), [&](double* costs) {
+                computeReferenceCosts(map, queries, costs);
+            })) {
+            std::cerr << "Benchmark process failed: " << scenarioFile << " [reference]" << std::endl;
+            allLoaded = false;
+            continue;
+        }
+
+        for (PlannerType planner : planners) {
+            BenchmarkResult result;
+            result.scenario = scenarioFile;
+            result.planner = planner;
+            if (!runIsolated<PlannerMetrics>(result, [&](PlannerMetrics& metrics) {
+                    metrics = runPlanner(map, queries, planner, referenceCosts);
+                })) {
+                std::cerr << "Benchmark process failed: " << scenarioFile << " ["
+                          << HeadlessRunner::plannerName(planner) << "]" << std::endl;
+                allLoaded = false;
+                continue;
+            }
+            results.push_back(result);
+            std::cerr << scenarioFile << " [" << HeadlessRunner::plannerName(planner) << "] "
+                      << result.meanUs << " us/query" << std::endl;
+        }
+    }
+
+    std::ofstream file;
+    if (!outputFile.empty()) {
+        file.open(outputFile);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open output file: " << outputFile << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputFile.empty() ? std::cout : file;
+    if (agentCount > 0) {
+        if (format == "json") {
+            writeMapfJson(out, mapfResults);
+        } else {
+            writeMapfCsv(out, mapfResults);
+        }
+    } else if (format == "json") {
+        writeJson(out, results);
+    } else {
+        writeCsv(out, results);
+    }
+    return allLoaded ? 0 : 2;
+}
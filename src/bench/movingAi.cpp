@@ -0,0 +1,81 @@
+#include "bench/movingAi.h"
+#include "maze/maze.h"
+#include <fstream>
+#include <sstream>
+
+namespace PathGlyph {
+
+bool loadBenchmarkMap(const std::string& filename, BenchmarkMap& map) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 文件头：键值对，直到"map"一行
+    std::string key;
+    map.width = 0;
+    map.height = 0;
+    while (file >> key && key != "map") {
+        if (key == "height") {
+            file >> map.height;
+        } else if (key == "width") {
+            file >> map.width;
+        } else {
+            std::string value;
+            file >> value;  // type octile
+        }
+    }
+    if (key != "map" || map.width <= 0 || map.height <= 0) {
+        return false;
+    }
+
+    map.blocked.assign(static_cast<size_t>(map.width) * map.height, 0);
+    std::string row;
+    for (int y = 0; y < map.height; ++y) {
+        if (!(file >> row) || static_cast<int>(row.size()) < map.width) {
+            return false;
+        }
+        for (int x = 0; x < map.width; ++x) {
+            char c = row[x];
+            bool passable = c == '.' || c == 'G' || c == 'S';
+            map.blocked[static_cast<size_t>(y) * map.width + x] = passable ? 0 : 1;
+        }
+    }
+    return true;
+}
+
+bool loadBenchmarkScenario(const std::string& filename, std::vector<BenchmarkQuery>& queries) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    queries.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line.rfind("version", 0) == 0) {
+            continue;
+        }
+        std::istringstream fields(line);
+        BenchmarkQuery query;
+        int mapWidth = 0;
+        int mapHeight = 0;
+        if (fields >> query.bucket >> query.mapName >> mapWidth >> mapHeight
+                   >> query.startX >> query.startY >> query.goalX >> query.goalY >> query.optimalLength) {
+            queries.push_back(query);
+        }
+    }
+    return true;
+}
+
+void populateMaze(const BenchmarkMap& map, Maze& maze) {
+    for (int y = 0; y < map.height; ++y) {
+        for (int x = 0; x < map.width; ++x) {
+            if (map.isBlocked(x, y)) {
+                maze.addStaticObstacle(Point(x, y));
+            }
+        }
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace PathGlyph {
+
+class Maze;
+
+// MovingAI基准地图（.map）
+// 格式：type octile / height H / width W / map，之后H行字符；
+// '.'、'G'、'S'可通行，'@'、'O'、'T'、'W'为障碍物。
+struct BenchmarkMap {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> blocked;  // 行优先，1为障碍物
+
+    bool isBlocked(int x, int y) const { return blocked[static_cast<size_t>(y) * width + x] != 0; }
+};
+
+// MovingAI场景文件（.scen）中的一条查询
+// 每行：bucket map width height startX startY goalX goalY optimalLength
+struct BenchmarkQuery {
+    int bucket = 0;
+    std::string mapName;        // 场景文件中记录的地图路径
+    int startX = 0;
+    int startY = 0;
+    int goalX = 0;
+    int goalY = 0;
+    double optimalLength = 0.0; // 参考最优长度（对角代价√2且不允许切角）
+};
+
+bool loadBenchmarkMap(const std::string& filename, BenchmarkMap& map);
+bool loadBenchmarkScenario(const std::string& filename, std::vector<BenchmarkQuery>& queries);
+
+// 用地图的障碍物填充一个同尺寸的空迷宫
+void populateMaze(const BenchmarkMap& map, Maze& maze);
+
+} // namespace PathGlyph
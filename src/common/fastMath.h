@@ -0,0 +1,62 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace PathGlyph {
+
+// 可向量化的初等函数近似 - 用在对结构数组跑的无分支循环里，代替std::sin/std::cos/std::exp。
+// 条件都写成给局部变量赋常量的形式，GCC能把它们转换成掩码选择；写成条件表达式时可能保留分支而无法向量化
+
+namespace FastMath {
+
+constexpr float PI = 3.14159265358979f;
+constexpr float HALF_PI = 1.57079632679490f;
+constexpr float TWO_PI = 6.28318530717959f;
+constexpr float INV_TWO_PI = 0.159154943091895f;
+constexpr float LOG2E = 1.44269504088896f;
+constexpr float LN2 = 0.693147180559945f;
+
+} // namespace FastMath
+
+// 四舍五入到整数（远离零），用截断转换实现
+inline float roundToInt(float value) {
+    float half = 0.5f;
+    if (value < 0.0f) half = -0.5f;
+    return static_cast<float>(static_cast<int>(value + half));
+}
+
+// 把角度归到[-π, π]：减去最近的2π整数倍
+inline float wrapPi(float angle) {
+    return angle - roundToInt(angle * FastMath::INV_TWO_PI) * FastMath::TWO_PI;
+}
+
+// angle ∈ [-π, π]，先折叠到[-π/2, π/2]再用泰勒多项式，误差约1e-7
+inline float sinPoly(float angle) {
+    // sin(x) = sin(π - x)：x > π/2时π - x更小，x < -π/2时-π - x更大，用min/max完成折叠
+    float x = std::max(std::min(angle, FastMath::PI - angle), -FastMath::PI - angle);
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f +
+           x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+}
+
+// 无分支的正余弦
+inline void fastSinCos(float angle, float& sine, float& cosine) {
+    angle = wrapPi(angle);
+    sine = sinPoly(angle);
+    cosine = sinPoly(wrapPi(angle + FastMath::HALF_PI));
+}
+
+// e^x，x限制在[-87, 88]（结果保持为规格化数），相对误差约2e-7。
+// x = (n + f) * ln2，|f| <= 0.5：2^n直接写入指数位，e^(f * ln2)用泰勒多项式
+inline float fastExp(float x) {
+    x = std::clamp(x, -87.0f, 88.0f);
+    const float n = roundToInt(x * FastMath::LOG2E);
+    const float r = x - n * FastMath::LN2;
+    const float poly = 1.0f + r * (1.0f + r * (1.0f / 2.0f + r * (1.0f / 6.0f + r * (1.0f / 24.0f +
+                       r * (1.0f / 120.0f + r * (1.0f / 720.0f + r * (1.0f / 5040.0f)))))));
+    const float scale = std::bit_cast<float>(static_cast<int32_t>(n + 127.0f) << 23);
+    return poly * scale;
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+namespace PathGlyph {
+
+// 只读内存映射文件
+// 文件内容按需由操作系统分页载入，打开本身不读取数据；映射在对象析构或close()时解除。
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射整个文件，失败（文件不存在、为空或映射失败）时返回false
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    // 映射起始地址按页对齐
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,86 @@
+#include "common/profiler.h"
+#include "common/tracer.h"
+#include <algorithm>
+
+namespace PathGlyph {
+
+ProfileZone& Profiler::findZone(std::string_view name, bool gpu) {
+    // 区域只有十几个，线性查找即可
+    for (ProfileZone& zone : zones_) {
+        if (zone.gpu == gpu && zone.name == name) {
+            return zone;
+        }
+    }
+    ProfileZone& zone = zones_.emplace_back();
+    zone.name = std::string(name);
+    zone.gpu = gpu;
+    return zone;
+}
+
+void Profiler::record(std::string_view name, double milliseconds, bool gpu) {
+    if (!isEnabled()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    findZone(name, gpu).pending += static_cast<float>(milliseconds);
+}
+
+void Profiler::endFrame() {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (isEnabled() && lastFrame_ != std::chrono::steady_clock::time_point{}) {
+        findZone("Frame", false).pending +=
+            std::chrono::duration<float, std::milli>(now - lastFrame_).count();
+    }
+    lastFrame_ = now;
+
+    for (ProfileZone& zone : zones_) {
+        zone.last = zone.pending;
+        zone.pending = 0.0f;
+        zone.history[zone.head] = zone.last;
+        zone.head = (zone.head + 1) % ProfileZone::HISTORY_SIZE;
+        zone.count = std::min(zone.count + 1, ProfileZone::HISTORY_SIZE);
+
+        float sum = 0.0f;
+        float peak = 0.0f;
+        for (size_t i = 0; i < zone.count; ++i) {
+            sum += zone.history[i];
+            peak = std::max(peak, zone.history[i]);
+        }
+        zone.average = sum / static_cast<float>(zone.count);
+        zone.peak = peak;
+    }
+}
+
+void Profiler::snapshot(std::vector<ProfileZone>& zones) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    zones = zones_;
+}
+
+Profiler& Profiler::shared() {
+    static Profiler profiler;
+    return profiler;
+}
+
+ProfileScope::ProfileScope(const char* name)
+    : name_(name), active_(Profiler::shared().isEnabled()), tracing_(Tracer::shared().isEnabled()) {
+    if (active_ || tracing_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+ProfileScope::~ProfileScope() {
+    if (!active_ && !tracing_) {
+        return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (active_) {
+        Profiler::shared().record(name_, std::chrono::duration<double, std::milli>(end - start_).count());
+    }
+    if (tracing_) {
+        Tracer::shared().record(name_, start_, end);
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace PathGlyph {
+
+// 一个计时区域的滚动历史（毫秒）
+struct ProfileZone {
+    static constexpr size_t HISTORY_SIZE = 240;  // 约4秒（60帧/秒）
+
+    std::string name;
+    bool gpu = false;                      // GPU计时（来自GL_TIME_ELAPSED查询）
+    std::array<float, HISTORY_SIZE> history{};
+    size_t head = 0;                       // 下一帧写入的位置，也是最旧样本的位置
+    size_t count = 0;                      // 已写入的样本数（不超过HISTORY_SIZE）
+    float last = 0.0f;                     // 最近一帧的值
+    float average = 0.0f;                  // 历史平均值
+    float peak = 0.0f;                     // 历史最大值
+    float pending = 0.0f;                  // 本帧累计，endFrame时写入历史
+};
+
+// 帧性能分析器 - 按帧累计各区域的耗时并保留滚动历史
+// 同一名称在一帧内多次记录时累加。record可以在任意线程调用；
+// endFrame由主循环每帧调用一次，同时记录整帧耗时（区域"Frame"）。
+// 禁用时ProfileScope不读时钟，开销只剩一次原子读取，因此发布版本也可以常开。
+class Profiler {
+public:
+    Profiler() = default;
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // 记录一次耗时（毫秒）
+    void record(std::string_view name, double milliseconds, bool gpu = false);
+
+    // 结束当前帧：把各区域本帧累计写入历史，没有记录的区域写入0
+    void endFrame();
+
+    // 复制所有区域的当前状态，供UI在锁外绘制
+    void snapshot(std::vector<ProfileZone>& zones) const;
+
+    // 进程内共享的分析器
+    static Profiler& shared();
+
+private:
+    ProfileZone& findZone(std::string_view name, bool gpu);
+
+    mutable std::mutex mutex_;
+    std::vector<ProfileZone> zones_;
+    std::atomic<bool> enabled_{true};
+    std::chrono::steady_clock::time_point lastFrame_{};
+};
+
+// CPU计时区域：构造时开始，析构时把耗时记录到Profiler::shared()，
+// 追踪开启时同时作为一个事件写入Tracer::shared()的时间线
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    bool active_;
+    bool tracing_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,114 @@
+#include "common/threadPool.h"
+#include "common/tracer.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace PathGlyph {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    Tracer::setThreadName("worker " + std::to_string(index));
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            // 停止时先把队列里剩下的任务做完
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1) {
+        body(0, count);
+        return;
+    }
+
+    // 块按原子计数器动态领取，耗时不均的查询也能均衡到各个线程。
+    // 调用线程只等待块完成，不等待帮手任务开始：池内的任务再调用时，帮手可能排在自己后面，
+    // 此时由调用线程领完所有块；晚到的帮手领不到块就直接返回，因此共享状态放在堆上
+    struct State {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> finishedChunks{0};
+        size_t chunkCount = 0;
+        size_t count = 0;
+        size_t grain = 0;
+        const std::function<void(size_t, size_t)>* body = nullptr;
+    };
+    auto state = std::make_shared<State>();
+    state->chunkCount = chunkCount;
+    state->count = count;
+    state->grain = grain;
+    state->body = &body;
+    auto runChunks = [](State& shared) {
+        size_t chunk;
+        while ((chunk = shared.nextChunk.fetch_add(1, std::memory_order_relaxed)) < shared.chunkCount) {
+            const size_t begin = chunk * shared.grain;
+            (*shared.body)(begin, std::min(begin + shared.grain, shared.count));
+            // 领到块的线程完成之前调用线程不会返回，body在此之前一直有效
+            if (shared.finishedChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == shared.chunkCount) {
+                shared.finishedChunks.notify_all();
+            }
+        }
+    };
+
+    // 调用线程也领取块，因此只需要chunkCount - 1个帮手
+    const size_t helperCount = std::min(workers_.size(), chunkCount - 1);
+    for (size_t i = 0; i < helperCount; ++i) {
+        submit([state, runChunks]() { runChunks(*state); });
+    }
+    runChunks(*state);
+    size_t finished = state->finishedChunks.load(std::memory_order_acquire);
+    while (finished < chunkCount) {
+        state->finishedChunks.wait(finished, std::memory_order_acquire);
+        finished = state->finishedChunks.load(std::memory_order_acquire);
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace PathGlyph
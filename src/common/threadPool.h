@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+namespace PathGlyph {
+
+// 固定大小的工作线程池
+// 任务按提交顺序执行。parallelFor把区间切成块，由工作线程和调用线程一起领取，
+// 所有块完成后才返回。在本池的任务里（例如异步规划作业中）调用parallelFor时，当前线程同样领取块，
+// 空闲的工作线程一起帮忙；没有空闲线程时由当前线程做完所有块，不会互相等待。
+class ThreadPool {
+public:
+    // threadCount为0时使用硬件线程数
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadCount() const { return workers_.size(); }
+
+    // 提交一个任务，由某个空闲的工作线程执行
+    void submit(std::function<void()> task);
+
+    // 对[0, count)每grain个一块并行调用body(begin, end)
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    // 进程内共享的线程池，第一次使用时创建
+    static ThreadPool& shared();
+
+private:
+    void workerLoop(size_t index);
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+};
+
+} // namespace PathGlyph
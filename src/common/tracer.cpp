@@ -0,0 +1,129 @@
+#include "common/tracer.h"
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+
+namespace PathGlyph {
+
+namespace {
+
+// 当前线程在某个Tracer中注册的缓冲
+struct LocalBufferSlot {
+    const void* owner = nullptr;
+    void* buffer = nullptr;
+};
+
+thread_local LocalBufferSlot localSlot;
+thread_local std::string localThreadName;
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    if (localSlot.owner == this) {
+        return *static_cast<ThreadBuffer*>(localSlot.buffer);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->threadId = static_cast<uint32_t>(buffers_.size() + 1);
+    buffer->threadName = localThreadName.empty() ? "thread " + std::to_string(buffer->threadId) : localThreadName;
+    localSlot.owner = this;
+    localSlot.buffer = buffer.get();
+    buffers_.push_back(std::move(buffer));
+    return *buffers_.back();
+}
+
+void Tracer::record(const char* name, std::chrono::steady_clock::time_point begin,
+                    std::chrono::steady_clock::time_point end) {
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Event& event = buffer.events[index % TRACE_BUFFER_EVENTS];
+    // 序号先变为奇数，栅栏保证导出线程读到任何新字段时也能看到它
+    event.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.beginNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - epoch_).count(),
+                        std::memory_order_relaxed);
+    event.endNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - epoch_).count(),
+                      std::memory_order_relaxed);
+    event.sequence.store(2 * index + 2, std::memory_order_release);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    localThreadName = name;
+    // 已经注册过的线程同时更新缓冲里的名称
+    if (localSlot.owner != nullptr) {
+        const Tracer& tracer = *static_cast<const Tracer*>(localSlot.owner);
+        std::lock_guard<std::mutex> lock(tracer.registryMutex_);
+        static_cast<ThreadBuffer*>(localSlot.buffer)->threadName = name;
+    }
+}
+
+bool Tracer::writeChromeTrace(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    // Chrome trace的时间单位是微秒，保留到纳秒
+    out << std::fixed << std::setprecision(3);
+
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers_) {
+        // 线程名元数据，名称由线程自己通过setThreadName给出
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->threadId << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->threadName.c_str());
+        out << "}}";
+        first = false;
+
+        // 写线程可能同时在覆盖最旧的事件：读取前后的序号必须都等于该事件写完时的值，否则跳过
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t available = std::min<uint64_t>(written, TRACE_BUFFER_EVENTS);
+        for (uint64_t i = written - available; i < written; ++i) {
+            const Event& event = buffer->events[i % TRACE_BUFFER_EVENTS];
+            const uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * i + 2) {
+                continue;
+            }
+            const char* name = event.name.load(std::memory_order_relaxed);
+            const int64_t beginNs = event.beginNs.load(std::memory_order_relaxed);
+            const int64_t endNs = event.endNs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+            out << ",\n{\"name\":";
+            writeJsonString(out, name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << beginNs / 1000.0
+                << ",\"dur\":" << (endNs - beginNs) / 1000.0 << '}';
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+Tracer& Tracer::shared() {
+    static Tracer tracer;
+    return tracer;
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PathGlyph {
+
+// 时间线追踪 - 把计时区域记录为Chrome trace事件，可在chrome://tracing或Perfetto中打开
+// 每个线程第一次记录时注册自己的环形缓冲，之后写入不加锁：写线程是唯一的生产者，
+// 每个槽位带一个序号（seqlock），写入前后各改一次；导出可以和记录同时进行，
+// 读取前后序号不一致（正在改写或已被覆盖）的槽位直接跳过，字段本身也都是原子的。
+// 缓冲写满后覆盖最旧的事件，因此导出的总是每个线程最近TRACE_BUFFER_EVENTS个区域。
+// 默认关闭，关闭时记录只有一次原子读取的开销。
+class Tracer {
+public:
+    static constexpr size_t TRACE_BUFFER_EVENTS = 1 << 16;
+
+    Tracer() = default;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // 记录一个完整的区域（Chrome trace中的"X"事件），name需要在导出前保持有效（通常为字符串字面量）
+    void record(const char* name, std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end);
+
+    // 以Chrome trace JSON格式写出所有线程的事件，失败时返回false
+    bool writeChromeTrace(const std::string& filename) const;
+
+    // 设置当前线程在时间线中的名称；未命名的线程导出为"thread <tid>"
+    static void setThreadName(const std::string& name);
+
+    // 进程内共享的追踪器
+    static Tracer& shared();
+
+private:
+    struct Event {
+        std::atomic<uint64_t> sequence{0};  // 写第i个事件时为2i+1，写完为2i+2
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> beginNs{0};    // 相对于epoch_的纳秒
+        std::atomic<int64_t> endNs{0};
+    };
+
+    // 单个线程的环形缓冲，只由所属线程写入
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::string threadName;             // 由registryMutex_保护
+        std::unique_ptr<Event[]> events{new Event[TRACE_BUFFER_EVENTS]};
+        std::atomic<uint64_t> written{0};
+    };
+
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> enabled_{false};
+    std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+
+    mutable std::mutex registryMutex_;  // 只在注册新线程和导出时使用
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// 只写入时间线、不计入Profiler的区域，用于不需要在性能面板中显示的外层范围
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(name), active_(Tracer::shared().isEnabled()) {
+        if (active_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    ~TraceScope() {
+        if (active_) {
+            Tracer::shared().record(name_, start_, std::chrono::steady_clock::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace PathGlyph
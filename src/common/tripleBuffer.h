@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace PathGlyph {
+
+// 三重缓冲 - 一个写端、一个读端之间无锁地传递最新的一份数据
+// 写端在自己的缓冲里写好后publish，与中间缓冲交换；读端acquire时如果中间缓冲有新数据，
+// 就与自己的缓冲交换。交换都是对同一个原子下标的exchange，双方永远不会同时访问同一个缓冲，
+// 写端不等待读端，读端拿到的总是最近一次发布的完整数据，中间没被读到的版本直接丢弃。
+// 多个线程写入时需要由调用方串行化（例如都在同一把锁内publish）。
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 写端：当前可写的缓冲，内容是若干次发布之前的旧数据，需要整体覆盖
+    T& writeBuffer() { return buffers_[writeIndex_]; }
+    // 写端：发布writeBuffer的内容
+    void publish() {
+        writeIndex_ = middle_.exchange(writeIndex_ | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // 读端：有新发布的数据时换入，返回最新的缓冲，在下一次acquire前保持不变
+    const T& acquire() {
+        if (middle_.load(std::memory_order_relaxed) & FRESH) {
+            readIndex_ = middle_.exchange(readIndex_, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers_[readIndex_];
+    }
+    // 读端：上一次acquire得到的缓冲
+    const T& readBuffer() const { return buffers_[readIndex_]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH = 4;  // 中间缓冲是否有读端还没取走的数据
+
+    std::array<T, 3> buffers_{};
+    std::atomic<uint8_t> middle_{1};
+    uint8_t writeIndex_ = 0;  // 只由写端访问
+    uint8_t readIndex_ = 2;   // 只由读端访问
+};
+
+} // namespace PathGlyph
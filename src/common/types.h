@@ -85,9 +85,20 @@ enum class EditObjectType {
 
 // 仿真状态枚举
 enum class SimulationState {
-    IDLE,     // 空闲状态
-    RUNNING,  // 运行状态
-    FINISHED  // 完成状态
+    IDLE,      // 空闲状态
+    PLANNING,  // 等待异步全局规划，仿真暂停
+    RUNNING,   // 运行状态
+    FINISHED   // 完成状态
+};
+
+// 全局路径规划算法
+enum class PlannerType {
+    ASTAR,       // A*
+    JPS,         // 跳点搜索
+    JPS_PLUS,    // 预计算跳跃距离的跳点搜索（JPS+）
+    DSTAR_LITE,  // 增量重规划（D* Lite）
+    HPA_STAR,    // 分层A*（HPA*）
+    FLOW_FIELD   // 以目标为根的流场，多个代理共用一个目标时只搜索一次
 };
 
 // 编辑模式枚举
@@ -104,6 +115,7 @@ struct EditState {
     bool showWireframe = false;  // 线框模式
     bool showPath = true;        // 显示路径
     bool showObstacles = true;   // 显示障碍物
+    bool showClearance = false;  // 在地面上显示到静态障碍物的距离热力图
     bool shouldStartSimulation = false; // 是否应该开始模拟
     bool shouldResetState = false;
     
@@ -120,6 +132,15 @@ struct EditState {
     int motionType = 0;          // 0: 直线, 1: 圆周
 };
 
+// 一个仿真步结束时渲染需要的状态，渲染在最近两步之间插值
+struct SimulationFrame {
+    Point agentPosition;
+    std::vector<glm::vec2> dynamicObstacles;  // 下标对应Maze::getDynamicObstacles()
+    std::vector<glm::vec2> agents;            // 群体代理，下标对应Simulation::getAgents()
+    std::vector<Point> path;                  // 规划路径，只在修订号变化时复制
+    uint64_t pathRevision = ~0ull;            // 对应Maze::getPathRevision()
+};
+
 // 渲染参数结构体 - 用于配置单一着色器的不同效果
 struct RenderParams {
   glm::vec4 baseColor{1.0f};     // 基础颜色
@@ -0,0 +1,207 @@
+#include "core/agentSet.h"
+#include "maze/occupancyGrid.h"
+#include "common/threadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr size_t AGENT_GRAIN = 512;
+
+uint64_t goalKey(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(x);
+}
+
+} // namespace
+
+size_t AgentSet::add(const glm::vec2& position, int goalX, int goalY, float speed) {
+    const uint64_t key = goalKey(goalX, goalY);
+    auto found = routeIndex_.find(key);
+    if (found == routeIndex_.end()) {
+        auto route = std::make_unique<Route>();
+        route->goalX = goalX;
+        route->goalY = goalY;
+        found = routeIndex_.emplace(key, static_cast<int32_t>(routes_.size())).first;
+        routes_.push_back(std::move(route));
+    }
+
+    x_.push_back(position.x);
+    y_.push_back(position.y);
+    initialX_.push_back(position.x);
+    initialY_.push_back(position.y);
+    velocityX_.push_back(0.0f);
+    velocityY_.push_back(0.0f);
+    speed_.push_back(speed);
+    route_.push_back(found->second);
+    cursor_.push_back(-1);
+    status_.push_back(static_cast<uint8_t>(AgentStatus::WAITING));
+    pendingActivation_ = true;
+    return x_.size() - 1;
+}
+
+void AgentSet::clear() {
+    x_.clear();
+    y_.clear();
+    initialX_.clear();
+    initialY_.clear();
+    velocityX_.clear();
+    velocityY_.clear();
+    speed_.clear();
+    route_.clear();
+    cursor_.clear();
+    status_.clear();
+    routes_.clear();
+    routeIndex_.clear();
+    pendingActivation_ = false;
+}
+
+void AgentSet::reserve(size_t count) {
+    x_.reserve(count);
+    y_.reserve(count);
+    initialX_.reserve(count);
+    initialY_.reserve(count);
+    velocityX_.reserve(count);
+    velocityY_.reserve(count);
+    speed_.reserve(count);
+    route_.reserve(count);
+    cursor_.reserve(count);
+    status_.reserve(count);
+}
+
+void AgentSet::reset() {
+    x_ = initialX_;
+    y_ = initialY_;
+    std::fill(velocityX_.begin(), velocityX_.end(), 0.0f);
+    std::fill(velocityY_.begin(), velocityY_.end(), 0.0f);
+    std::fill(cursor_.begin(), cursor_.end(), -1);
+    std::fill(status_.begin(), status_.end(), static_cast<uint8_t>(AgentStatus::WAITING));
+    pendingActivation_ = !x_.empty();
+}
+
+void AgentSet::updateRoutes(const OccupancyGrid& occupancy, uint64_t staticRevision, ThreadPool* pool) {
+    // 每条路线只在地图变化后重建一次，与使用它的代理数量无关
+    std::vector<uint8_t> rebuilt(routes_.size(), 0);
+    bool anyRebuilt = false;
+    for (size_t i = 0; i < routes_.size(); ++i) {
+        Route& route = *routes_[i];
+        if (route.revision == staticRevision) {
+            continue;
+        }
+        // 目标被占据或在地图外时流场无效，使用它的代理都是STUCK
+        route.field.build(occupancy, route.goalX, route.goalY, pool);
+        route.revision = staticRevision;
+        rebuilt[i] = 1;
+        anyRebuilt = true;
+    }
+    if (!anyRebuilt && !pendingActivation_) {
+        return;
+    }
+
+    // 路线重建后游标可能指向新放置的障碍物，未到达的代理从所在格重新出发
+    width_ = occupancy.getWidth();
+    for (size_t i = 0; i < x_.size(); ++i) {
+        const AgentStatus status = getStatus(i);
+        if (status == AgentStatus::WAITING || (rebuilt[route_[i]] && status != AgentStatus::ARRIVED)) {
+            activate(i);
+        }
+    }
+    pendingActivation_ = false;
+}
+
+void AgentSet::activate(size_t index) {
+    const FlowField& field = routes_[route_[index]]->field;
+    const int x = static_cast<int>(std::lround(x_[index]));
+    const int y = static_cast<int>(std::lround(y_[index]));
+    velocityX_[index] = 0.0f;
+    velocityY_[index] = 0.0f;
+    // getCost在地图外、占据格和不可达格都返回UNREACHABLE
+    if (!field.isBuilt() || field.getCost(x, y) == FlowField::UNREACHABLE) {
+        cursor_[index] = -1;
+        status_[index] = static_cast<uint8_t>(AgentStatus::STUCK);
+        return;
+    }
+    // 先走到所在格的中心，再沿流场前进
+    cursor_[index] = y * width_ + x;
+    status_[index] = static_cast<uint8_t>(AgentStatus::MOVING);
+}
+
+void AgentSet::update(float deltaTime, ThreadPool* pool) {
+    if (x_.empty()) {
+        return;
+    }
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.parallelFor(x_.size(), AGENT_GRAIN, [&](size_t begin, size_t end) {
+        advance(begin, end, deltaTime);
+    });
+}
+
+void AgentSet::advance(size_t begin, size_t end, float deltaTime) {
+    for (size_t i = begin; i < end; ++i) {
+        if (status_[i] != static_cast<uint8_t>(AgentStatus::MOVING)) {
+            continue;
+        }
+        const Route& route = *routes_[route_[i]];
+        float x = x_[i];
+        float y = y_[i];
+        float velocityX = 0.0f;
+        float velocityY = 0.0f;
+        // 本步可以走的距离，经过路点时剩余的距离继续走向下一个路点
+        float budget = speed_[i] * deltaTime;
+        while (true) {
+            const int cellX = cursor_[i] % width_;
+            const int cellY = cursor_[i] / width_;
+            const float dx = static_cast<float>(cellX) - x;
+            const float dy = static_cast<float>(cellY) - y;
+            const float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance > budget) {
+                velocityX = dx / distance * speed_[i];
+                velocityY = dy / distance * speed_[i];
+                x += dx / distance * budget;
+                y += dy / distance * budget;
+                break;
+            }
+            // 到达路点，按流场前进一格；没有方向时在目标格到达，否则路线已经断开
+            x = static_cast<float>(cellX);
+            y = static_cast<float>(cellY);
+            budget -= distance;
+            const int direction = route.field.getDirection(cellX, cellY);
+            if (direction < 0) {
+                const bool atGoal = cellX == route.goalX && cellY == route.goalY;
+                status_[i] = static_cast<uint8_t>(atGoal ? AgentStatus::ARRIVED : AgentStatus::STUCK);
+                cursor_[i] = -1;
+                break;
+            }
+            cursor_[i] = (cellY + GRID_DY[direction]) * width_ + cellX + GRID_DX[direction];
+        }
+        x_[i] = x;
+        y_[i] = y;
+        velocityX_[i] = velocityX;
+        velocityY_[i] = velocityY;
+    }
+}
+
+Point AgentSet::getGoal(size_t index) const {
+    const Route& route = *routes_[route_[index]];
+    return Point(route.goalX, route.goalY);
+}
+
+size_t AgentSet::getMovingCount() const {
+    return static_cast<size_t>(std::count(status_.begin(), status_.end(),
+                                          static_cast<uint8_t>(AgentStatus::MOVING)));
+}
+
+size_t AgentSet::getArrivedCount() const {
+    return static_cast<size_t>(std::count(status_.begin(), status_.end(),
+                                          static_cast<uint8_t>(AgentStatus::ARRIVED)));
+}
+
+void AgentSet::getPositions(std::vector<glm::vec2>& positions) const {
+    positions.resize(x_.size());
+    for (size_t i = 0; i < x_.size(); ++i) {
+        positions[i] = glm::vec2(x_[i], y_[i]);
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,95 @@
+#pragma once
+#include "planner/flowField.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace PathGlyph {
+
+class OccupancyGrid;
+class ThreadPool;
+
+enum class AgentStatus : uint8_t {
+    WAITING,   // 路线尚未构建，原地不动
+    MOVING,
+    ARRIVED,
+    STUCK      // 所在格被占据或到不了目标
+};
+
+// 群体代理集合 - 结构数组（SoA）存储
+// 每个代理的位置、速度、路径游标和目标分别存放在连续数组中。目标相同的代理共用一条路线：
+// 路线是以目标为根的流场，只搜索一次，代理的路径游标是它正走向的下一个格子，
+// 到达后按流场的方向前进一格，不需要各自保存路径。
+// update把代理分块交给线程池，每个代理只写自己的下标，块的划分不影响结果。
+// 下标在clear后失效，不要跨clear保存。
+class AgentSet {
+public:
+    static constexpr float DEFAULT_SPEED = 2.0f;  // 与主代理的速度相同
+
+    AgentSet() = default;
+
+    size_t size() const { return x_.size(); }
+    bool empty() const { return x_.empty(); }
+
+    // 在连续坐标position处添加一个走向格子(goalX, goalY)的代理，初始为WAITING，返回下标
+    size_t add(const glm::vec2& position, int goalX, int goalY, float speed = DEFAULT_SPEED);
+    // 移除所有代理和路线
+    void clear();
+    void reserve(size_t count);
+
+    // 回到初始位置并重新等待路线，路线本身保留
+    void reset();
+    // 构建还没有的路线，静态修订号变化时重建；路线变化后重新确定相关代理的游标
+    void updateRoutes(const OccupancyGrid& occupancy, uint64_t staticRevision, ThreadPool* pool = nullptr);
+    // 推进所有MOVING的代理，pool为空时使用共享线程池
+    void update(float deltaTime, ThreadPool* pool = nullptr);
+
+    glm::vec2 getPosition(size_t index) const { return glm::vec2(x_[index], y_[index]); }
+    glm::vec2 getVelocity(size_t index) const { return glm::vec2(velocityX_[index], velocityY_[index]); }
+    Point getGoal(size_t index) const;
+    AgentStatus getStatus(size_t index) const { return static_cast<AgentStatus>(status_[index]); }
+    size_t getMovingCount() const;
+    size_t getArrivedCount() const;
+    // 不同目标的数量，即实际构建的流场数量
+    size_t getRouteCount() const { return routes_.size(); }
+
+    // 批量导出当前位置，positions[i]对应下标i
+    void getPositions(std::vector<glm::vec2>& positions) const;
+
+private:
+    struct Route {
+        int goalX = 0;
+        int goalY = 0;
+        uint64_t revision = ~0ull;  // 构建流场时的静态修订号
+        FlowField field;
+    };
+
+    // 按当前位置所在格重新确定代理index的游标和状态
+    void activate(size_t index);
+    // 推进[begin, end)内的代理
+    void advance(size_t begin, size_t end, float deltaTime);
+
+    int width_ = 0;
+    bool pendingActivation_ = false;  // 有代理在等待路线
+
+    // 全部代理，按下标
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> initialX_;
+    std::vector<float> initialY_;
+    std::vector<float> velocityX_;
+    std::vector<float> velocityY_;
+    std::vector<float> speed_;
+    std::vector<int32_t> route_;   // routes_的下标
+    std::vector<int32_t> cursor_;  // 正走向的格子，按行展开的格子下标
+    std::vector<uint8_t> status_;  // AgentStatus
+
+    // 流场较大且需要原地重建，按指针存放
+    std::vector<std::unique_ptr<Route>> routes_;
+    std::unordered_map<uint64_t, int32_t> routeIndex_;  // 目标格 -> routes_的下标
+};
+
+} // namespace PathGlyph
@@ -1,4 +1,6 @@
 #include "core/application.h"
+#include "common/profiler.h"
+#include "common/tracer.h"
 #include <iostream>
 #include <imgui.h>
 #include <stdexcept>
@@ -28,7 +30,7 @@ Application::Application(int width, int height, const char* title)
     
     // 尝试从默认JSON文件加载迷宫配置
     const std::string MazeFile = "../../../../assets/mazes/default_maze.json";
-    if (!m_maze->loadFromJson(MazeFile)) {
+    if (!m_maze->loadFromFile(MazeFile)) {
         throw std::runtime_error("Failed to load mazefile from " + MazeFile);
     }
     
@@ -43,15 +45,24 @@ Application::Application(int width, int height, const char* title)
     
     // 创建渲染器
     m_renderer = std::make_unique<Renderer>(m_window, m_maze, m_editState);
+    m_renderer->setCrowd(&m_simulation->getAgents());
     
     // 设置回调
     setupCallbacks();
     
+    // 仿真在自己的线程中推进，主线程只读取它发布的快照
+    m_simulation->startThread();
+    
 
     std::cout << "Application initialized successfully." << std::endl;
 }
 
 Application::~Application() {
+    // 先停止仿真线程，它还在访问迷宫
+    if (m_simulation) {
+        m_simulation->stopThread();
+    }
+    
     // 清理GLFW
     if (m_window) {
         glfwDestroyWindow(m_window);
@@ -108,6 +119,18 @@ void Application::setupCallbacks() {
     glfwSetCursorPosCallback(m_window, cursorPosCallback);
     // 鼠标滚轮回调
     glfwSetScrollCallback(m_window, scrollCallback);
+    // 键盘回调
+    glfwSetKeyCallback(m_window, keyCallback);
+}
+
+// 键盘：F12写出当前的追踪时间线
+void Application::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    Application* app = getAppPtr(window);
+    if (!app) return;
+    
+    if (key == GLFW_KEY_F12 && action == GLFW_PRESS && !app->m_traceFile.empty()) {
+        app->writeTrace();
+    }
 }
 
 // 修改渲染窗口大小
@@ -243,6 +266,9 @@ void Application::handleMouseClick(double x, double y) {
     // 将屏幕坐标转换为网格坐标
     Point gridPos = screenToGrid(x, y);
     
+    // 编辑与仿真步互斥
+    auto simulationLock = m_simulation->lock();
+    
     // 检查坐标是否有效 - 使用网格坐标检查边界
     if (!m_maze->isInBounds(gridPos)) {
         std::cout << "invalid coordinate" << std::endl;
@@ -327,51 +353,99 @@ Application* Application::getAppPtr(GLFWwindow* window) {
 }
 
 void Application::run() {
-    // 时间相关变量
-    float lastTime = glfwGetTime();
-    
+    Tracer::setThreadName("main");
     // 主循环
     while (!glfwWindowShouldClose(m_window)) {
-        // 计算deltaTime
-        float currentTime = glfwGetTime();
-        float deltaTime = currentTime - lastTime;
-        lastTime = currentTime;
-        
-        // 轮询事件
-        glfwPollEvents();
+        TraceScope frameTrace("Frame");
         
-        // 处理ImGui输入
-        m_uiWindow->handleInput();
+        // 回收几帧前发出的GPU计时查询
+        GpuProfiler& gpuProfiler = m_renderer->getGpuProfiler();
+        gpuProfiler.beginFrame();
         
-        m_uiWindow->beginFrame(); // 开始ImGui帧
-        m_uiWindow->drawControlPanel(); // 绘制控制面板
+        {
+            ProfileScope zone("UI");
+            
+            // 轮询事件
+            glfwPollEvents();
+            
+            // 处理ImGui输入
+            m_uiWindow->handleInput();
+            
+            m_uiWindow->beginFrame(); // 开始ImGui帧
+            m_uiWindow->drawControlPanel(); // 绘制控制面板
+        }
         
         if (m_editState->shouldStartSimulation) {
             m_editState->shouldStartSimulation = false;
+            auto simulationLock = m_simulation->lock();
             m_simulation->start();
         }
         if (m_editState->shouldResetState) {
             m_editState->shouldResetState = false;
+            auto simulationLock = m_simulation->lock();
             m_simulation->reset();
         }    
         
-        // 标记几何体需要更新 - 确保动态障碍物和Agent的位置变化能被渲染出来
-        if (m_simulation->isRunning()) {
-            m_simulation->update(deltaTime);
-            m_renderer->markGeometryForUpdate();
+        // 仿真线程按固定步长推进，与帧率无关；渲染取最新的快照，在最近两步之间插值。
+        // 运行和规划中路径、动态障碍物和Agent只能从快照读取（规划中的路径是搜索到目前为止的部分路径）；
+        // 其他状态下仿真线程不访问迷宫，直接读取即可
+        const SimulationSnapshot& snapshot = m_simulation->acquireSnapshot();
+        if (snapshot.state == SimulationState::RUNNING || snapshot.state == SimulationState::PLANNING) {
+            snapshot.interpolate(snapshot.interpolationAlpha(std::chrono::steady_clock::now()), m_renderFrame);
+            m_renderer->setSimulationFrame(&m_renderFrame);
+        } else {
+            m_renderer->setSimulationFrame(nullptr);
+        }
+        // 到达终点后切回查看模式并显示走过的路径
+        if (snapshot.state == SimulationState::FINISHED && m_lastSimulationState == SimulationState::RUNNING) {
+            m_editState->showPath = true;
+            m_editState->mode = EditMode::VIEW;
         }
+        // 全局规划失败时仿真回到空闲，同样切回查看模式
+        if (snapshot.state == SimulationState::IDLE && m_lastSimulationState == SimulationState::PLANNING) {
+            m_editState->mode = EditMode::VIEW;
+        }
+        m_lastSimulationState = snapshot.state;
         
         // 清屏
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
-        // 让Renderer处理所有地图渲染
-        m_renderer->render();
+        // 让Renderer处理所有地图渲染（各阶段在Renderer内部分别计时）
+        {
+            ProfileScope zone("Render");
+            m_renderer->render();
+        }
+        
         // 结束ImGui帧
-        m_uiWindow->endFrame();
+        {
+            ProfileScope cpuZone("ImGui");
+            GpuProfileScope gpuZone(&gpuProfiler, "ImGui");
+            m_uiWindow->endFrame();
+        }
         
         // 交换缓冲区
         glfwSwapBuffers(m_window);
+        
+        Profiler::shared().endFrame();
+    }
+    
+    // 退出时写出追踪文件
+    if (!m_traceFile.empty()) {
+        writeTrace();
+    }
+}
+
+void Application::setTraceFile(const std::string& filename) {
+    m_traceFile = filename;
+    Tracer::shared().setEnabled(!filename.empty());
+}
+
+void Application::writeTrace() {
+    if (Tracer::shared().writeChromeTrace(m_traceFile)) {
+        std::cout << "Trace written to " << m_traceFile << std::endl;
+    } else {
+        std::cerr << "Failed to write trace to " << m_traceFile << std::endl;
     }
 }
 }
\ No newline at end of file
@@ -23,6 +23,9 @@ public:
     
     // 主循环
     void run();
+    
+    // 开启时间线追踪：退出时和按F12时把Chrome trace JSON写到filename
+    void setTraceFile(const std::string& filename);
 
 private:
     // ===== 核心组件 =====
@@ -31,6 +34,8 @@ private:
     std::shared_ptr<ImGuiWindow> m_uiWindow;   // UI窗口
     std::shared_ptr<EditState> m_editState;    // 编辑状态
     std::shared_ptr<Simulation> m_simulation;  // 仿真系统
+    SimulationFrame m_renderFrame;             // 本帧插值后的仿真状态
+    SimulationState m_lastSimulationState = SimulationState::IDLE;  // 上一帧快照中的状态
     
     // ===== 窗口相关 =====
     GLFWwindow* m_window = nullptr;
@@ -50,6 +55,10 @@ private:
     double m_currentMouseY = 0.0;  // 当前鼠标Y坐标
     double m_leftMouseDownTime = 0.0; // 左键按下的时间
     
+    // ===== 追踪 =====
+    std::string m_traceFile;  // 为空时不追踪
+    void writeTrace();
+    
     // ===== 初始化方法 =====
     bool initWindow();
     void setupCallbacks();
@@ -68,6 +77,7 @@ private:
     static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
     static void cursorPosCallback(GLFWwindow* window, double xpos, double ypos);
     static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
     
     // 辅助函数
     static Application* getAppPtr(GLFWwindow* window);
@@ -1,39 +1,77 @@
 #include "core/simulation.h"
+#include "common/profiler.h"
+#include "common/tracer.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <utility>
 
 namespace PathGlyph {
 
+namespace {
+
+// 部分路径的帧修订号带上最高位，不会与Maze::getPathRevision()重复
+constexpr uint64_t PARTIAL_PATH_REVISION = 1ull << 63;
+// 群体在随机格生成时每个代理最多尝试的次数，地图几乎占满时放弃剩余的代理
+constexpr int SPAWN_ATTEMPTS = 64;
+
+void interpolatePositions(const std::vector<glm::vec2>& before, const std::vector<glm::vec2>& after,
+                          float alpha, std::vector<glm::vec2>& out) {
+    if (before.size() != after.size()) {
+        // 两步之间增删过障碍物或重新生成过群体，下标不再一一对应
+        out = after;
+        return;
+    }
+    out.resize(after.size());
+    for (size_t i = 0; i < after.size(); ++i) {
+        out[i] = before[i] + (after[i] - before[i]) * alpha;
+    }
+}
+
+} // namespace
+
 Simulation::Simulation(std::shared_ptr<Maze> maze, std::shared_ptr<EditState> editState)
     : m_maze(maze), m_editState(editState) {
     // 初始化，但不再尝试从EditState同步simState
 }
 
+Simulation::~Simulation() {
+    stopThread();
+}
+
 void Simulation::start() {
     const Point& start = m_maze->getStart();
     const Point& goal = m_maze->getGoal();
     
     if (!m_maze->isInBounds(start) || !m_maze->isInBounds(goal)) {
-        std::cout << "Invalid start or goal point, cannot start simulation" << std::endl;
+        if (m_verbose) {
+            std::cout << "Invalid start or goal point, cannot start simulation" << std::endl;
+        }
         return;
     }
     
     // 重置仿真状态
     reset();
     
-    // 设置状态为运行
-    m_state = SimulationState::RUNNING;
+    // 先在后台规划全局路径，完成后进入运行状态
+    beginPlanning();
     // 设置为SIMULATION模式，这对于仿真功能是必要的cmft
     m_editState->mode = EditMode::SIMULATION;
+    publishSnapshot();
     
-    std::cout << "Simulation started: from (" << start.x << "," << start.y 
-              << ") to (" << goal.x << "," << goal.y << ")" << std::endl;
+    if (m_verbose) {
+        std::cout << "Simulation started: from (" << start.x << "," << start.y 
+                  << ") to (" << goal.x << "," << goal.y << ")" << std::endl;
+    }
 }
 
 void Simulation::reset() {
-    // 停止仿真
-    if (m_state == SimulationState::RUNNING) {
+    // 停止仿真，未完成的规划由Maze::reset取消
+    if (m_state == SimulationState::RUNNING || m_state == SimulationState::PLANNING) {
         m_state = SimulationState::FINISHED;
-        std::cout << "Simulation stopped" << std::endl;
+        if (m_verbose) {
+            std::cout << "Simulation stopped" << std::endl;
+        }
     }
     
     m_state = SimulationState::IDLE;
@@ -41,99 +79,321 @@ void Simulation::reset() {
     m_maze->clearPath();
     m_traversedPath.clear();
     m_maze->reset();
+    m_planJob.reset();
     m_agentVelocity = glm::vec2(0.0f, 0.0f);
+    m_agentArrived = false;
+    spawnCrowd();
+    
+    // 同一种子每次运行得到相同的随机序列
+    m_random.seed(getSeed());
+    m_accumulator = 0.0f;
+    captureFrame(m_currentFrame);
+    m_previousFrame = m_currentFrame;
     
     // 重置仿真状态
     m_state = SimulationState::IDLE;
     m_editState->mode = EditMode::VIEW;
+    publishSnapshot();
     
-    std::cout << "Simulation reset" << std::endl;
+    if (m_verbose) {
+        std::cout << "Simulation reset" << std::endl;
+    }
 }
 
 void Simulation::update(float deltaTime) {
+    if (isPlanning()) {
+        pollPlanning();
+    }
     if (!isRunning()) {
         return;
     }
+    ProfileScope zone("Simulation");
     
     // 更新仿真时间
     m_simulationTime += deltaTime;
     
     // 更新动态障碍物
     m_maze->update(deltaTime);
-    // 更新Agent位置
-    updateAgentPosition(deltaTime);
-    
-    // 如果到达终点，结束仿真
-    if (m_maze->hasReachedGoal()) {
-        m_state = SimulationState::FINISHED;
-        if (m_editState) {
-            m_editState->showPath = true;
-            m_editState->mode = EditMode::VIEW;
+    // 更新Agent位置，到达后停在终点等待群体
+    if (!m_agentArrived) {
+        updateAgentPosition(deltaTime);
+        if (isPlanning()) {
+            return;
         }
+    }
+    // 更新群体代理，路线在第一步或地图变化后构建
+    if (!m_agents.empty()) {
+        m_agents.updateRoutes(m_maze->getOccupancy(), m_maze->getStaticRevision());
+        m_agents.update(deltaTime);
+    }
+    
+    if (!m_agentArrived && m_maze->hasReachedGoal()) {
+        m_agentArrived = true;
         m_maze->setPath(m_traversedPath);
+    }
+    
+    // 主代理和群体都停下时结束仿真。update可能在仿真线程中执行，不在这里修改EditState，
+    // 界面在快照的状态变为FINISHED时切回查看模式
+    if (m_agentArrived && m_agents.getMovingCount() == 0) {
+        m_state = SimulationState::FINISHED;
         
-        std::cout << "Agent reached goal, simulation complete" << std::endl;
-        std::cout << "Total time: " << m_simulationTime << " seconds" << std::endl;
+        if (m_verbose) {
+            std::cout << "Agent reached goal, simulation complete" << std::endl;
+            if (!m_agents.empty()) {
+                std::cout << m_agents.getArrivedCount() << "/" << m_agents.size()
+                          << " crowd agents reached their goals" << std::endl;
+            }
+            std::cout << "Total time: " << m_simulationTime << " seconds" << std::endl;
+        }
     }
 }
 
-void Simulation::updateAgentPosition(float deltaTime) {
-    // 获取当前位置和目标位置
-    const Point& currentPos = m_maze->getCurrentPosition();
-    const Point& goal = m_maze->getGoal();
+int Simulation::advance(float frameTime) {
+    if (isPlanning()) {
+        // 规划期间仿真冻结，时间不累计，只发布搜索进度
+        if (pollPlanning()) {
+            m_accumulator = 0.0f;
+            if (capturePlanningFrame()) {
+                m_previousFrame.agentPosition = m_currentFrame.agentPosition;
+                m_previousFrame.dynamicObstacles = m_currentFrame.dynamicObstacles;
+                m_previousFrame.agents = m_currentFrame.agents;
+                publishSnapshot();
+            }
+            return 0;
+        }
+    }
+    if (!isRunning()) {
+        m_accumulator = 0.0f;
+        return 0;
+    }
     
-    // 只在开始时使用A*算法规划一次路径
-    if (m_maze->getPath().empty()) {
-        // 规划A*路径
-        std::vector<Point> path = m_maze->findPathAStar();
-        
-        // 检查是否找到了有效路径
-        if (path.empty()) {
-            std::cout << "A*算法无法找到有效路径！" << std::endl;
-            return;
+    const float step = getFixedTimeStep();
+    m_accumulator += std::clamp(frameTime, 0.0f, MAX_FRAME_TIME);
+    int steps = 0;
+    while (m_accumulator >= step && isRunning()) {
+        if (steps == MAX_STEPS_PER_FRAME) {
+            // 追不上时丢弃整步，只留下不足一步的余量用于插值
+            m_accumulator = std::fmod(m_accumulator, step);
+            break;
         }
-        
-        // 设置规划好的路径
-        m_maze->setPath(path);
-        std::cout << "使用A*算法规划了一条新路径，共" << path.size() << "个点" << std::endl;
+        std::swap(m_previousFrame, m_currentFrame);
+        update(step);
+        captureFrame(m_currentFrame);
+        m_accumulator -= step;
+        ++steps;
+    }
+    if (steps > 0) {
+        publishSnapshot();
+    }
+    return steps;
+}
+
+void Simulation::waitForPlan() {
+    while (isPlanning()) {
+        m_planJob->wait();
+        pollPlanning();
+    }
+}
+
+void Simulation::beginPlanning() {
+    m_planJob = m_maze->submitPlan(getPlannerType());
+    m_partialRevision = 0;
+    m_reportedNodes = 0;
+    m_state = SimulationState::PLANNING;
+}
+
+bool Simulation::pollPlanning() {
+    if (!m_planJob->isDone()) {
+        return true;
+    }
+    // 规划期间编辑过迷宫时作业会被取消或不再被采用，从当前位置重新规划
+    if (!m_maze->acceptPlan(*m_planJob)) {
+        beginPlanning();
+        return true;
     }
     
-    // 获取当前规划的路径
-    const std::vector<Point>& path = m_maze->getPath();
+    const bool found = m_planJob->getStatus() == PlanStatus::SUCCEEDED;
+    m_planJob.reset();
+    if (!found) {
+        m_state = SimulationState::IDLE;
+        if (m_verbose) {
+            std::cout << "全局规划无法找到有效路径！" << std::endl;
+        }
+    } else {
+        m_state = SimulationState::RUNNING;
+        if (m_verbose) {
+            std::cout << "规划了一条新路径，共" << m_maze->getPath().size() << "个点，扩展节点"
+                      << m_maze->getLastPlannerStats().nodesExpanded << "个" << std::endl;
+        }
+    }
     
-    // 如果路径为空，直接返回
-    if (path.empty()) {
+    // 用采用的路径替换部分路径，从当前状态开始插值
+    captureFrame(m_currentFrame);
+    m_previousFrame = m_currentFrame;
+    publishSnapshot();
+    return false;
+}
+
+bool Simulation::capturePlanningFrame() {
+    const PlanProgress& progress = m_planJob->getProgress();
+    bool changed = false;
+    if (progress.getPartialRevision() != m_partialRevision) {
+        m_partialRevision = progress.copyPartialPath(m_currentFrame.path);
+        m_currentFrame.pathRevision = PARTIAL_PATH_REVISION | ++m_partialFrames;
+        changed = true;
+    }
+    if (progress.getNodesExpanded() != m_reportedNodes) {
+        changed = true;
+    }
+    return changed;
+}
+
+void Simulation::setTickRate(float hz) {
+    m_tickRate.store(std::clamp(hz, MIN_TICK_RATE, MAX_TICK_RATE), std::memory_order_relaxed);
+}
+
+void Simulation::startThread() {
+    if (m_thread.joinable()) {
         return;
     }
+    m_stopThread = false;
+    m_thread = std::thread(&Simulation::threadMain, this);
+}
+
+void Simulation::stopThread() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopThread = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void Simulation::threadMain() {
+    Tracer::setThreadName("simulation");
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> guard(m_mutex);
+    Clock::time_point last = Clock::now();
+    while (!m_stopThread) {
+        const Clock::time_point now = Clock::now();
+        advance(std::chrono::duration<float>(now - last).count());
+        last = now;
+        
+        // 睡到下一步该执行的时刻，等待期间释放锁，主线程可以发命令和编辑迷宫。
+        // 空闲时同样按步长醒来检查状态
+        const float wait = std::max(getFixedTimeStep() - m_accumulator, 0.0f);
+        m_wake.wait_for(guard, std::chrono::duration<float>(wait), [this] { return m_stopThread; });
+    }
+}
+
+void Simulation::captureFrame(SimulationFrame& frame) const {
+    frame.agentPosition = m_maze->getCurrentPosition();
+    m_maze->getDynamicObstacles().getPositions(frame.dynamicObstacles);
+    m_agents.getPositions(frame.agents);
+    if (frame.pathRevision != m_maze->getPathRevision()) {
+        frame.path = m_maze->getPath();
+        frame.pathRevision = m_maze->getPathRevision();
+    }
+}
+
+void Simulation::publishSnapshot() {
+    SimulationSnapshot& snapshot = m_snapshots.writeBuffer();
+    snapshot.state = m_state;
+    snapshot.simulationTime = m_simulationTime;
+    snapshot.crowdArrived = m_agents.getArrivedCount();
+    snapshot.plannerStats = m_maze->getLastPlannerStats();
+    if (isPlanning()) {
+        m_reportedNodes = m_planJob->getProgress().getNodesExpanded();
+        snapshot.plannerStats = PlannerStats{};
+        snapshot.plannerStats.nodesExpanded = m_reportedNodes;
+    }
+    snapshot.previous.agentPosition = m_previousFrame.agentPosition;
+    snapshot.previous.dynamicObstacles = m_previousFrame.dynamicObstacles;
+    snapshot.previous.agents = m_previousFrame.agents;
+    // 缓冲复用，路径只在与该缓冲上次写入的修订号不同时复制
+    snapshot.current.agentPosition = m_currentFrame.agentPosition;
+    snapshot.current.dynamicObstacles = m_currentFrame.dynamicObstacles;
+    snapshot.current.agents = m_currentFrame.agents;
+    if (snapshot.current.pathRevision != m_currentFrame.pathRevision) {
+        snapshot.current.path = m_currentFrame.path;
+        snapshot.current.pathRevision = m_currentFrame.pathRevision;
+    }
+    snapshot.publishTime = std::chrono::steady_clock::now();
+    snapshot.timeStep = getFixedTimeStep();
+    m_snapshots.publish();
+}
+
+float SimulationSnapshot::interpolationAlpha(std::chrono::steady_clock::time_point now) const {
+    if (timeStep <= 0.0f) {
+        return 1.0f;
+    }
+    const float elapsed = std::chrono::duration<float>(now - publishTime).count();
+    return std::clamp(elapsed / timeStep, 0.0f, 1.0f);
+}
+
+void SimulationSnapshot::interpolate(float alpha, SimulationFrame& frame) const {
+    const Point& from = previous.agentPosition;
+    const Point& to = current.agentPosition;
+    frame.agentPosition = Point(from.x + (to.x - from.x) * alpha, from.y + (to.y - from.y) * alpha);
     
-    // 寻找当前位置对应的路径点索引
-    size_t currentIndex = 0;
-    float minDist = std::numeric_limits<float>::max();
-    
-    for (size_t i = 0; i < path.size(); ++i) {
-        float dist = currentPos.distanceTo(path[i]);
-        if (dist < minDist) {
-            minDist = dist;
-            currentIndex = i;
-        }
+    if (frame.pathRevision != current.pathRevision) {
+        frame.path = current.path;
+        frame.pathRevision = current.pathRevision;
     }
     
-    // 如果已经到达终点附近，直接移动到终点
-    if (currentIndex >= path.size() - 1 && minDist < 0.1f) {
-        m_maze->setCurrentPosition(goal);
-        m_agentVelocity = glm::vec2(0.0f, 0.0f);
+    interpolatePositions(previous.dynamicObstacles, current.dynamicObstacles, alpha, frame.dynamicObstacles);
+    interpolatePositions(previous.agents, current.agents, alpha, frame.agents);
+}
+
+void Simulation::updateAgentPosition(float deltaTime) {
+    // 获取当前位置和目标位置
+    const Point& currentPos = m_maze->getCurrentPosition();
+    const Point& goal = m_maze->getGoal();
+    
+    // 路径被清空时（例如编辑了迷宫）从当前位置重新规划，规划完成前仿真暂停
+    if (m_maze->getPath().empty()) {
+        beginPlanning();
         return;
     }
     
-    // 确定下一个目标点
-    size_t nextIndex = currentIndex + 1;
-    if (nextIndex >= path.size()) {
-        nextIndex = path.size() - 1;
+    // 流场规划时按所在格查表得到下一格，不在路径上搜索最近点
+    Point nextPoint;
+    if (!nextFlowFieldPoint(currentPos, nextPoint)) {
+        // 获取当前规划的路径
+        const std::vector<Point>& path = m_maze->getPath();
+        
+        // 寻找当前位置对应的路径点索引
+        size_t currentIndex = 0;
+        float minDist = std::numeric_limits<float>::max();
+        
+        for (size_t i = 0; i < path.size(); ++i) {
+            float dist = currentPos.distanceTo(path[i]);
+            if (dist < minDist) {
+                minDist = dist;
+                currentIndex = i;
+            }
+        }
+        
+        // 如果已经到达终点附近，直接移动到终点
+        if (currentIndex >= path.size() - 1 && minDist < 0.1f) {
+            m_maze->setCurrentPosition(goal);
+            m_agentVelocity = glm::vec2(0.0f, 0.0f);
+            return;
+        }
+        
+        // 确定下一个目标点
+        size_t nextIndex = currentIndex + 1;
+        if (nextIndex >= path.size()) {
+            nextIndex = path.size() - 1;
+        }
+        
+        // 向下一个点移动
+        nextPoint = path[nextIndex];
     }
     
-    // 向下一个点移动
-    const Point& nextPoint = path[nextIndex];
-    
     // 计算方向向量
     glm::vec2 direction(nextPoint.x - currentPos.x, nextPoint.y - currentPos.y);
     float distance = glm::length(direction);
@@ -171,4 +431,53 @@ void Simulation::updateAgentPosition(float deltaTime) {
     }
 }
 
-} // namespace PathGlyph
\ No newline at end of file
+void Simulation::spawnCrowd() {
+    const CrowdSpawn spawn{getCrowdSize(), getSeed(), m_maze->getGoal().toInt(), m_maze->getStaticRevision()};
+    if (spawn == m_crowdSpawn) {
+        m_agents.reset();
+        return;
+    }
+    m_crowdSpawn = spawn;
+    m_agents.clear();
+    if (spawn.count == 0 || m_maze->getWidth() <= 0 || m_maze->getHeight() <= 0) {
+        return;
+    }
+    
+    // 独立于m_random的生成器，群体只取决于种子，不影响主代理的随机序列
+    std::mt19937 random(spawn.seed);
+    std::uniform_int_distribution<int> pickX(0, m_maze->getWidth() - 1);
+    std::uniform_int_distribution<int> pickY(0, m_maze->getHeight() - 1);
+    const int goalX = static_cast<int>(spawn.goal.x);
+    const int goalY = static_cast<int>(spawn.goal.y);
+    m_agents.reserve(spawn.count);
+    for (size_t i = 0; i < spawn.count; ++i) {
+        for (int attempt = 0; attempt < SPAWN_ATTEMPTS; ++attempt) {
+            const int x = pickX(random);
+            const int y = pickY(random);
+            if (m_maze->isWalkable(x, y)) {
+                m_agents.add(glm::vec2(static_cast<float>(x), static_cast<float>(y)), goalX, goalY);
+                break;
+            }
+        }
+    }
+}
+
+bool Simulation::nextFlowFieldPoint(const Point& currentPos, Point& nextPoint) const {
+    if (getPlannerType() != PlannerType::FLOW_FIELD || !m_maze->isFlowFieldCurrent()) {
+        return false;
+    }
+    const Point cell = currentPos.toInt();
+    const int direction = m_maze->getFlowField().getDirection(static_cast<int>(cell.x), static_cast<int>(cell.y));
+    if (direction >= 0) {
+        nextPoint = Point(cell.x + GRID_DX[direction], cell.y + GRID_DY[direction]);
+        return true;
+    }
+    // 已在目标格时直接走向目标；所在格不可达时退回按路径前进
+    if (m_maze->isEndPoint(cell)) {
+        nextPoint = m_maze->getGoal();
+        return true;
+    }
+    return false;
+}
+
+} // namespace PathGlyph
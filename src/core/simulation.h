@@ -1,24 +1,96 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <vector>
 #include "common/types.h"
+#include "common/tripleBuffer.h"
+#include "core/agentSet.h"
 #include "maze/maze.h"
 
 namespace PathGlyph {
 
+// 仿真发布给渲染和UI的快照，发布后不再修改
+struct SimulationSnapshot {
+    SimulationState state = SimulationState::IDLE;
+    float simulationTime = 0.0f;
+    PlannerStats plannerStats;  // PLANNING状态下nodesExpanded为当前的搜索进度
+    size_t crowdArrived = 0;    // 已到达目标的群体代理数，总数为current.agents.size()
+    SimulationFrame previous;  // 上一步结束时的状态（不含路径）
+    SimulationFrame current;   // 最近一步结束时的状态
+    std::chrono::steady_clock::time_point publishTime;
+    float timeStep = 0.0f;
+    
+    // 发布后经过的时间占一个步长的比例，限制在[0, 1]
+    float interpolationAlpha(std::chrono::steady_clock::time_point now) const;
+    // 在previous和current之间插值写入frame，路径只在修订号变化时复制
+    void interpolate(float alpha, SimulationFrame& frame) const;
+};
+
 class Simulation {
 public:
     Simulation(std::shared_ptr<Maze> maze, std::shared_ptr<EditState> editState);
-    ~Simulation() = default;
+    ~Simulation();
+    
+    static constexpr float DEFAULT_TICK_RATE = 60.0f;
+    static constexpr float MIN_TICK_RATE = 10.0f;
+    static constexpr float MAX_TICK_RATE = 240.0f;
+    static constexpr float MAX_FRAME_TIME = 0.25f;   // 单帧最多计入的时间（秒）
+    static constexpr int MAX_STEPS_PER_FRAME = 16;
+    static constexpr uint32_t DEFAULT_SEED = 5489u;
+    static constexpr size_t MAX_CROWD_SIZE = 100000;
     
     // 仿真控制
+    // 仿真线程运行时，调用start/reset或修改Maze之前要先持有lock()返回的锁
+    // start提交异步全局规划并进入PLANNING状态，规划完成后才开始运行；规划期间仿真暂停
     void start();
     void reset();
+    std::unique_lock<std::mutex> lock() { return std::unique_lock<std::mutex>(m_mutex); }
+    
+    // 仿真线程：按固定步长在后台推进，每帧结束后发布快照，规划再慢也不阻塞渲染。
+    // 线程运行时不要再调用advance/update
+    void startThread();
+    void stopThread();
+    bool isThreadRunning() const { return m_thread.joinable(); }
+    
+    // 读端（渲染线程）：换入最新发布的快照，返回值在下一次acquireSnapshot前有效
+    const SimulationSnapshot& acquireSnapshot() { return m_snapshots.acquire(); }
+    // 读端：上一次acquireSnapshot得到的快照
+    const SimulationSnapshot& getSnapshot() const { return m_snapshots.readBuffer(); }
+    
+    // 推进一个仿真步，deltaTime即步长
     void update(float deltaTime);
+    // 按固定步长推进：frameTime累加到时间余量中，每满一个步长执行一次update。
+    // 单帧计入的时间不超过MAX_FRAME_TIME，步数不超过MAX_STEPS_PER_FRAME，超出部分直接丢弃，
+    // 渲染变慢时仿真开销仍然有上限。执行过步时发布一份快照，返回本次执行的步数
+    int advance(float frameTime);
+    // 阻塞到当前的异步规划完成并采用其结果，不在PLANNING状态时直接返回。
+    // 无界面批量运行时在start之后调用，保证结果与规划耗时无关
+    void waitForPlan();
+    
+    // 固定步长的频率（Hz），限制在[MIN_TICK_RATE, MAX_TICK_RATE]，可以在任意线程修改
+    void setTickRate(float hz);
+    float getTickRate() const { return m_tickRate.load(std::memory_order_relaxed); }
+    float getFixedTimeStep() const { return 1.0f / getTickRate(); }
+    // 时间余量占一个步长的比例，不使用仿真线程时渲染以它在上一步和当前步之间插值
+    float getInterpolationAlpha() const { return m_accumulator * getTickRate(); }
     
-    // 状态查询
+    // 随机数种子，下一次reset时生效，同一种子和步长下的仿真结果可以复现
+    void setSeed(uint32_t seed) { m_seed.store(seed, std::memory_order_relaxed); }
+    uint32_t getSeed() const { return m_seed.load(std::memory_order_relaxed); }
+    // 仿真中所有随机采样都应使用这个生成器
+    std::mt19937& getRandomEngine() { return m_random; }
+    
+    // 状态查询（仿真线程运行时其他线程应读取快照）
     bool isRunning() const { return m_state == SimulationState::RUNNING; }
+    bool isPlanning() const { return m_state == SimulationState::PLANNING; }
     bool isFinished() const { return m_state == SimulationState::FINISHED; }
     bool isIdle() const { return m_state == SimulationState::IDLE; }
     float getSimulationTime() const { return m_simulationTime; }
@@ -28,6 +100,14 @@ public:
     const Point& getAgentPosition() const { return m_maze->getCurrentPosition(); }
     void setAgentPosition(const Point& position) { m_maze->setCurrentPosition(position); }
     
+    // 群体代理：reset时在随机的空闲格生成，与主代理走向同一个目标并共用一个流场。
+    // 数量和种子在下一次reset时生效，限制在[0, MAX_CROWD_SIZE]，可以在任意线程修改。
+    // 主代理到达且所有群体代理都到达或无法前进时仿真结束
+    void setCrowdSize(size_t count) { m_crowdSize.store(std::min(count, MAX_CROWD_SIZE), std::memory_order_relaxed); }
+    size_t getCrowdSize() const { return m_crowdSize.load(std::memory_order_relaxed); }
+    // 仿真线程运行时其他线程只能在非RUNNING/PLANNING状态下读取
+    const AgentSet& getAgents() const { return m_agents; }
+    
     // 访问DWA参数
     float getMaxSpeed() const { return m_maxSpeed; }
     void setMaxSpeed(float speed) { m_maxSpeed = speed; }
@@ -38,15 +118,24 @@ public:
     float getSensorRange() const { return m_sensorRange; }
     void setSensorRange(float range) { m_sensorRange = range; }
     
+    // 全局规划算法选择
+    PlannerType getPlannerType() const { return m_plannerType.load(std::memory_order_relaxed); }
+    void setPlannerType(PlannerType type) { m_plannerType.store(type, std::memory_order_relaxed); }
+    const PlannerStats& getLastPlannerStats() const { return m_maze->getLastPlannerStats(); }
+    
+    // 是否向控制台输出仿真日志（无界面批量运行时关闭）
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+    
 private:
     // 引用核心组件
     std::shared_ptr<Maze> m_maze;
     std::shared_ptr<EditState> m_editState;
     
     // 仿真状态
-    SimulationState m_state = SimulationState::IDLE;
+    std::atomic<SimulationState> m_state{SimulationState::IDLE};
     glm::vec2 m_agentVelocity{0.0f, 0.0f};
     std::vector<Point> m_traversedPath;
+    bool m_agentArrived = false;  // 主代理已到达，等待群体代理
     float m_simulationTime = 0.0f;
     
     // DWA参数
@@ -54,8 +143,62 @@ private:
     float m_maxRotationSpeed = 2.0f;
     float m_sensorRange = 5.0f;
     
+    // 全局规划算法
+    std::atomic<PlannerType> m_plannerType{PlannerType::ASTAR};
+    std::shared_ptr<PlanJob> m_planJob;  // PLANNING状态下正在等待的异步规划
+    uint64_t m_partialRevision = 0;      // 已写入m_currentFrame的部分路径在作业中的修订号
+    uint64_t m_partialFrames = 0;        // 部分路径写入帧的次数，用来生成帧的路径修订号
+    size_t m_reportedNodes = 0;          // 最近一次发布的扩展节点数
+    
+    bool m_verbose = true;
+    
+    // 固定步长
+    std::atomic<float> m_tickRate{DEFAULT_TICK_RATE};
+    float m_accumulator = 0.0f;
+    SimulationFrame m_previousFrame;  // 上一步结束时的状态
+    SimulationFrame m_currentFrame;   // 最近一步结束时的状态
+    
+    // 随机数
+    std::atomic<uint32_t> m_seed{DEFAULT_SEED};
+    std::mt19937 m_random{DEFAULT_SEED};
+    
+    // 群体代理
+    std::atomic<size_t> m_crowdSize{0};
+    AgentSet m_agents;
+    // 生成当前群体时的参数，相同时reset只让群体回到初始位置，流场不必重建
+    struct CrowdSpawn {
+        size_t count = 0;
+        uint32_t seed = 0;
+        Point goal{-1.0, -1.0};
+        uint64_t staticRevision = ~0ull;
+        bool operator==(const CrowdSpawn& other) const = default;
+    };
+    CrowdSpawn m_crowdSpawn;
+    
+    // 仿真线程，步进、控制命令和Maze编辑都在m_mutex内进行
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+    bool m_stopThread = false;
+    TripleBuffer<SimulationSnapshot> m_snapshots;
+    
     // 内部方法
     void updateAgentPosition(float deltaTime);
+    // 数量、种子、目标或地图变化时重新生成群体，否则让群体回到初始位置
+    void spawnCrowd();
+    // 使用流场规划且流场有效时，按所在格的方向得到下一个目标点（O(1)查表）；否则返回false，按路径前进
+    bool nextFlowFieldPoint(const Point& currentPos, Point& nextPoint) const;
+    // 从当前位置提交异步规划，进入PLANNING状态
+    void beginPlanning();
+    // 规划完成时采用结果：成功进入RUNNING，失败回到IDLE，被编辑取消的重新提交。返回是否仍在规划
+    bool pollPlanning();
+    // 规划期间把部分路径写入m_currentFrame，有新进度时返回true
+    bool capturePlanningFrame();
+    void captureFrame(SimulationFrame& frame) const;
+    // 把当前状态写入三重缓冲并发布，调用时持有m_mutex（或没有仿真线程）
+    void publishSnapshot();
+    void threadMain();
+
 };
 
 } // namespace PathGlyph
\ No newline at end of file
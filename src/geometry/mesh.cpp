@@ -61,6 +61,28 @@ void Mesh::setIndexData(const std::vector<unsigned int>& indices) {
     glBindVertexArray(0);
 }
 
+void Mesh::bindInstanceBuffer(GLuint buffer) {
+    // 属性指针记录的是缓冲对象本身，缓冲重新分配存储（孤立）后无需重新设置
+    if (instanceVBO == buffer) {
+        return;
+    }
+    instanceVBO = buffer;
+    
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    
+    // mat4占用4个连续的属性位置，每列一个vec4，每个实例前进一次
+    for (GLuint column = 0; column < 4; ++column) {
+        GLuint location = 4 + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                              reinterpret_cast<void*>(column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+    }
+    
+    glBindVertexArray(0);
+}
+
 void Mesh::render(Shader* shader) const {
     // 绑定当前网格的 VAO
     glBindVertexArray(VAO);
@@ -60,6 +60,9 @@ public:
   
   // 实例化渲染方法
   void renderInstanced(class Shader* shader, uint32_t instanceCount) const;
+  
+  // 把实例变换缓冲绑定到VAO的属性4-7（每实例一个mat4），同一缓冲只设置一次
+  void bindInstanceBuffer(GLuint buffer);
 
   // 声明Model为友元类
   friend class Model;
@@ -68,6 +71,7 @@ private:
   GLuint VAO;
   GLuint VBO;
   GLuint EBO;  
+  GLuint instanceVBO = 0;  // 已绑定到VAO的实例变换缓冲（由Renderer持有）
   std::vector<Primitive> primitives;
 };
 
@@ -1,5 +1,6 @@
 #include "geometry/tileManager.h"
 #include "maze/maze.h"
+#include "core/agentSet.h"
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
@@ -7,12 +8,6 @@
 namespace PathGlyph {
 
 // 定义静态变换参数
-const ModelTransformParams TileManager::groundParams = {
-    1.0f,  // scaleFactor
-    glm::vec3(0.0f, 0.0f, 0.0f),  // positionOffset
-    glm::quat(1.0f, 0.0f, 0.0f, 0.0f)  // rotation
-};
-
 const ModelTransformParams TileManager::pathParams = {
     1.0f,  // scaleFactor
     glm::vec3(0.0f, 0.1f, 0.0f),  // positionOffset
@@ -83,7 +78,11 @@ Tile* TileManager::getTileAt(int x, int y) {
 
 // 获取图块的世界坐标并返回变换矩阵
 glm::mat4 TileManager::getTileWorldPosition(int x, int y, const ModelTransformParams& params) const {
-    glm::vec3 position(static_cast<float>(x), 0.0f, static_cast<float>(y));
+    return getWorldTransform(glm::vec2(static_cast<float>(x), static_cast<float>(y)), params);
+}
+
+glm::mat4 TileManager::getWorldTransform(const glm::vec2& logical, const ModelTransformParams& params) const {
+    glm::vec3 position(logical.x, 0.0f, logical.y);
     position += params.positionOffset;
     
     float scale = params.scaleFactor;
@@ -96,101 +95,149 @@ glm::mat4 TileManager::getTileWorldPosition(int x, int y, const ModelTransformPa
     return model;
 }
 
-// 获取地面变换矩阵
-std::vector<glm::mat4> TileManager::getGroundTransforms() const {
-    std::vector<glm::mat4> transforms;
-    transforms.reserve(width_ * height_);
+void TileManager::invalidate() {
+    pathRevision_ = INVALID_REVISION;
+    staticRevision_ = INVALID_REVISION;
+}
 
+void TileManager::syncSize() {
+    if (!maze_ || (maze_->getWidth() == width_ && maze_->getHeight() == height_)) {
+        return;
+    }
+    width_ = maze_->getWidth();
+    height_ = maze_->getHeight();
+    tiles_.assign(height_, std::vector<Tile>(width_));
     for (int y = 0; y < height_; ++y) {
         for (int x = 0; x < width_; ++x) {
-            const Tile& tile = tiles_[y][x];
-            transforms.push_back(getTileWorldPosition(tile.x, tile.y, groundParams));
+            createTile(x, y);
         }
     }
-    
-    return transforms;
 }
 
-// 获取路径变换矩阵
-std::vector<glm::mat4> TileManager::getPathTransforms() const {
-    std::vector<glm::mat4> transforms;
-    
-    const auto& path = maze_->getPath();
-    transforms.reserve(path.size());
+// 获取路径变换矩阵 - 只在重新规划或清除路径后重建
+const InstanceTransforms& TileManager::getPathTransforms() {
+    if (!maze_) {
+        return pathTransforms_;
+    }
+    // 有仿真快照时路径可能正在被仿真线程修改，只读快照里的副本
+    const uint64_t revision = frame_ ? frame_->pathRevision : maze_->getPathRevision();
+    if (revision == pathRevision_) {
+        return pathTransforms_;
+    }
+    pathRevision_ = revision;
     
+    const auto& path = frame_ ? frame_->path : maze_->getPath();
+    pathTransforms_.matrices.clear();
+    pathTransforms_.matrices.reserve(path.size());
     for (const auto& point : path) {
-        transforms.push_back(getTileWorldPosition(point.x, point.y, pathParams));
+        pathTransforms_.matrices.push_back(getTileWorldPosition(point.x, point.y, pathParams));
     }
-    
-    return transforms;
+    ++pathTransforms_.revision;
+    return pathTransforms_;
 }
 
-// 获取障碍物变换矩阵
-std::vector<glm::mat4> TileManager::getObstacleTransforms() const {
-    std::vector<glm::mat4> transforms;
+// 获取静态障碍物变换矩阵 - 只在静态修订号变化后重建
+const InstanceTransforms& TileManager::getStaticObstacleTransforms() {
+    // 地图尺寸变化总伴随静态修订号变化，图块在这里跟随地图尺寸
+    syncSize();
+    if (!maze_ || maze_->getStaticRevision() == staticRevision_) {
+        return staticObstacleTransforms_;
+    }
+    staticRevision_ = maze_->getStaticRevision();
     
     const auto& staticObstacles = maze_->getStaticObstacles();
-    transforms.reserve(staticObstacles.size());
-    
+    staticObstacleTransforms_.matrices.clear();
+    staticObstacleTransforms_.matrices.reserve(staticObstacles.size());
     for (const auto& obstacle : staticObstacles) {
         Point pos = obstacle->getLogicalPosition();
-        transforms.push_back(getTileWorldPosition(pos.x, pos.y, obstacleParams));
+        staticObstacleTransforms_.matrices.push_back(getTileWorldPosition(pos.x, pos.y, obstacleParams));
     }
-    
-    return transforms;
+    ++staticObstacleTransforms_.revision;
+    return staticObstacleTransforms_;
 }
 
-// 获取动态障碍物变换矩阵
-std::vector<glm::mat4> TileManager::getDynamicObstacleTransforms() const {
-    std::vector<glm::mat4> transforms;
+// 获取动态障碍物变换矩阵 - 每帧原地更新
+const InstanceTransforms& TileManager::getDynamicObstacleTransforms() {
+    if (!maze_) {
+        return dynamicObstacleTransforms_;
+    }
     
-    if (maze_) {
+    std::vector<glm::mat4>& matrices = dynamicObstacleTransforms_.matrices;
+    // 有仿真快照时动态障碍物只读快照，刚增删的障碍物在下一次发布后出现
+    if (frame_) {
+        const auto& positions = frame_->dynamicObstacles;
+        matrices.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            matrices[i] = getWorldTransform(positions[i], obstacleParams);
+        }
+    } else {
         const auto& dynamicObstacles = maze_->getDynamicObstacles();
-        transforms.reserve(dynamicObstacles.size());
-        
-        for (const auto& obstacle : dynamicObstacles) {
-            Point pos = obstacle->getLogicalPosition();
-            transforms.push_back(getTileWorldPosition(pos.x, pos.y, obstacleParams));
+        matrices.resize(dynamicObstacles.size());
+        for (size_t i = 0; i < dynamicObstacles.size(); ++i) {
+            matrices[i] = getWorldTransform(dynamicObstacles.getPosition(i), obstacleParams);
         }
     }
-    
-    return transforms;
+    ++dynamicObstacleTransforms_.revision;
+    return dynamicObstacleTransforms_;
+}
+
+void TileManager::updateMarker(InstanceTransforms& transforms, Point& cached, const Point& position,
+                               const ModelTransformParams& params) {
+    // 标记点的变换只取决于位置，位置不变就沿用上次的结果
+    if (cached.x == position.x && cached.y == position.y) {
+        return;
+    }
+    cached = position;
+    transforms.matrices.clear();
+    if (position.x >= 0 && position.y >= 0) {
+        transforms.matrices.push_back(getWorldTransform(glm::vec2(position.x, position.y), params));
+    }
+    ++transforms.revision;
 }
 
 // 获取起点变换矩阵
-std::vector<glm::mat4> TileManager::getStartTransforms() const {
-    std::vector<glm::mat4> transforms;
-    
-    const Point& start = maze_->getStart();
-    if (start.x >= 0 && start.y >= 0) {
-        transforms.push_back(getTileWorldPosition(start.x, start.y, startParams));
+const InstanceTransforms& TileManager::getStartTransforms() {
+    if (maze_) {
+        updateMarker(startTransforms_, startPosition_, maze_->getStart(), startParams);
     }
-    
-    return transforms;
+    return startTransforms_;
 }
 
 // 获取终点变换矩阵
-std::vector<glm::mat4> TileManager::getGoalTransforms() const {
-    std::vector<glm::mat4> transforms;
-    
-    const Point& goal = maze_->getGoal();
-    if (goal.x >= 0 && goal.y >= 0) {
-        transforms.push_back(getTileWorldPosition(goal.x, goal.y, goalParams));
+const InstanceTransforms& TileManager::getGoalTransforms() {
+    if (maze_) {
+        updateMarker(goalTransforms_, goalPosition_, maze_->getGoal(), goalParams);
     }
-    
-    return transforms;
+    return goalTransforms_;
 }
 
 // 获取代理变换矩阵
-std::vector<glm::mat4> TileManager::getAgentTransforms() const {
-    std::vector<glm::mat4> transforms;
+const InstanceTransforms& TileManager::getAgentTransforms() {
+    if (!maze_) {
+        return agentTransforms_;
+    }
+    const Point& position = frame_ ? frame_->agentPosition : maze_->getCurrentPosition();
+    const size_t crowdSize = frame_ ? frame_->agents.size() : (crowd_ ? crowd_->size() : 0);
+    if (crowdSize == 0) {
+        updateMarker(agentTransforms_, agentPosition_, position, agentParams);
+        return agentTransforms_;
+    }
     
-    Point pos = maze_->getCurrentPosition();
-    if (pos.x >= 0 && pos.y >= 0) {
-        transforms.push_back(getTileWorldPosition(pos.x, pos.y, agentParams));
+    // 群体每步都在移动，不做位置缓存；主代理的缓存作废，群体消失后重新生成
+    agentPosition_ = Point(-1.0, -1.0);
+    const bool hasAgent = position.x >= 0 && position.y >= 0;
+    const size_t first = hasAgent ? 1 : 0;
+    std::vector<glm::mat4>& matrices = agentTransforms_.matrices;
+    matrices.resize(first + crowdSize);
+    if (hasAgent) {
+        matrices[0] = getWorldTransform(glm::vec2(position.x, position.y), agentParams);
     }
-
-    return transforms;
+    for (size_t i = 0; i < crowdSize; ++i) {
+        const glm::vec2 crowdPosition = frame_ ? frame_->agents[i] : crowd_->getPosition(i);
+        matrices[first + i] = getWorldTransform(crowdPosition, agentParams);
+    }
+    ++agentTransforms_.revision;
+    return agentTransforms_;
 }
 
 // 获取网格线的变换矩阵
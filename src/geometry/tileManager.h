@@ -11,6 +11,7 @@ namespace PathGlyph {
 
 // 前向声明
 class Maze;
+class AgentSet;
 
 // 图块数据结构
 struct Tile {
@@ -26,6 +27,12 @@ struct ModelTransformParams {
     glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f); // 旋转（四元数）
 };
 
+// 一类实例的变换矩阵，revision在矩阵变化时递增，渲染器据此决定是否重新上传
+struct InstanceTransforms {
+    std::vector<glm::mat4> matrices;
+    uint64_t revision = 0;
+};
+
 // 图块管理器类 - 负责所有模型的空间变换和位置管理
 class TileManager {
 public:
@@ -34,7 +41,6 @@ public:
   ~TileManager() = default;
   
   // 默认变换参数
-  static const ModelTransformParams groundParams;
   static const ModelTransformParams pathParams;
   static const ModelTransformParams obstacleParams;
   static const ModelTransformParams startParams;
@@ -47,18 +53,31 @@ public:
   
   // 坐标转换 - 返回变换矩阵
   glm::mat4 getTileWorldPosition(int x, int y, const ModelTransformParams& params) const;
+  // 连续坐标的变换，用于插值后的动态障碍物和代理
+  glm::mat4 getWorldTransform(const glm::vec2& position, const ModelTransformParams& params) const;
   
   bool screenToTileCoordinate(const glm::vec2& screenPos, int& outX, int& outY, 
                               const glm::mat4& viewProj) const;
   
-  // 渲染数据收集 - 专用函数
-  std::vector<glm::mat4> getGroundTransforms() const;
-  std::vector<glm::mat4> getPathTransforms() const;
-  std::vector<glm::mat4> getObstacleTransforms() const;
-  std::vector<glm::mat4> getDynamicObstacleTransforms() const;
-  std::vector<glm::mat4> getStartTransforms() const;
-  std::vector<glm::mat4> getGoalTransforms() const;
-  std::vector<glm::mat4> getAgentTransforms() const;
+  // 渲染数据收集 - 返回TileManager持有的缓存，只重建发生变化的部分
+  // 路径随Maze的路径修订号、静态障碍物随静态修订号重建；地面由渲染器按地图尺寸直接绘制
+  const InstanceTransforms& getPathTransforms();
+  const InstanceTransforms& getStaticObstacleTransforms();
+  // 动态障碍物每次调用原地覆盖，修订号每次都递增
+  const InstanceTransforms& getDynamicObstacleTransforms();
+  const InstanceTransforms& getStartTransforms();
+  const InstanceTransforms& getGoalTransforms();
+  // 主代理在前、群体代理在后，整个群体一次实例化绘制；有群体时每次调用原地覆盖
+  const InstanceTransforms& getAgentTransforms();
+  
+  // 插值后的仿真状态，路径、动态障碍物和代理按它绘制；为空时直接读取maze_。
+  // 仿真线程运行时这三项只能从快照读取。frame由调用方持有，在下一次设置前必须保持有效
+  void setFrame(const SimulationFrame* frame) { frame_ = frame; }
+  // 没有快照时群体代理从这里读取（仿真线程此时不修改它），为空时只绘制主代理
+  void setCrowd(const AgentSet* crowd) { crowd_ = crowd; }
+  
+  // 丢弃所有缓存，下次访问时全部重建
+  void invalidate();
   
   // 获取网格线的变换矩阵（用于渲染坐标轴或网格）
   std::vector<glm::mat4> getGridLineTransforms() const;
@@ -70,11 +89,32 @@ public:
 private:
   // 初始化地面图块
   void createTile(int x, int y);
+  // 地图尺寸与maze_不一致时重新创建图块
+  void syncSize();
+  // 单个标记点（起点/终点/代理）的缓存：位置未变时不重建
+  void updateMarker(InstanceTransforms& transforms, Point& cached, const Point& position,
+                    const ModelTransformParams& params);
   
   int width_;
   int height_;
-  std::vector<std::vector<Tile>> tiles_; // 仅用于地面渲染
+  std::vector<std::vector<Tile>> tiles_;
   std::shared_ptr<Maze> maze_; // 直接从迷宫获取信息
+  const SimulationFrame* frame_ = nullptr;
+  const AgentSet* crowd_ = nullptr;
+  
+  // 持久的变换缓存
+  static constexpr uint64_t INVALID_REVISION = ~0ull;
+  InstanceTransforms pathTransforms_;
+  InstanceTransforms staticObstacleTransforms_;
+  InstanceTransforms dynamicObstacleTransforms_;
+  InstanceTransforms startTransforms_;
+  InstanceTransforms goalTransforms_;
+  InstanceTransforms agentTransforms_;
+  uint64_t pathRevision_ = INVALID_REVISION;
+  uint64_t staticRevision_ = INVALID_REVISION;
+  Point startPosition_ = Point(-1.0, -1.0);
+  Point goalPosition_ = Point(-1.0, -1.0);
+  Point agentPosition_ = Point(-1.0, -1.0);
 };
 
 } // namespace PathGlyph
\ No newline at end of file
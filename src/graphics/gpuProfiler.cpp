@@ -0,0 +1,70 @@
+#include "graphics/gpuProfiler.h"
+#include "common/profiler.h"
+
+namespace PathGlyph {
+
+GpuProfiler::~GpuProfiler() {
+    for (FrameQueries& frame : frames_) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    frameIndex_ = (frameIndex_ + 1) % FRAME_LATENCY;
+    FrameQueries& frame = frames_[frameIndex_];
+
+    // 这一组查询是FRAME_LATENCY帧之前发出的，通常已经完成；未完成的直接丢弃，避免等待GPU
+    Profiler& profiler = Profiler::shared();
+    for (size_t i = 0; i < frame.used; ++i) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &elapsedNs);
+        profiler.record(frame.names[i], static_cast<double>(elapsedNs) * 1e-6, true);
+    }
+    frame.used = 0;
+    frame.names.clear();
+}
+
+bool GpuProfiler::beginZone(const char* name) {
+    if (zoneOpen_ || !Profiler::shared().isEnabled()) {
+        return false;
+    }
+    FrameQueries& frame = frames_[frameIndex_];
+    if (frame.used == frame.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+    frame.names.push_back(name);
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[frame.used++]);
+    zoneOpen_ = true;
+    return true;
+}
+
+void GpuProfiler::endZone() {
+    if (!zoneOpen_) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    zoneOpen_ = false;
+}
+
+GpuProfileScope::GpuProfileScope(GpuProfiler* profiler, const char* name) : profiler_(profiler) {
+    if (profiler_) {
+        active_ = profiler_->beginZone(name);
+    }
+}
+
+GpuProfileScope::~GpuProfileScope() {
+    if (active_) {
+        profiler_->endZone();
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,57 @@
+#pragma once
+#include <glad/glad.h>
+#include <array>
+#include <vector>
+#include <cstddef>
+
+namespace PathGlyph {
+
+// GPU计时 - 用GL_TIME_ELAPSED查询包围各个渲染阶段
+// 查询结果要几帧后才可用，因此每帧使用一组独立的查询对象，轮转FRAME_LATENCY组；
+// beginFrame时读取最旧一组的结果并交给Profiler::shared()（区域标记为gpu）。
+// GL_TIME_ELAPSED查询不能嵌套，各区域必须依次开始和结束。
+class GpuProfiler {
+public:
+    GpuProfiler() = default;
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // 每帧开始时调用：回收最旧一组查询的结果，并开始新的一组
+    void beginFrame();
+
+    // name需要在结果读取前保持有效（通常为字符串字面量）
+    // 已有区域未结束或分析器被禁用时不开始查询，返回false
+    bool beginZone(const char* name);
+    void endZone();
+
+private:
+    static constexpr size_t FRAME_LATENCY = 4;
+
+    struct FrameQueries {
+        std::vector<GLuint> queries;       // 查询对象池，只增不减
+        std::vector<const char*> names;    // 与queries前used个一一对应
+        size_t used = 0;
+    };
+
+    std::array<FrameQueries, FRAME_LATENCY> frames_;
+    size_t frameIndex_ = 0;
+    bool zoneOpen_ = false;
+};
+
+// GPU计时区域：构造时开始查询，析构时结束；profiler为空或查询未开始时什么都不做
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler* profiler, const char* name);
+    ~GpuProfileScope();
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler* profiler_;
+    bool active_ = false;
+};
+
+} // namespace PathGlyph
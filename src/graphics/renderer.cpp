@@ -1,5 +1,6 @@
 #include "graphics/renderer.h"
 #include "geometry/model.h"
+#include "common/profiler.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
@@ -8,6 +9,12 @@
 
 namespace PathGlyph {
 
+namespace {
+
+constexpr float CLEARANCE_HEATMAP_RANGE = 8.0f;  // 热力图颜色从红到绿覆盖的距离（格）
+
+} // namespace
+
 // 构造函数和析构函数
 Renderer::Renderer(GLFWwindow* window, std::shared_ptr<Maze> maze, std::shared_ptr<EditState> editState)
     : window_(window), maze_(maze), editState_(editState) {
@@ -56,25 +63,40 @@ Renderer::Renderer(GLFWwindow* window, std::shared_ptr<Maze> maze, std::shared_p
     
     initModelArray();
     initRenderParamsArray();
+    setupRenderData();
+    
+    for (InstanceBuffer& instances : instanceBuffers_) {
+        glGenBuffers(1, &instances.buffer);
+    }
 }
 
 Renderer::~Renderer() {
     // 着色器和模型对象会通过智能指针自动释放
+    for (InstanceBuffer& instances : instanceBuffers_) {
+        if (instances.buffer) {
+            glDeleteBuffers(1, &instances.buffer);
+        }
+    }
+    if (groundVAO_) {
+        glDeleteVertexArrays(1, &groundVAO_);
+    }
+    if (groundVBO_) {
+        glDeleteBuffers(1, &groundVBO_);
+    }
+    if (clearanceTexture_) {
+        glDeleteTextures(1, &clearanceTexture_);
+    }
 }
 
 // 核心渲染功能
 void Renderer::render() {
-    // 计算帧时间
-    float currentTime = static_cast<float>(glfwGetTime());
-    float deltaTime = currentTime - lastFrameTime_;
-    lastFrameTime_ = currentTime;
-    
     // 清除缓冲
     glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
-    // 如果几何数据需要更新，更新标志
+    // 编辑后丢弃TileManager的变换缓存；平时只由修订号驱动增量更新
     if (needsUpdateGeometry_) {
+        tileManager_->invalidate();
         needsUpdateGeometry_ = false;
     }
     
@@ -82,20 +104,26 @@ void Renderer::render() {
     updateMatrices();
     
     // 渲染地面
-    renderGround();
+    renderPass("Ground", &Renderer::renderGround);
     
     // 渲染路径
-    renderPath();
+    renderPass("Path", &Renderer::renderPath);
     
     // 渲染障碍物
-    renderObstacles();
+    renderPass("Obstacles", &Renderer::renderObstacles);
     
     // 渲染起点和终点
-    // renderStart();
-    renderGoal();
+    // renderPass("Start", &Renderer::renderStart);
+    renderPass("Goal", &Renderer::renderGoal);
     
     // 渲染代理
-    renderAgents();
+    renderPass("Agents", &Renderer::renderAgents);
+}
+
+void Renderer::renderPass(const char* name, void (Renderer::*pass)()) {
+    ProfileScope cpuZone(name);
+    GpuProfileScope gpuZone(&gpuProfiler_, name);
+    (this->*pass)();
 }
 
 // 视图控制函数
@@ -205,6 +233,7 @@ void Renderer::enableBlending(bool enable) {
 bool Renderer::loadShaders() {
     try {
         modelShader_ = std::make_unique<Shader>();
+        groundShader_ = std::make_unique<Shader>("ground.vert", "ground.frag");
         
         // 假设着色器代码已编译到对象中
         return true;
@@ -214,6 +243,25 @@ bool Renderer::loadShaders() {
     }
 }
 
+void Renderer::setupRenderData() {
+    // 地面为单位正方形（三角形带），地图尺寸通过mapSize uniform传入，地图变化时无需重建
+    const float corners[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 1.0f,
+    };
+    
+    glGenVertexArrays(1, &groundVAO_);
+    glGenBuffers(1, &groundVBO_);
+    glBindVertexArray(groundVAO_);
+    glBindBuffer(GL_ARRAY_BUFFER, groundVBO_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+}
+
 void Renderer::initModelArray() {
     // 创建模型数组，每种模型类型一个
     models_.resize(static_cast<size_t>(ModelType::COUNT));
@@ -221,6 +269,10 @@ void Renderer::initModelArray() {
     // 为每种类型加载模型
     for (int i = 0; i < static_cast<int>(ModelType::COUNT); i++) {
         ModelType type = static_cast<ModelType>(i);
+        // 地面是setupRenderData创建的平面，不加载模型
+        if (type == ModelType::GROUND) {
+            continue;
+        }
         models_[i] = std::make_unique<Model>();
         
         // 加载模型
@@ -301,7 +353,7 @@ void Renderer::applyRenderParams(const RenderParams& params) {
     }
 }
 
-void Renderer::renderModels(ModelType modelType, const std::vector<glm::mat4>& transforms) {
+void Renderer::renderModels(ModelType modelType, InstanceCategory category, const InstanceTransforms& transforms) {
     // 获取模型索引
     size_t modelIndex = static_cast<size_t>(modelType);
 
@@ -312,7 +364,7 @@ void Renderer::renderModels(ModelType modelType, const std::vector<glm::mat4>& t
     }
 
     // 如果没有提供任何变换矩阵，则不渲染
-    if (transforms.empty()) {
+    if (transforms.matrices.empty()) {
         // std::cout << "没有提供变换矩阵，跳过渲染模型类型: " << static_cast<int>(modelType) << std::endl;
         return; // Or handle as needed, maybe render at origin? For now, skip.
     }
@@ -333,27 +385,14 @@ void Renderer::renderModels(ModelType modelType, const std::vector<glm::mat4>& t
     }
     modelShader_->use();
 
-    // 设置是否使用实例化渲染
-    bool useInstanced = transforms.size() > 1;
-    modelShader_->setBool("isInstanced", useInstanced); // 告知着色器是否为实例化
-
     // 添加统一的模型缩放 (保持不变，这是一个全局缩放因子)
     float modelScale = 0.5f; // 调整此值以适应您的模型大小
     modelShader_->setFloat("modelScale", modelScale);
 
-    // 设置世界变换 Uniform
-    size_t instanceCount = 0; // 用于渲染调用
-    if (useInstanced) {
-        // 多实例: 设置 instanceTransforms 数组
-        instanceCount = std::min(transforms.size(), size_t(500)); // 假设着色器最多支持 500 个实例
-        modelShader_->setMat4Array("instanceTransforms", transforms.data(), instanceCount);
-        // (可选)可以设置 model uniform 为单位阵，以防着色器逻辑混淆，但这取决于着色器实现
-        // modelShader_->setMat4("model", glm::mat4(1.0f));
-    } else {
-        // 单实例: 设置 model uniform 为传入的第一个变换
-        instanceCount = 1; // 用于渲染调用计数（虽然不是真的实例化）
-        modelShader_->setMat4("model", transforms[0]); // 使用传入的世界变换！
-    }
+    // 世界变换作为实例属性上传，单个物体也按1个实例绘制；内容未变的类别直接沿用已上传的缓冲
+    InstanceBuffer& instances = instanceBuffers_[static_cast<size_t>(category)];
+    uploadInstanceTransforms(instances, transforms);
+    uint32_t instanceCount = static_cast<uint32_t>(transforms.matrices.size());
 
     // 渲染每个节点的网格
     for (const auto& nodeMesh : nodeMeshes) {
@@ -370,14 +409,28 @@ void Renderer::renderModels(ModelType modelType, const std::vector<glm::mat4>& t
             continue;
         }
 
-        // 渲染：根据是否实例化调用不同函数
-        if (useInstanced) {
-             mesh->renderInstanced(modelShader_.get(), instanceCount);
-        } else {
-             // 单实例渲染
-             mesh->render(modelShader_.get());
-        }
+        mesh->bindInstanceBuffer(instances.buffer);
+        mesh->renderInstanced(modelShader_.get(), instanceCount);
+    }
+}
+
+void Renderer::uploadInstanceTransforms(InstanceBuffer& target, const InstanceTransforms& transforms) {
+    if (target.revision == transforms.revision) {
+        return;
     }
+    target.revision = transforms.revision;
+    glBindBuffer(GL_ARRAY_BUFFER, target.buffer);
+    
+    // 容量不足时按2倍增长；否则以相同大小重新分配来孤立旧存储，
+    // 驱动会给出新的内存，上一次绘制仍在使用的数据不受影响
+    const std::vector<glm::mat4>& matrices = transforms.matrices;
+    if (matrices.size() > target.capacity) {
+        target.capacity = std::max(matrices.size(), target.capacity * 2);
+    }
+    glBufferData(GL_ARRAY_BUFFER, target.capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, matrices.size() * sizeof(glm::mat4), matrices.data());
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Renderer::updateMatrices() {
@@ -440,81 +493,88 @@ void Renderer::updateMatrices() {
             float lightHeight = 30.0f; // 光源高度
             float lightOffsetX = -10.0f; // X方向偏移
             float lightOffsetZ = -10.0f; // Z方向偏移
-            glm::vec3 lightPos = glm::vec3(mapCenterX + lightOffsetX, lightHeight, mapCenterZ + lightOffsetZ);
-            modelShader_->setVec3("lightPos", lightPos);
+            lightPos_ = glm::vec3(mapCenterX + lightOffsetX, lightHeight, mapCenterZ + lightOffsetZ);
+            modelShader_->setVec3("lightPos", lightPos_);
         }
     }
 }
 
 void Renderer::renderGround() {
-    // 获取地面的变换矩阵
-    auto transforms = tileManager_->getGroundTransforms();
-    
-    applyRenderParams(getRenderParamsForOverlay(TileOverlayType::None));
-    renderModels(ModelType::GROUND, transforms);
-    
-    // 添加网格线框描边以便识别坐标
-    // 保存当前多边形模式
-    GLint polygonMode;
-    glGetIntegerv(GL_POLYGON_MODE, &polygonMode);
-    
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glDepthMask(GL_FALSE);
-    glLineWidth(10.0f);
-    
-    // 在着色器中设置线框颜色为黑色
-    if (modelShader_) {
-        modelShader_->use();
-        modelShader_->setVec4("material.diffuse", glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // 黑色线框
-        modelShader_->setBool("material.hasTexture", false);
+    if (!groundShader_ || !groundVAO_) {
+        return;
     }
     
-    // 渲染线框
-    renderModels(ModelType::GROUND, transforms);
+    // 整张地面只有一次绘制调用，网格线和坐标轴颜色在片段着色器中按世界坐标计算
+    groundShader_->use();
+    groundShader_->setMat4("view", viewMatrix_);
+    groundShader_->setMat4("projection", projectionMatrix_);
+    groundShader_->setVec2("mapSize", glm::vec2(static_cast<float>(maze_->getWidth()),
+                                                 static_cast<float>(maze_->getHeight())));
+    groundShader_->setVec4("groundColor", getRenderParamsForOverlay(TileOverlayType::None).baseColor);
+    
+    // 与模型着色器使用同一个点光源
+    groundShader_->setVec3("lightPos", lightPos_);
+    
+    // 净空热力图只在打开时上传，之后随静态修订号更新
+    bool showClearance = editState_ && editState_->showClearance;
+    if (showClearance) {
+        updateClearanceTexture();
+        showClearance = clearanceUploaded_;
+    }
+    groundShader_->setBool("showClearance", showClearance);
+    if (showClearance) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, clearanceTexture_);
+        groundShader_->setInt("clearanceMap", 0);
+        groundShader_->setFloat("clearanceScale", CLEARANCE_HEATMAP_RANGE);
+    }
     
-    // 在地图边缘特别标记坐标轴
-    if (modelShader_) {
-        // 获取地图尺寸
-        int width = tileManager_->getWidth();
-        int height = tileManager_->getHeight();
-        
-        // 设置渲染参数 - 使用红色
-        modelShader_->use();
-        modelShader_->setVec4("material.diffuse", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)); // 红色
-        
-        // X轴方向加粗线
-        glLineWidth(2.0f);
-        for (int x = 0; x < width; ++x) {
-            // 在底边绘制X轴刻度线
-            glm::mat4 transform = tileManager_->getTileWorldPosition(x, 0, TileManager::groundParams);
-            std::vector<glm::mat4> xAxisTransform = {transform};
-            renderModels(ModelType::GROUND, xAxisTransform);
-        }
-        
-        // Y轴方向加粗线
-        modelShader_->setVec4("material.diffuse", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)); // 蓝色
-        for (int y = 0; y < height; ++y) {
-            // 在左边绘制Y轴刻度线
-            glm::mat4 transform = tileManager_->getTileWorldPosition(0, y, TileManager::groundParams);
-            std::vector<glm::mat4> yAxisTransform = {transform};
-            renderModels(ModelType::GROUND, yAxisTransform);
-        }
+    glBindVertexArray(groundVAO_);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    if (showClearance) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void Renderer::updateClearanceTexture() {
+    if (clearanceUploaded_ && clearanceRevision_ == maze_->getStaticRevision()) {
+        return;
+    }
+    clearanceRevision_ = maze_->getStaticRevision();
+    clearanceUploaded_ = false;
+    
+    const DistanceField& field = maze_->getDistanceField();
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (!field.isBuilt() || field.getWidth() <= 0 || field.getHeight() <= 0 ||
+        field.getWidth() > maxSize || field.getHeight() > maxSize) {
+        return;
     }
     
-    // 恢复深度写入
-    glDepthMask(GL_TRUE);
-    // 恢复原来的多边形模式
-    glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
-    // 恢复线宽
-    glLineWidth(1.0f);
+    if (!clearanceTexture_) {
+        glGenTextures(1, &clearanceTexture_);
+        glBindTexture(GL_TEXTURE_2D, clearanceTexture_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, clearanceTexture_);
+    }
+    // 按行存放，第y行对应纹理的第y行，格子中心正好落在纹素中心
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, field.getWidth(), field.getHeight(), 0, GL_RED, GL_FLOAT,
+                 field.getDistances().data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    clearanceUploaded_ = true;
 }
 
 void Renderer::renderPath() {
     // 获取路径的变换矩阵
-    auto transforms = tileManager_->getPathTransforms();
+    const auto& transforms = tileManager_->getPathTransforms();
     
     // 如果有路径才渲染
-    if (!transforms.empty()) {
+    if (!transforms.matrices.empty()) {
         // 启用混合模式
         enableBlending(true);
         
@@ -522,7 +582,7 @@ void Renderer::renderPath() {
         applyRenderParams(getRenderParamsForOverlay(TileOverlayType::Path));
         
         // 渲染路径
-        renderModels(ModelType::PATH, transforms);
+        renderModels(ModelType::PATH, InstanceCategory::PATH, transforms);
         
         // 禁用混合模式
         enableBlending(false);
@@ -530,62 +590,57 @@ void Renderer::renderPath() {
 }
 
 void Renderer::renderObstacles() {
-    // 获取静态障碍物的变换矩阵
-    auto staticTransforms = tileManager_->getObstacleTransforms();
-    auto dynamicTransforms = tileManager_->getDynamicObstacleTransforms();
-    
-    // 合并所有障碍物变换
-    std::vector<glm::mat4> allObstacles;
-    allObstacles.reserve(staticTransforms.size() + dynamicTransforms.size());
-    allObstacles.insert(allObstacles.end(), staticTransforms.begin(), staticTransforms.end());
-    allObstacles.insert(allObstacles.end(), dynamicTransforms.begin(), dynamicTransforms.end());
+    // 静态障碍物只在编辑后重新上传，动态障碍物每帧流式上传，分两次绘制
+    const auto& staticTransforms = tileManager_->getStaticObstacleTransforms();
+    const auto& dynamicTransforms = tileManager_->getDynamicObstacleTransforms();
     
     // 如果有障碍物才渲染
-    if (!allObstacles.empty()) {
+    if (!staticTransforms.matrices.empty() || !dynamicTransforms.matrices.empty()) {
         applyRenderParams(getRenderParamsForOverlay(TileOverlayType::Obstacle));
-        renderModels(ModelType::OBSTACLE, allObstacles);
+        renderModels(ModelType::OBSTACLE, InstanceCategory::STATIC_OBSTACLES, staticTransforms);
+        renderModels(ModelType::OBSTACLE, InstanceCategory::DYNAMIC_OBSTACLES, dynamicTransforms);
     }
 }
 
 void Renderer::renderAgents() {
     // 获取代理的变换矩阵
-    auto transforms = tileManager_->getAgentTransforms();
+    const auto& transforms = tileManager_->getAgentTransforms();
     
     // 如果有代理才渲染
-    if (!transforms.empty()) {
+    if (!transforms.matrices.empty()) {
         // 设置渲染参数
         applyRenderParams(getRenderParamsForOverlay(TileOverlayType::Agent));
         
         // 渲染代理
-        renderModels(ModelType::AGENT, transforms);
+        renderModels(ModelType::AGENT, InstanceCategory::AGENTS, transforms);
     }
 }
 
 void Renderer::renderStart() {
     // 获取起点的变换矩阵
-    auto transforms = tileManager_->getStartTransforms();
+    const auto& transforms = tileManager_->getStartTransforms();
     
     // 如果有起点才渲染
-    if (!transforms.empty()) {
+    if (!transforms.matrices.empty()) {
         // 设置渲染参数
         applyRenderParams(getRenderParamsForOverlay(TileOverlayType::Start));
         
         // 渲染起点
-        renderModels(ModelType::START, transforms);
+        renderModels(ModelType::START, InstanceCategory::START, transforms);
     }
 }
 
 void Renderer::renderGoal() {
     // 获取终点的变换矩阵
-    auto transforms = tileManager_->getGoalTransforms();
+    const auto& transforms = tileManager_->getGoalTransforms();
     
     // 如果有终点才渲染
-    if (!transforms.empty()) {
+    if (!transforms.matrices.empty()) {
         // 设置渲染参数
         applyRenderParams(getRenderParamsForOverlay(TileOverlayType::Goal));
         
         // 渲染终点
-        renderModels(ModelType::GOAL, transforms);
+        renderModels(ModelType::GOAL, InstanceCategory::GOAL, transforms);
     }
 }
 
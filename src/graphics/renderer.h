@@ -4,12 +4,14 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <array>
 #include <glm/glm.hpp>
 
 #include "maze/maze.h"
 #include "common/types.h"
 #include "geometry/tileManager.h"
 #include "graphics/shader.h"
+#include "graphics/gpuProfiler.h"
 
 namespace PathGlyph {
 
@@ -38,6 +40,11 @@ public:
     void setShowPath(bool show);
     void setShowObstacles(bool show);
 
+    // 插值后的仿真状态，为空时按Maze的当前状态绘制路径、动态障碍物和代理
+    void setSimulationFrame(const SimulationFrame* frame) { tileManager_->setFrame(frame); }
+    // 没有仿真帧时绘制的群体代理
+    void setCrowd(const AgentSet* crowd) { tileManager_->setCrowd(crowd); }
+
     // 标记几何数据需要更新
     void markGeometryForUpdate() { needsUpdateGeometry_ = true; }
 
@@ -49,8 +56,29 @@ public:
     
     // 获取当前视图投影矩阵
     glm::mat4 getViewProjectionMatrix() const { return projectionMatrix_ * viewMatrix_; }
+    
+    // GPU计时器，Application用它为ImGui阶段计时并在每帧开始时回收结果
+    GpuProfiler& getGpuProfiler() { return gpuProfiler_; }
 
 private:
+    // 每类实例一个GPU缓冲：内容不常变的类别只在TileManager的修订号变化时上传，
+    // 每帧都变的类别（动态障碍物、代理）每帧流式上传
+    enum class InstanceCategory {
+        PATH,
+        STATIC_OBSTACLES,
+        DYNAMIC_OBSTACLES,
+        START,
+        GOAL,
+        AGENTS,
+        COUNT
+    };
+
+    struct InstanceBuffer {
+        GLuint buffer = 0;
+        size_t capacity = 0;          // 当前分配的矩阵数量
+        uint64_t revision = ~0ull;    // 已上传的InstanceTransforms修订号
+    };
+
     // 渲染状态控制
     void enableWireframe(bool enable);
     void enableDepthTest(bool enable);
@@ -58,7 +86,7 @@ private:
 
     // 资源管理
     bool loadShaders();
-    void setupRenderData();
+    void setupRenderData();  // 创建地面平面的顶点数据
     
     // 初始化模型和渲染参数数组
     void initModelArray();
@@ -67,8 +95,11 @@ private:
     // 应用渲染参数到着色器
     void applyRenderParams(const RenderParams& params);
     
-    // 通用渲染函数 - 支持实例化渲染
-    void renderModels(ModelType modelType, const std::vector<glm::mat4>& transforms);
+    // 通用渲染函数 - 所有模型都以实例化方式绘制，实例数量不设上限
+    void renderModels(ModelType modelType, InstanceCategory category, const InstanceTransforms& transforms);
+    
+    // 修订号与已上传的不同时把矩阵上传到该类别的缓冲，上传前孤立旧存储，避免等待上一次绘制
+    void uploadInstanceTransforms(InstanceBuffer& target, const InstanceTransforms& transforms);
     
     // 更新视图和投影矩阵
     void updateMatrices();
@@ -81,6 +112,12 @@ private:
     void renderStart();      // 渲染起点
     void renderGoal();       // 渲染终点
     void renderGridLines();  // 渲染网格线
+    
+    // 静态障碍物变化后把距离场上传到clearanceTexture_，地面着色器据此绘制热力图
+    void updateClearanceTexture();
+    
+    // 执行一个渲染阶段，同时记录CPU耗时和GPU耗时
+    void renderPass(const char* name, void (Renderer::*pass)());
 
     GLFWwindow* window_;
     int viewportWidth_ = 800;
@@ -90,15 +127,29 @@ private:
     std::shared_ptr<EditState> editState_; // 编辑状态
     std::shared_ptr<TileManager> tileManager_; // 图块管理器
     std::unique_ptr<Shader> modelShader_;  // 着色器
+    std::unique_ptr<Shader> groundShader_; // 地面着色器（网格线在片段着色器中计算）
     std::vector<std::unique_ptr<Model>> models_; // 模型资源数组
     std::vector<RenderParams> renderParams_; // 预定义的渲染参数数组
+    
+    // 各类别的实例变换缓冲（顶点属性4-7，每实例一个mat4）
+    std::array<InstanceBuffer, static_cast<size_t>(InstanceCategory::COUNT)> instanceBuffers_;
+    
+    // 地面平面：一个单位正方形，在顶点着色器中拉伸到地图大小
+    GLuint groundVAO_ = 0;
+    GLuint groundVBO_ = 0;
+    
+    // 静态障碍物距离场纹理（单通道浮点，线性过滤即为格子中心之间的双线性插值）
+    GLuint clearanceTexture_ = 0;
+    uint64_t clearanceRevision_ = 0;  // 已上传的静态修订号
+    bool clearanceUploaded_ = false;  // 纹理内容有效（地图超出最大纹理尺寸时为false）
 
     // 变换矩阵 - 仅保留视图和投影矩阵
     glm::mat4 projectionMatrix_ = glm::mat4(1.0f);
     glm::mat4 viewMatrix_ = glm::mat4(1.0f);
+    glm::vec3 lightPos_ = glm::vec3(0.0f); // 点光源位置，updateMatrices中随地图中心更新
 
     bool needsUpdateGeometry_ = true;
-    float lastFrameTime_ = 0.0f;
+    GpuProfiler gpuProfiler_; // 各渲染阶段的GPU计时
 };
 
 }
\ No newline at end of file
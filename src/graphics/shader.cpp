@@ -7,10 +7,17 @@
 
 namespace PathGlyph {
 
-Shader::Shader() : m_programID(0) {
-    // 使用固定路径
-    const std::string vertexPath = "/home/mkaros/projects/PathGlyph/assets/shaders/model.vert";
-    const std::string fragmentPath = "/home/mkaros/projects/PathGlyph/assets/shaders/model.frag";
+namespace {
+// 着色器文件所在目录（固定路径）
+const std::string SHADER_DIR = "/home/mkaros/projects/PathGlyph/assets/shaders/";
+}
+
+Shader::Shader() : Shader("model.vert", "model.frag") {
+}
+
+Shader::Shader(const std::string& vertexFile, const std::string& fragmentFile) : m_programID(0) {
+    const std::string vertexPath = SHADER_DIR + vertexFile;
+    const std::string fragmentPath = SHADER_DIR + fragmentFile;
     
     // 1. 从文件路径读取顶点/片段着色器代码
     std::string vertexCode;
@@ -7,7 +7,10 @@ namespace PathGlyph {
 
 class Shader {
 public:
+    // 默认加载模型着色器model.vert/model.frag
     Shader();
+    // 从着色器目录加载指定的顶点/片段着色器文件
+    Shader(const std::string& vertexFile, const std::string& fragmentFile);
     ~Shader();
     
     // 禁用拷贝
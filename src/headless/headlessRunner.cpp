@@ -0,0 +1,108 @@
+#include "headless/headlessRunner.h"
+#include "core/simulation.h"
+#include <chrono>
+#include <memory>
+
+namespace PathGlyph {
+
+ScenarioMetrics HeadlessRunner::run(const std::string& mazeFile) const {
+    ScenarioMetrics metrics;
+    metrics.mazeFile = mazeFile;
+    auto begin = std::chrono::steady_clock::now();
+
+    auto maze = std::make_shared<Maze>();
+    metrics.loaded = maze->loadFromFile(mazeFile);
+    if (metrics.loaded) {
+        auto editState = std::make_shared<EditState>();
+        Simulation simulation(maze, editState);
+        simulation.setVerbose(false);
+        simulation.setPlannerType(m_config.planner);
+        simulation.setSeed(m_config.seed);
+        simulation.setCrowdSize(m_config.crowdSize);
+        simulation.start();
+        // 全局规划在线程池中异步执行，同步等待结果，步数和耗时与规划快慢无关。
+        // 规划失败时仿真回到空闲，循环直接结束
+        simulation.waitForPlan();
+
+        while (simulation.isRunning() && simulation.getSimulationTime() < m_config.maxSimulationTime) {
+            simulation.update(m_config.timeStep);
+            ++metrics.steps;
+            simulation.waitForPlan();
+        }
+
+        metrics.reachedGoal = simulation.isFinished();
+        metrics.timeToGoal = simulation.getSimulationTime();
+        metrics.pathCost = simulation.getLastPlannerStats().pathCost;
+        metrics.nodesExpanded = simulation.getLastPlannerStats().nodesExpanded;
+        metrics.crowdSize = simulation.getAgents().size();
+        metrics.crowdArrived = simulation.getAgents().getArrivedCount();
+
+        const std::vector<Point>& traversed = simulation.getTraversedPath();
+        for (size_t i = 1; i < traversed.size(); ++i) {
+            metrics.traversedLength += traversed[i].distanceTo(traversed[i - 1]);
+        }
+    }
+
+    metrics.wallTimeMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return metrics;
+}
+
+void HeadlessRunner::writeCsvHeader(std::ostream& out) {
+    out << "maze,planner,loaded,reached_goal,time_to_goal,steps,path_cost,"
+           "traversed_length,nodes_expanded,wall_time_ms,crowd_size,crowd_arrived\n";
+}
+
+void HeadlessRunner::writeCsvRow(std::ostream& out, const ScenarioMetrics& metrics) const {
+    out << metrics.mazeFile << ','
+        << plannerName(m_config.planner) << ','
+        << (metrics.loaded ? 1 : 0) << ','
+        << (metrics.reachedGoal ? 1 : 0) << ','
+        << metrics.timeToGoal << ','
+        << metrics.steps << ','
+        << metrics.pathCost << ','
+        << metrics.traversedLength << ','
+        << metrics.nodesExpanded << ','
+        << metrics.wallTimeMs << ','
+        << metrics.crowdSize << ','
+        << metrics.crowdArrived << '\n';
+}
+
+bool HeadlessRunner::parsePlannerType(const std::string& name, PlannerType& type) {
+    if (name == "astar") {
+        type = PlannerType::ASTAR;
+    } else if (name == "jps") {
+        type = PlannerType::JPS;
+    } else if (name == "jps+") {
+        type = PlannerType::JPS_PLUS;
+    } else if (name == "dstar") {
+        type = PlannerType::DSTAR_LITE;
+    } else if (name == "hpa") {
+        type = PlannerType::HPA_STAR;
+    } else if (name == "flow") {
+        type = PlannerType::FLOW_FIELD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* HeadlessRunner::plannerName(PlannerType type) {
+    switch (type) {
+        case PlannerType::JPS:
+            return "jps";
+        case PlannerType::JPS_PLUS:
+            return "jps+";
+        case PlannerType::DSTAR_LITE:
+            return "dstar";
+        case PlannerType::HPA_STAR:
+            return "hpa";
+        case PlannerType::FLOW_FIELD:
+            return "flow";
+        case PlannerType::ASTAR:
+        default:
+            return "astar";
+    }
+}
+
+} // namespace PathGlyph
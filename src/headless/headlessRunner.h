@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include "common/types.h"
+
+namespace PathGlyph {
+
+// 无界面仿真的配置
+struct HeadlessConfig {
+    PlannerType planner = PlannerType::ASTAR;
+    float timeStep = 1.0f / 60.0f;      // 固定仿真步长（秒）
+    float maxSimulationTime = 600.0f;   // 超过该仿真时长仍未到达视为失败
+    uint32_t seed = 5489u;              // Simulation的随机种子，同一种子的结果可复现
+    size_t crowdSize = 0;               // 与主代理一起走向目标的群体代理数
+};
+
+// 单个场景的运行指标
+struct ScenarioMetrics {
+    std::string mazeFile;
+    bool loaded = false;            // 地图文件是否成功加载
+    bool reachedGoal = false;
+    float timeToGoal = 0.0f;        // 到达目标时的仿真时间（秒），未到达时为结束时的仿真时间
+    size_t steps = 0;               // 执行的仿真步数
+    double pathCost = 0.0;          // 全局规划的路径代价
+    double traversedLength = 0.0;   // 代理实际走过的距离
+    size_t nodesExpanded = 0;       // 全局规划扩展的节点数
+    double wallTimeMs = 0.0;        // 加载到结束的墙钟时间（毫秒）
+    size_t crowdSize = 0;           // 实际生成的群体代理数（地图几乎占满时可能少于配置）
+    size_t crowdArrived = 0;        // 到达目标的群体代理数
+};
+
+// 无界面运行器 - 不创建窗口和OpenGL上下文
+// 加载迷宫JSON，以固定步长尽可能快地推进Simulation，直到主代理和群体都停下、规划失败或超时。
+// run为const且每次都新建Maze/Simulation，可以在多个线程中同时运行不同场景。
+class HeadlessRunner {
+public:
+    explicit HeadlessRunner(const HeadlessConfig& config) : m_config(config) {}
+
+    ScenarioMetrics run(const std::string& mazeFile) const;
+
+    // CSV输出，每个场景一行
+    static void writeCsvHeader(std::ostream& out);
+    void writeCsvRow(std::ostream& out, const ScenarioMetrics& metrics) const;
+
+    // 规划算法名称与PlannerType的相互转换，名称为astar/jps/jps+/dstar/hpa/flow
+    static bool parsePlannerType(const std::string& name, PlannerType& type);
+    static const char* plannerName(PlannerType type);
+
+private:
+    HeadlessConfig m_config;
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,130 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/profiler.h"
+#include "common/threadPool.h"
+#include "headless/headlessRunner.h"
+#include "maze/mazeFile.h"
+
+using namespace PathGlyph;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <maze.json | maze.pgmaze | directory>...\n"
+              << "  --planner <astar|jps|jps+|dstar|hpa|flow>  global planner (default astar)\n"
+              << "  --dt <seconds>                        fixed time step (default 1/60)\n"
+              << "  --max-time <seconds>                  simulated time limit (default 600)\n"
+              << "  --seed <n>                            random seed (default 5489)\n"
+              << "  --agents <n>                          crowd agents heading to the goal (default 0)\n"
+              << "  --jobs <n>                            scenarios run in parallel (default: all cores)\n"
+              << "  --output <file.csv>                   write metrics to a file instead of stdout\n";
+}
+
+// 目录展开为其中的所有.json和.pgmaze文件（按文件名排序，保证输出顺序稳定）
+void collectMazeFiles(const std::string& path, std::vector<std::string>& files) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error)) {
+        files.push_back(path);
+        return;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+        if (entry.is_regular_file() &&
+            (entry.path().extension() == ".json" || entry.path().extension() == MAZE_FILE_EXTENSION)) {
+            found.push_back(entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    HeadlessConfig config;
+    size_t jobs = 0;
+    std::string outputFile;
+    std::vector<std::string> mazeFiles;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--planner" && hasValue) {
+            if (!HeadlessRunner::parsePlannerType(argv[++i], config.planner)) {
+                std::cerr << "Unknown planner: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--dt" && hasValue) {
+            config.timeStep = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--max-time" && hasValue) {
+            config.maxSimulationTime = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--agents" && hasValue) {
+            config.crowdSize = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--jobs" && hasValue) {
+            jobs = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--output" && hasValue) {
+            outputFile = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            collectMazeFiles(arg, mazeFiles);
+        }
+    }
+
+    if (mazeFiles.empty() || config.timeStep <= 0.0f) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 没有主循环来结束帧，关闭性能面板的计时，避免多个场景线程争用它的锁
+    Profiler::shared().setEnabled(false);
+    
+    // 每个场景独立的Maze/Simulation，按文件并行运行，结果按输入顺序输出
+    HeadlessRunner runner(config);
+    std::vector<ScenarioMetrics> results(mazeFiles.size());
+    ThreadPool pool(jobs);
+    pool.parallelFor(mazeFiles.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = runner.run(mazeFiles[i]);
+        }
+    });
+
+    std::ofstream file;
+    if (!outputFile.empty()) {
+        file.open(outputFile);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open output file: " << outputFile << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputFile.empty() ? std::cout : file;
+
+    HeadlessRunner::writeCsvHeader(out);
+    size_t loaded = 0;
+    size_t reached = 0;
+    for (const ScenarioMetrics& metrics : results) {
+        runner.writeCsvRow(out, metrics);
+        loaded += metrics.loaded ? 1 : 0;
+        reached += metrics.reachedGoal ? 1 : 0;
+    }
+
+    std::cerr << reached << "/" << results.size() << " scenarios reached the goal";
+    if (loaded != results.size()) {
+        std::cerr << ", " << (results.size() - loaded) << " failed to load";
+    }
+    std::cerr << std::endl;
+    return loaded == results.size() ? 0 : 2;
+}
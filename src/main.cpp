@@ -3,6 +3,7 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -13,6 +14,14 @@ using namespace PathGlyph;
 int main(int argc, char* argv[]) {
     try {        
         PathGlyph::Application app(1000, 600, "PathGlyph");
+        
+        // --trace <file.json>：记录Chrome trace时间线，退出或按F12时写出
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--trace") {
+                app.setTraceFile(argv[i + 1]);
+            }
+        }
+        
         app.run();
         return 0;
     } catch (const std::exception& e) {
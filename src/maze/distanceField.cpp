@@ -0,0 +1,192 @@
+#include "maze/distanceField.h"
+#include "maze/occupancyGrid.h"
+#include "common/threadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr size_t COLUMN_GRAIN = 256;  // 竖直距离按列块并行，块内逐行扫描保持访问连续
+constexpr size_t ROW_GRAIN = 16;
+constexpr int PARALLEL_ROWS = 64;     // 增量更新重算的行数少于此值时不用线程池
+
+} // namespace
+
+void DistanceField::build(const OccupancyGrid& occupancy, ThreadPool* pool) {
+    width_ = occupancy.getWidth();
+    height_ = occupancy.getHeight();
+    const size_t cells = static_cast<size_t>(width_) * height_;
+    vertical_.assign(cells, NO_VERTICAL);
+    distance_.assign(cells, NO_OBSTACLE);
+    built_ = true;
+    if (cells == 0) {
+        return;
+    }
+
+    // 第一步：每列自上而下、自下而上各扫一遍，得到到同列最近占据格的竖直距离
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    const size_t blocks = (static_cast<size_t>(width_) + COLUMN_GRAIN - 1) / COLUMN_GRAIN;
+    workers.parallelFor(blocks, 1, [&](size_t begin, size_t end) {
+        const int x0 = static_cast<int>(begin * COLUMN_GRAIN);
+        const int x1 = std::min(width_, static_cast<int>(end * COLUMN_GRAIN));
+        for (int y = 0; y < height_; ++y) {
+            uint16_t* row = vertical_.data() + static_cast<size_t>(y) * width_;
+            const uint16_t* above = y > 0 ? row - width_ : nullptr;
+            for (int x = x0; x < x1; ++x) {
+                if (occupancy.isBlocked(x, y)) {
+                    row[x] = 0;
+                } else if (above && above[x] < NO_VERTICAL) {
+                    row[x] = static_cast<uint16_t>(above[x] + 1);
+                }
+            }
+        }
+        for (int y = height_ - 2; y >= 0; --y) {
+            uint16_t* row = vertical_.data() + static_cast<size_t>(y) * width_;
+            const uint16_t* below = row + width_;
+            for (int x = x0; x < x1; ++x) {
+                if (below[x] < NO_VERTICAL) {
+                    row[x] = std::min(row[x], static_cast<uint16_t>(below[x] + 1));
+                }
+            }
+        }
+    });
+
+    // 第二步：逐行求下包络
+    computeRows(0, height_ - 1, &workers);
+}
+
+void DistanceField::updateCell(const OccupancyGrid& occupancy, int x, int y) {
+    if (!built_ || x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return;
+    }
+    int firstRow = 0;
+    int lastRow = -1;
+    computeColumn(occupancy, x, firstRow, lastRow);
+    if (firstRow <= lastRow) {
+        computeRows(firstRow, lastRow, nullptr);
+    }
+}
+
+void DistanceField::clear() {
+    width_ = 0;
+    height_ = 0;
+    built_ = false;
+    vertical_.clear();
+    distance_.clear();
+}
+
+float DistanceField::getDistance(int x, int y) const {
+    if (distance_.empty()) {
+        return NO_OBSTACLE;
+    }
+    x = std::clamp(x, 0, width_ - 1);
+    y = std::clamp(y, 0, height_ - 1);
+    return distance_[static_cast<size_t>(y) * width_ + x];
+}
+
+void DistanceField::computeColumn(const OccupancyGrid& occupancy, int x, int& firstRow, int& lastRow) {
+    firstRow = height_;
+    lastRow = -1;
+    auto store = [&](int y, uint16_t value) {
+        uint16_t& cell = vertical_[static_cast<size_t>(y) * width_ + x];
+        if (cell != value) {
+            cell = value;
+            firstRow = std::min(firstRow, y);
+            lastRow = std::max(lastRow, y);
+        }
+    };
+
+    auto saturate = [](int distance) {
+        return static_cast<uint16_t>(std::min(distance, static_cast<int>(NO_VERTICAL)));
+    };
+
+    // 自上而下求到上方最近占据格的距离，再自下而上与到下方最近占据格的距离取较小值
+    columnScratch_.resize(static_cast<size_t>(height_));
+    int above = -1;
+    for (int y = 0; y < height_; ++y) {
+        if (occupancy.isBlocked(x, y)) {
+            above = y;
+        }
+        columnScratch_[y] = above < 0 ? NO_VERTICAL : saturate(y - above);
+    }
+    int below = -1;
+    for (int y = height_ - 1; y >= 0; --y) {
+        if (occupancy.isBlocked(x, y)) {
+            below = y;
+        }
+        uint16_t value = columnScratch_[y];
+        if (below >= 0) {
+            value = std::min(value, saturate(below - y));
+        }
+        store(y, value);
+    }
+}
+
+void DistanceField::computeRow(int y, std::vector<int>& site, std::vector<double>& boundary) {
+    const uint16_t* vertical = vertical_.data() + static_cast<size_t>(y) * width_;
+    float* distance = distance_.data() + static_cast<size_t>(y) * width_;
+    auto height = [&](int q) {
+        const double v = vertical[q];
+        return v * v + static_cast<double>(q) * q;
+    };
+
+    // 每个有占据格的列q贡献一条抛物线(x - q)² + vertical[q]²，求它们的下包络
+    int k = -1;
+    for (int q = 0; q < width_; ++q) {
+        if (vertical[q] == NO_VERTICAL) {
+            continue;
+        }
+        if (k < 0) {
+            k = 0;
+            site[0] = q;
+            boundary[0] = -std::numeric_limits<double>::infinity();
+            boundary[1] = std::numeric_limits<double>::infinity();
+            continue;
+        }
+        // 新抛物线与包络最右一段的交点在该段左边界之前时，该段被完全遮住
+        double s = (height(q) - height(site[k])) / (2.0 * (q - site[k]));
+        while (s <= boundary[k]) {
+            --k;
+            s = (height(q) - height(site[k])) / (2.0 * (q - site[k]));
+        }
+        ++k;
+        site[k] = q;
+        boundary[k] = s;
+        boundary[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    if (k < 0) {
+        std::fill(distance, distance + width_, NO_OBSTACLE);
+        return;
+    }
+    k = 0;
+    for (int x = 0; x < width_; ++x) {
+        while (boundary[k + 1] < x) {
+            ++k;
+        }
+        const int64_t dx = x - site[k];
+        const int64_t dy = vertical[site[k]];
+        distance[x] = static_cast<float>(std::sqrt(static_cast<double>(dx * dx + dy * dy)));
+    }
+}
+
+void DistanceField::computeRows(int firstRow, int lastRow, ThreadPool* pool) {
+    const size_t rows = static_cast<size_t>(lastRow - firstRow + 1);
+    auto body = [&](size_t begin, size_t end) {
+        std::vector<int> site(static_cast<size_t>(width_) + 1);
+        std::vector<double> boundary(static_cast<size_t>(width_) + 2);
+        for (size_t i = begin; i < end; ++i) {
+            computeRow(firstRow + static_cast<int>(i), site, boundary);
+        }
+    };
+    if (pool == nullptr && rows < PARALLEL_ROWS) {
+        body(0, rows);
+        return;
+    }
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.parallelFor(rows, ROW_GRAIN, body);
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+namespace PathGlyph {
+
+class OccupancyGrid;
+class ThreadPool;
+
+// 静态障碍物的欧氏距离场 - 每格存到最近占据格中心的距离
+// 按Felzenszwalb的可分离算法计算：先逐列求到同列最近占据格的竖直距离，
+// 再逐行对这些竖直距离求抛物线下包络。两步内部各列/各行互不依赖，整体重建时分摊到线程池。
+// 编辑一个格子只改变该列的竖直距离，以及竖直距离变化的那一段行，增量更新只重算这些部分。
+class DistanceField {
+public:
+    // 没有任何占据格时的距离
+    static constexpr float NO_OBSTACLE = std::numeric_limits<float>::max();
+
+    DistanceField() = default;
+
+    // 按占据位图整体重建，pool为空时使用共享线程池
+    void build(const OccupancyGrid& occupancy, ThreadPool* pool = nullptr);
+    // 占据位图的(x, y)改变后增量更新；尚未构建时不做任何事情
+    void updateCell(const OccupancyGrid& occupancy, int x, int y);
+    // 丢弃距离，下一次build前updateCell不做任何事情（批量编辑时先清空，结束后一次重建）
+    void clear();
+
+    bool isBuilt() const { return built_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    // 格子中心(x, y)的距离，坐标夹到地图内
+    float getDistance(int x, int y) const;
+    // 连续坐标处的距离：在相邻四个格子中心之间对距离平方做双线性插值并修正，坐标夹到地图内
+    float sample(float x, float y) const;
+    // 按行存放的距离，没有占据格时为NO_OBSTACLE
+    const std::vector<float>& getDistances() const { return distance_; }
+
+private:
+    // 竖直距离饱和值，同列没有占据格（或远于此值）
+    static constexpr uint16_t NO_VERTICAL = std::numeric_limits<uint16_t>::max();
+
+    // 重算第x列的竖直距离，返回值变化的行范围[firstRow, lastRow]，没有变化时firstRow > lastRow
+    void computeColumn(const OccupancyGrid& occupancy, int x, int& firstRow, int& lastRow);
+    // 由竖直距离计算第y行的距离，site/boundary为调用方提供的临时数组（至少width_ + 1个元素）
+    void computeRow(int y, std::vector<int>& site, std::vector<double>& boundary);
+    // 重算[firstRow, lastRow]各行，行数多时并行
+    void computeRows(int firstRow, int lastRow, ThreadPool* pool);
+
+    int width_ = 0;
+    int height_ = 0;
+    bool built_ = false;
+    std::vector<uint16_t> vertical_;  // 按行存放的竖直距离
+    std::vector<float> distance_;     // 按行存放的距离
+    std::vector<uint16_t> columnScratch_;  // 增量更新时一列的临时竖直距离
+};
+
+// DWA每个轨迹点调用一次，放在头文件中以便内联
+inline float DistanceField::sample(float x, float y) const {
+    if (distance_.empty()) {
+        return NO_OBSTACLE;
+    }
+    x = std::clamp(x, 0.0f, static_cast<float>(width_ - 1));
+    y = std::clamp(y, 0.0f, static_cast<float>(height_ - 1));
+    const int x0 = std::min(static_cast<int>(x), std::max(width_ - 2, 0));
+    const int y0 = std::min(static_cast<int>(y), std::max(height_ - 2, 0));
+    const int x1 = std::min(x0 + 1, width_ - 1);
+    const int y1 = std::min(y0 + 1, height_ - 1);
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+
+    const float d00 = distance_[static_cast<size_t>(y0) * width_ + x0];
+    const float d10 = distance_[static_cast<size_t>(y0) * width_ + x1];
+    const float d01 = distance_[static_cast<size_t>(y1) * width_ + x0];
+    const float d11 = distance_[static_cast<size_t>(y1) * width_ + x1];
+    // 有角点没有任何占据格时（整张地图为空）不插值，避免NO_OBSTACLE的平方溢出
+    if (std::max(std::max(d00, d10), std::max(d01, d11)) == NO_OBSTACLE) {
+        return std::min(std::min(d00, d10), std::min(d01, d11));
+    }
+    // 对距离平方插值：四个角的最近占据格相同时，双线性插值比真实值恰好多fx(1 - fx) + fy(1 - fy)，
+    // 减去后结果精确；最近占据格不同时误差也远小于直接对距离插值
+    const float top = d00 * d00 + (d10 * d10 - d00 * d00) * fx;
+    const float bottom = d01 * d01 + (d11 * d11 - d01 * d01) * fx;
+    const float distanceSq = top + (bottom - top) * fy - fx * (1.0f - fx) - fy * (1.0f - fy);
+    return std::sqrt(std::max(distanceSq, 0.0f));
+}
+
+} // namespace PathGlyph
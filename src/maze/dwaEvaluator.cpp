@@ -0,0 +1,296 @@
+#include "maze/dwaEvaluator.h"
+#include "maze/distanceField.h"
+#include "common/fastMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr float OUT_OF_BOUNDS_SCORE = -2000.0f;  // 比碰撞更低
+constexpr float COLLISION_SCORE = -1000.0f;
+constexpr float CLEARANCE_WEIGHT = 0.4f;
+constexpr float HEADING_WEIGHT = 0.3f;
+constexpr float PROGRESS_WEIGHT = 0.3f;
+constexpr float PROGRESS_DECAY = 10.0f;  // 距离得分e^(-d / PROGRESS_DECAY)
+constexpr float REACH_SLACK = 0.01f;     // 按距离剔除碰撞障碍物时留的余量，抵消舍入误差
+
+// 取整后是否在[0, size)内：round(v) >= 0 即 v > -0.5，round(v) < size 即 v < size - 0.5
+inline float insideSign(float value, float upper) {
+    float inside = 1.0f;
+    if (value <= -0.5f) inside = 0.0f;
+    if (value >= upper) inside = 0.0f;
+    return inside;
+}
+
+// 极坐标换算为速度分量
+void polarToCartesian(const float* __restrict speed, const float* __restrict angle, float* __restrict vx,
+                      float* __restrict vy, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float sine, cosine;
+        fastSinCos(angle[i], sine, cosine);
+        vx[i] = speed[i] * cosine;
+        vy[i] = speed[i] * sine;
+    }
+}
+
+// 终点，以及起点和终点是否都在地图内。轨迹是直线，地图范围是凸的，两端都在地图内时中间的点也在
+void computeEndpoints(const float* __restrict vx, const float* __restrict vy, float* __restrict endX,
+                      float* __restrict endY, float* __restrict inBounds, size_t count, float x0, float y0,
+                      float predictTime, float startInside, float upperX, float upperY) {
+    for (size_t i = 0; i < count; ++i) {
+        const float ex = x0 + vx[i] * predictTime;
+        const float ey = y0 + vy[i] * predictTime;
+        endX[i] = ex;
+        endY[i] = ey;
+        inBounds[i] = startInside * insideSign(ex, upperX) * insideSign(ey, upperY);
+    }
+}
+
+// 一个障碍物对所有样本在时刻t的轨迹点：更新最小距离平方
+void accumulateTrajectoryDistance(const float* __restrict vx, const float* __restrict vy,
+                                  float* __restrict minDistanceSq, size_t count, float x0, float y0, float t,
+                                  float obstacleX, float obstacleY) {
+    for (size_t i = 0; i < count; ++i) {
+        const float dx = (x0 + vx[i] * t) - obstacleX;
+        const float dy = (y0 + vy[i] * t) - obstacleY;
+        minDistanceSq[i] = std::min(minDistanceSq[i], dx * dx + dy * dy);
+    }
+}
+
+// 一个障碍物对所有终点：更新最小距离平方
+void accumulatePointDistance(const float* __restrict x, const float* __restrict y,
+                             float* __restrict minDistanceSq, size_t count, float obstacleX, float obstacleY) {
+    for (size_t i = 0; i < count; ++i) {
+        const float dx = x[i] - obstacleX;
+        const float dy = y[i] - obstacleY;
+        minDistanceSq[i] = std::min(minDistanceSq[i], dx * dx + dy * dy);
+    }
+}
+
+// 所有样本在时刻t的轨迹点：用距离场更新到静态障碍物的最小距离（逐点插值查表，不向量化）
+void accumulateFieldDistance(const DistanceField& field, const float* __restrict vx, const float* __restrict vy,
+                             float* __restrict minDistance, size_t count, float x0, float y0, float t) {
+    for (size_t i = 0; i < count; ++i) {
+        minDistance[i] = std::min(minDistance[i], field.sample(x0 + vx[i] * t, y0 + vy[i] * t));
+    }
+}
+
+// 方向得分(cos + 1) / 2和距离得分。速度为零时方向得分为NaN，该样本不会被选中
+void computeGoalTerms(const float* __restrict vx, const float* __restrict vy, const float* __restrict endX,
+                      const float* __restrict endY, float* __restrict heading, float* __restrict progress,
+                      size_t count, float goalDirX, float goalDirY, float atGoal, float targetX, float targetY) {
+    for (size_t i = 0; i < count; ++i) {
+        const float speed = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+        const float cosine = (goalDirX * vx[i] + goalDirY * vy[i]) / speed;
+        float score = (cosine + 1.0f) * 0.5f;
+        if (atGoal > 0.0f) score = 1.0f;
+        heading[i] = score;
+
+        const float dx = endX[i] - targetX;
+        const float dy = endY[i] - targetY;
+        progress[i] = fastExp(-std::sqrt(dx * dx + dy * dy) / PROGRESS_DECAY);
+    }
+}
+
+// 净空取窗口内净空障碍物与静态距离场的较小值，以及结果可能不准确的有效样本：窗口外的障碍物与终点的
+// 距离至少为window - max(|ex - x0|, |ey - y0|)，较小值不超过它时结果就是精确的
+void computeClearance(const float* __restrict endX, const float* __restrict endY,
+                      const float* __restrict inBounds, const float* __restrict collisionDistanceSq,
+                      const float* __restrict staticDistance, const float* __restrict staticClearance,
+                      float* __restrict clearance, uint8_t* __restrict needsExact, size_t count, float x0,
+                      float y0, float window, float collisionRadius) {
+    const float collisionRadiusSq = collisionRadius * collisionRadius;
+    for (size_t i = 0; i < count; ++i) {
+        const float distance = std::min(std::sqrt(clearance[i]), staticClearance[i]);
+        const float margin = window - std::max(std::abs(endX[i] - x0), std::abs(endY[i] - y0));
+        uint8_t exact = 0;
+        if (distance > margin) exact = 1;
+        if (inBounds[i] == 0.0f) exact = 0;
+        if (collisionDistanceSq[i] < collisionRadiusSq) exact = 0;
+        if (staticDistance[i] < collisionRadius) exact = 0;
+        clearance[i] = distance;
+        needsExact[i] = exact;
+    }
+}
+
+void combineScores(const float* __restrict inBounds, const float* __restrict collisionDistanceSq,
+                   const float* __restrict staticDistance, const float* __restrict clearance,
+                   const float* __restrict heading, const float* __restrict progress, float* __restrict score,
+                   size_t count, float collisionRadius) {
+    const float collisionRadiusSq = collisionRadius * collisionRadius;
+    for (size_t i = 0; i < count; ++i) {
+        float value = clearance[i] * CLEARANCE_WEIGHT + heading[i] * HEADING_WEIGHT + progress[i] * PROGRESS_WEIGHT;
+        if (collisionDistanceSq[i] < collisionRadiusSq) value = COLLISION_SCORE;
+        if (staticDistance[i] < collisionRadius) value = COLLISION_SCORE;
+        if (inBounds[i] == 0.0f) value = OUT_OF_BOUNDS_SCORE;
+        score[i] = value;
+    }
+}
+
+} // namespace
+
+void DwaEvaluator::clearSamples() {
+    velocityX_.clear();
+    velocityY_.clear();
+    polarSpeed_.clear();
+    polarAngle_.clear();
+}
+
+void DwaEvaluator::addSample(const glm::vec2& velocity) {
+    velocityX_.push_back(velocity.x);
+    velocityY_.push_back(velocity.y);
+}
+
+void DwaEvaluator::addPolarSample(float speed, float angle) {
+    polarSpeed_.push_back(speed);
+    polarAngle_.push_back(angle);
+}
+
+void DwaEvaluator::convertPolarSamples() {
+    const size_t begin = velocityX_.size();
+    const size_t count = polarSpeed_.size();
+    velocityX_.resize(begin + count);
+    velocityY_.resize(begin + count);
+    polarToCartesian(polarSpeed_.data(), polarAngle_.data(), velocityX_.data() + begin, velocityY_.data() + begin,
+                     count);
+    polarSpeed_.clear();
+    polarAngle_.clear();
+}
+
+float DwaEvaluator::getMaxSpeed() const {
+    float maxSpeedSq = 0.0f;
+    for (size_t i = 0; i < velocityX_.size(); ++i) {
+        maxSpeedSq = std::max(maxSpeedSq, velocityX_[i] * velocityX_[i] + velocityY_[i] * velocityY_[i]);
+    }
+    return std::sqrt(maxSpeedSq);
+}
+
+void DwaEvaluator::clearObstacles() {
+    collisionX_.clear();
+    collisionY_.clear();
+    clearanceX_.clear();
+    clearanceY_.clear();
+}
+
+void DwaEvaluator::addCollisionObstacle(float x, float y) {
+    collisionX_.push_back(x);
+    collisionY_.push_back(y);
+}
+
+void DwaEvaluator::addClearanceObstacle(float x, float y) {
+    clearanceX_.push_back(x);
+    clearanceY_.push_back(y);
+}
+
+void DwaEvaluator::computeTerms(const Params& params) {
+    const size_t count = getSampleCount();
+    for (auto* values : {&endX_, &endY_, &inBounds_, &clearance_, &heading_, &progress_, &score_}) {
+        values->resize(count);
+    }
+    needsExactClearance_.resize(count);
+    collisionRadius_ = params.collisionRadius;
+
+    const float x0 = params.position.x;
+    const float y0 = params.position.y;
+    const float upperX = static_cast<float>(params.width) - 0.5f;
+    const float upperY = static_cast<float>(params.height) - 0.5f;
+    const float startInside = insideSign(x0, upperX) * insideSign(y0, upperY);
+    computeEndpoints(velocityX_.data(), velocityY_.data(), endX_.data(), endY_.data(), inBounds_.data(), count,
+                     x0, y0, params.predictTime, startInside, upperX, upperY);
+
+    // 轨迹上的每个点查静态距离场，终点的值同时作为静态净空
+    staticDistance_.assign(count, std::numeric_limits<float>::max());
+    staticClearance_.assign(count, std::numeric_limits<float>::max());
+    if (params.staticField != nullptr && params.staticField->isBuilt()) {
+        const DistanceField& field = *params.staticField;
+        for (int step = 0; step < TRAJECTORY_STEPS; ++step) {
+            const float t = static_cast<float>(step) / TRAJECTORY_STEPS * params.predictTime;
+            accumulateFieldDistance(field, velocityX_.data(), velocityY_.data(), staticDistance_.data(), count,
+                                    x0, y0, t);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            staticClearance_[i] = field.sample(endX_[i], endY_[i]);
+            staticDistance_[i] = std::min(staticDistance_[i], staticClearance_[i]);
+        }
+    }
+
+    // 轨迹上的每个点对碰撞障碍物。障碍物按到当前位置的距离排序，t时刻的轨迹点离当前位置不超过maxSpeed * t，
+    // 更远的障碍物不可能碰到，每一步只检查排序后的前缀
+    sortCollisionObstacles(x0, y0);
+    const float maxSpeed = getMaxSpeed();
+    collisionDistanceSq_.assign(count, std::numeric_limits<float>::max());
+    size_t reachable = 0;
+    for (int step = 0; step <= TRAJECTORY_STEPS; ++step) {
+        const float t = static_cast<float>(step) / TRAJECTORY_STEPS * params.predictTime;
+        const float reach = maxSpeed * t + params.collisionRadius + REACH_SLACK;
+        while (reachable < sortedDistanceSq_.size() && sortedDistanceSq_[reachable] < reach * reach) {
+            ++reachable;
+        }
+        for (size_t j = 0; j < reachable; ++j) {
+            accumulateTrajectoryDistance(velocityX_.data(), velocityY_.data(), collisionDistanceSq_.data(), count,
+                                         x0, y0, t, sortedX_[j], sortedY_[j]);
+        }
+    }
+
+    // 终点对每个净空障碍物，先累计距离平方
+    std::fill(clearance_.begin(), clearance_.end(), std::numeric_limits<float>::max());
+    for (size_t j = 0; j < clearanceX_.size(); ++j) {
+        accumulatePointDistance(endX_.data(), endY_.data(), clearance_.data(), count, clearanceX_[j],
+                                clearanceY_[j]);
+    }
+    computeClearance(endX_.data(), endY_.data(), inBounds_.data(), collisionDistanceSq_.data(),
+                     staticDistance_.data(), staticClearance_.data(), clearance_.data(),
+                     needsExactClearance_.data(), count, x0, y0, params.window, collisionRadius_);
+
+    // 到目标的方向，离目标很近时方向得分固定为1
+    glm::vec2 toGoal = params.target - params.position;
+    const float goalDistance = glm::length(toGoal);
+    const float atGoal = goalDistance < 0.001f ? 1.0f : 0.0f;
+    if (atGoal == 0.0f) {
+        toGoal = glm::normalize(toGoal);
+    }
+    computeGoalTerms(velocityX_.data(), velocityY_.data(), endX_.data(), endY_.data(), heading_.data(),
+                     progress_.data(), count, toGoal.x, toGoal.y, atGoal, params.target.x, params.target.y);
+}
+
+void DwaEvaluator::sortCollisionObstacles(float x0, float y0) {
+    const size_t count = collisionX_.size();
+    order_.resize(count);
+    sortedDistanceSq_.resize(count);
+    for (size_t j = 0; j < count; ++j) {
+        const float dx = collisionX_[j] - x0;
+        const float dy = collisionY_[j] - y0;
+        sortedDistanceSq_[j] = dx * dx + dy * dy;
+        order_[j] = static_cast<uint32_t>(j);
+    }
+    std::sort(order_.begin(), order_.end(),
+              [&](uint32_t a, uint32_t b) { return sortedDistanceSq_[a] < sortedDistanceSq_[b]; });
+
+    sortedX_.resize(count);
+    sortedY_.resize(count);
+    for (size_t j = 0; j < count; ++j) {
+        sortedX_[j] = collisionX_[order_[j]];
+        sortedY_[j] = collisionY_[order_[j]];
+    }
+    std::sort(sortedDistanceSq_.begin(), sortedDistanceSq_.end());
+}
+
+size_t DwaEvaluator::selectBest() {
+    const size_t count = getSampleCount();
+    combineScores(inBounds_.data(), collisionDistanceSq_.data(), staticDistance_.data(), clearance_.data(),
+                  heading_.data(), progress_.data(), score_.data(), count, collisionRadius_);
+
+    size_t best = NONE;
+    float bestScore = -std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count; ++i) {
+        if (score_[i] > bestScore) {
+            bestScore = score_[i];
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace PathGlyph {
+
+class DistanceField;
+
+// DWA速度样本的批量评估 - 结构数组存储，缓冲跨调用复用，样本数不增长时不分配内存
+// 每个样本按恒定速度预测TRAJECTORY_STEPS + 1个轨迹点：任一点越界得-2000，任一点与碰撞障碍物的距离
+// 小于碰撞半径得-1000，否则按终点净空（到最近净空障碍物的距离）、与目标方向的一致性、终点到目标的距离加权。
+// 各项在样本维度上跑无分支的循环，编译器把它们向量化（默认SSE2，以-mavx2编译时每次8个样本）。
+// 静态障碍物由距离场给出：每个轨迹点和终点各查一次插值距离，不逐个障碍物比较。
+// 其余障碍物由调用方在以当前位置为中心、半边长window的正方形内收集；终点净空超出窗口能保证的范围时，
+// 用调用方提供的精确查询补算，结果与逐个样本检查相同。
+class DwaEvaluator {
+public:
+    static constexpr int TRAJECTORY_STEPS = 10;  // 轨迹分段数
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+    struct Params {
+        glm::vec2 position{0.0f};   // 当前位置
+        glm::vec2 target{0.0f};     // 局部目标
+        float predictTime = 0.0f;   // 轨迹预测时间（秒）
+        float collisionRadius = 0.0f;  // 轨迹点与障碍物中心的距离小于它即碰撞
+        float window = 0.0f;        // 收集障碍物的正方形半边长
+        int width = 0;              // 地图尺寸，轨迹点取整后越界即无效
+        int height = 0;
+        const DistanceField* staticField = nullptr;  // 静态障碍物距离场，为空时没有静态障碍物
+    };
+
+    void clearSamples();
+    void addSample(const glm::vec2& velocity);
+    // 按速度大小和方向添加样本：先逐个addPolarSample，再调用一次convertPolarSamples，
+    // 由一个向量化的循环换算成速度分量追加到样本末尾
+    void addPolarSample(float speed, float angle);
+    void convertPolarSamples();
+    size_t getSampleCount() const { return velocityX_.size(); }
+    glm::vec2 getSample(size_t index) const { return glm::vec2(velocityX_[index], velocityY_[index]); }
+    // 所有样本中最大的速度，调用方据此确定收集障碍物的范围
+    float getMaxSpeed() const;
+
+    // 碰撞障碍物在当前时刻检查轨迹上的每个点，净空障碍物只用于终点净空（都不含静态障碍物）
+    void clearObstacles();
+    void addCollisionObstacle(float x, float y);
+    void addClearanceObstacle(float x, float y);
+
+    // 评估所有样本，返回得分最高的样本下标（最先出现的优先），所有得分都无效（NaN）时返回NONE。
+    // exactClearance(x, y)返回终点(x, y)的精确净空，只对窗口内结果不确定的有效样本调用
+    template <typename ClearanceQuery>
+    size_t evaluate(const Params& params, ClearanceQuery&& exactClearance) {
+        computeTerms(params);
+        for (size_t i = 0; i < needsExactClearance_.size(); ++i) {
+            if (needsExactClearance_[i]) {
+                clearance_[i] = exactClearance(endX_[i], endY_[i]);
+            }
+        }
+        return selectBest();
+    }
+
+    float getScore(size_t index) const { return score_[index]; }
+
+private:
+    // 越界、碰撞、窗口内净空、方向和距离各项，以及哪些样本需要精确净空
+    void computeTerms(const Params& params);
+    // 按到(x0, y0)的距离排序碰撞障碍物，写入sorted*
+    void sortCollisionObstacles(float x0, float y0);
+    // 合成得分并选出最优样本
+    size_t selectBest();
+
+    // 样本，按下标
+    std::vector<float> velocityX_;
+    std::vector<float> velocityY_;
+    std::vector<float> polarSpeed_;   // 尚未换算的极坐标样本
+    std::vector<float> polarAngle_;
+
+    // 障碍物
+    std::vector<float> collisionX_;
+    std::vector<float> collisionY_;
+    std::vector<float> clearanceX_;
+    std::vector<float> clearanceY_;
+    std::vector<float> sortedX_;           // 按距离排序的碰撞障碍物
+    std::vector<float> sortedY_;
+    std::vector<float> sortedDistanceSq_;  // 到当前位置的距离平方，升序
+    std::vector<uint32_t> order_;
+
+    // 各项中间结果，按样本下标
+    std::vector<float> endX_;
+    std::vector<float> endY_;
+    std::vector<float> inBounds_;     // 1或0
+    std::vector<float> collisionDistanceSq_;  // 轨迹点到碰撞障碍物的最小距离平方
+    std::vector<float> staticDistance_;       // 轨迹点到静态障碍物的最小距离
+    std::vector<float> staticClearance_;      // 终点到静态障碍物的距离
+    std::vector<float> clearance_;
+    std::vector<float> heading_;      // 方向得分
+    std::vector<float> progress_;     // 距离得分
+    std::vector<float> score_;
+    std::vector<uint8_t> needsExactClearance_;
+    float collisionRadius_ = 0.0f;
+};
+
+} // namespace PathGlyph
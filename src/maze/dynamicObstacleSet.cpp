@@ -0,0 +1,203 @@
+#include "maze/dynamicObstacleSet.h"
+#include "common/fastMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace PathGlyph {
+
+namespace {
+
+struct Bounds {
+    float min;
+    float maxX;
+    float maxY;
+};
+
+// 越界时返回-1，否则返回1。写法与common/fastMath.h相同，整个循环没有分支可以向量化
+inline float bounceSign(float value, float minValue, float maxValue) {
+    float sign = 1.0f;
+    if (value <= minValue) sign = -1.0f;
+    if (value >= maxValue) sign = -1.0f;
+    return sign;
+}
+
+// 线性组：下一步越界的分量反向，再按新的速度移动
+void advanceLinear(float* __restrict x, float* __restrict y, float* __restrict vx, float* __restrict vy,
+                   size_t count, float deltaTime, Bounds bounds) {
+    for (size_t i = 0; i < count; ++i) {
+        const float nextX = x[i] + vx[i] * deltaTime;
+        const float nextY = y[i] + vy[i] * deltaTime;
+        const float newVx = vx[i] * bounceSign(nextX, bounds.min, bounds.maxX);
+        const float newVy = vy[i] * bounceSign(nextY, bounds.min, bounds.maxY);
+        vx[i] = newVx;
+        vy[i] = newVy;
+        x[i] += newVx * deltaTime;
+        y[i] += newVy * deltaTime;
+    }
+}
+
+// 圆周组：下一步越界时角速度取反，再按新的角速度转动
+void advanceCircular(float* __restrict x, float* __restrict y, const float* __restrict cx,
+                     const float* __restrict cy, const float* __restrict radius, float* __restrict angle,
+                     float* __restrict omega, size_t count, float deltaTime, Bounds bounds) {
+    for (size_t i = 0; i < count; ++i) {
+        float sine, cosine;
+        fastSinCos(angle[i] + omega[i] * deltaTime, sine, cosine);
+        const float nextX = cx[i] + radius[i] * cosine;
+        const float nextY = cy[i] + radius[i] * sine;
+        // 任一分量越界都反向，两个符号取较小值
+        const float newOmega = omega[i] * std::min(bounceSign(nextX, bounds.min, bounds.maxX),
+                                                   bounceSign(nextY, bounds.min, bounds.maxY));
+        const float newAngle = wrapPi(angle[i] + newOmega * deltaTime);
+        fastSinCos(newAngle, sine, cosine);
+        omega[i] = newOmega;
+        angle[i] = newAngle;
+        x[i] = cx[i] + radius[i] * cosine;
+        y[i] = cy[i] + radius[i] * sine;
+    }
+}
+
+template <typename T>
+void eraseAt(std::vector<T>& values, size_t index) {
+    values.erase(values.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+} // namespace
+
+void DynamicObstacleSet::setBounds(int width, int height) {
+    width_ = static_cast<float>(width);
+    height_ = static_cast<float>(height);
+}
+
+void DynamicObstacleSet::addLinear(const glm::vec2& position, float speed, const glm::vec2& direction) {
+    const float x = std::round(position.x);
+    const float y = std::round(position.y);
+    // 线性组排在前面，插入到圆周组之前
+    const auto at = static_cast<std::ptrdiff_t>(linearCount_);
+    x_.insert(x_.begin() + at, x);
+    y_.insert(y_.begin() + at, y);
+    initialX_.insert(initialX_.begin() + at, x);
+    initialY_.insert(initialY_.begin() + at, y);
+
+    velocityX_.push_back(direction.x * speed);
+    velocityY_.push_back(direction.y * speed);
+    initialVelocityX_.push_back(velocityX_.back());
+    initialVelocityY_.push_back(velocityY_.back());
+    ++linearCount_;
+}
+
+void DynamicObstacleSet::addCircular(const glm::vec2& position, const glm::vec2& center, float radius,
+                                     float angularSpeed) {
+    const float x = std::round(position.x);
+    const float y = std::round(position.y);
+    x_.push_back(x);
+    y_.push_back(y);
+    initialX_.push_back(x);
+    initialY_.push_back(y);
+
+    const float angle = std::atan2(y - center.y, x - center.x);
+    centerX_.push_back(center.x);
+    centerY_.push_back(center.y);
+    radius_.push_back(radius);
+    angle_.push_back(angle);
+    angularSpeed_.push_back(angularSpeed);
+    initialAngle_.push_back(angle);
+    initialAngularSpeed_.push_back(angularSpeed);
+}
+
+void DynamicObstacleSet::remove(size_t index) {
+    if (index >= size()) {
+        return;
+    }
+    eraseAt(x_, index);
+    eraseAt(y_, index);
+    eraseAt(initialX_, index);
+    eraseAt(initialY_, index);
+
+    if (index < linearCount_) {
+        eraseAt(velocityX_, index);
+        eraseAt(velocityY_, index);
+        eraseAt(initialVelocityX_, index);
+        eraseAt(initialVelocityY_, index);
+        --linearCount_;
+    } else {
+        const size_t local = index - linearCount_;
+        eraseAt(centerX_, local);
+        eraseAt(centerY_, local);
+        eraseAt(radius_, local);
+        eraseAt(angle_, local);
+        eraseAt(angularSpeed_, local);
+        eraseAt(initialAngle_, local);
+        eraseAt(initialAngularSpeed_, local);
+    }
+}
+
+void DynamicObstacleSet::clear() {
+    linearCount_ = 0;
+    for (auto* values : {&x_, &y_, &initialX_, &initialY_, &velocityX_, &velocityY_, &initialVelocityX_,
+                         &initialVelocityY_, &centerX_, &centerY_, &radius_, &angle_, &angularSpeed_,
+                         &initialAngle_, &initialAngularSpeed_}) {
+        values->clear();
+    }
+}
+
+void DynamicObstacleSet::reserve(size_t linearCount, size_t circularCount) {
+    for (auto* values : {&x_, &y_, &initialX_, &initialY_}) {
+        values->reserve(linearCount + circularCount);
+    }
+    for (auto* values : {&velocityX_, &velocityY_, &initialVelocityX_, &initialVelocityY_}) {
+        values->reserve(linearCount);
+    }
+    for (auto* values : {&centerX_, &centerY_, &radius_, &angle_, &angularSpeed_, &initialAngle_,
+                         &initialAngularSpeed_}) {
+        values->reserve(circularCount);
+    }
+}
+
+void DynamicObstacleSet::reset() {
+    x_ = initialX_;
+    y_ = initialY_;
+    velocityX_ = initialVelocityX_;
+    velocityY_ = initialVelocityY_;
+    angle_ = initialAngle_;
+    angularSpeed_ = initialAngularSpeed_;
+}
+
+void DynamicObstacleSet::update(float deltaTime) {
+    // 取整后越界：round(v) < 0 即 v <= -0.5，round(v) >= size 即 v >= size - 0.5
+    const Bounds bounds{-0.5f, width_ - 0.5f, height_ - 0.5f};
+    advanceLinear(x_.data(), y_.data(), velocityX_.data(), velocityY_.data(), linearCount_, deltaTime, bounds);
+    advanceCircular(x_.data() + linearCount_, y_.data() + linearCount_, centerX_.data(), centerY_.data(),
+                    radius_.data(), angle_.data(), angularSpeed_.data(), angle_.size(), deltaTime, bounds);
+}
+
+glm::vec2 DynamicObstacleSet::getPredictedPosition(size_t index, float time) const {
+    if (index < linearCount_) {
+        return glm::vec2(x_[index] + velocityX_[index] * time, y_[index] + velocityY_[index] * time);
+    }
+    const size_t local = index - linearCount_;
+    float sine, cosine;
+    fastSinCos(angle_[local] + angularSpeed_[local] * time, sine, cosine);
+    return glm::vec2(centerX_[local] + radius_[local] * cosine, centerY_[local] + radius_[local] * sine);
+}
+
+void DynamicObstacleSet::getPositions(std::vector<glm::vec2>& positions) const {
+    positions.resize(size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = glm::vec2(x_[i], y_[i]);
+    }
+}
+
+void DynamicObstacleSet::predictPositions(float time, std::vector<glm::vec2>& positions) const {
+    positions.resize(size());
+    for (size_t i = 0; i < linearCount_; ++i) {
+        positions[i] = glm::vec2(x_[i] + velocityX_[i] * time, y_[i] + velocityY_[i] * time);
+    }
+    for (size_t i = 0; i < angle_.size(); ++i) {
+        float sine, cosine;
+        fastSinCos(angle_[i] + angularSpeed_[i] * time, sine, cosine);
+        positions[linearCount_ + i] = glm::vec2(centerX_[i] + radius_[i] * cosine, centerY_[i] + radius_[i] * sine);
+    }
+}
+
+} // namespace PathGlyph
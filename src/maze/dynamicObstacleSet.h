@@ -0,0 +1,76 @@
+#pragma once
+#include "maze/obstacle.h"
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace PathGlyph {
+
+// 动态障碍物集合 - 结构数组（SoA）存储
+// 所有障碍物的当前位置存放在x_/y_两个连续数组中，线性运动的排在[0, linearCount_)，
+// 圆周运动的排在其后；两组的运动参数分别按组内下标存放。
+// update对两组各跑一个无分支的循环（越界反弹用选择代替分支，正余弦用多项式近似），
+// 编译器可以把它们自动向量化。下标在增删障碍物后会变化，不要跨编辑保存。
+class DynamicObstacleSet {
+public:
+    DynamicObstacleSet() = default;
+
+    // 地图尺寸，障碍物取整后的位置将要越界时反向运动
+    void setBounds(int width, int height);
+
+    size_t size() const { return x_.size(); }
+    bool empty() const { return x_.empty(); }
+    size_t getLinearCount() const { return linearCount_; }
+
+    // 位置取整到网格中心，与静态障碍物一致
+    void addLinear(const glm::vec2& position, float speed, const glm::vec2& direction);
+    void addCircular(const glm::vec2& position, const glm::vec2& center, float radius, float angularSpeed);
+    void remove(size_t index);
+    void clear();
+    // 为linearCount个线性运动和circularCount个圆周运动的障碍物预留所有数组的容量（总数，不是增量）
+    void reserve(size_t linearCount, size_t circularCount);
+
+    // 恢复初始位置和运动方向
+    void reset();
+    // 推进所有障碍物
+    void update(float deltaTime);
+
+    glm::vec2 getPosition(size_t index) const { return glm::vec2(x_[index], y_[index]); }
+    MovementType getMovementType(size_t index) const {
+        return index < linearCount_ ? MovementType::LINEAR : MovementType::CIRCULAR;
+    }
+    // time秒后的位置（不考虑反弹）
+    glm::vec2 getPredictedPosition(size_t index, float time) const;
+
+    // 批量导出当前位置/预测位置，positions[i]对应下标i
+    void getPositions(std::vector<glm::vec2>& positions) const;
+    void predictPositions(float time, std::vector<glm::vec2>& positions) const;
+
+private:
+    float width_ = 0.0f;
+    float height_ = 0.0f;
+    size_t linearCount_ = 0;
+
+    // 全部障碍物，按全局下标
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> initialX_;
+    std::vector<float> initialY_;
+
+    // 线性运动组，组内下标即全局下标
+    std::vector<float> velocityX_;  // 方向 * 速度
+    std::vector<float> velocityY_;
+    std::vector<float> initialVelocityX_;
+    std::vector<float> initialVelocityY_;
+
+    // 圆周运动组，组内下标为全局下标 - linearCount_
+    std::vector<float> centerX_;
+    std::vector<float> centerY_;
+    std::vector<float> radius_;
+    std::vector<float> angle_;          // 当前角度，保持在[-π, π]
+    std::vector<float> angularSpeed_;   // 弧度/秒，反弹时取反
+    std::vector<float> initialAngle_;
+    std::vector<float> initialAngularSpeed_;
+};
+
+} // namespace PathGlyph
@@ -1,234 +1,471 @@
 #include "maze.h"
-#include <fstream>
+#include "maze/mazeFile.h"
+#include "maze/mazeJson.h"
+#include "common/mappedFile.h"
+#include "common/profiler.h"
 #include <algorithm>
 #include <cmath>
 #include <limits>
 #include <iostream>
-#include <nlohmann/json.hpp>
 #include <glm/glm.hpp>
-#include <random>
-
-using json = nlohmann::json;
+#include <unordered_set>
 
 namespace PathGlyph {
 
 Maze::Maze(int width, int height)
     : width_(width), height_(height), 
-      start_(0, 0), goal_(width-1, height-1), current_(0, 0) {
+      start_(0, 0), goal_(width-1, height-1), current_(0, 0),
+      occupancy_(width, height) {
+    distanceField_.build(occupancy_);
+    dynamicObstacles_.setBounds(width_, height_);
+    rebuildDynamicHash();
 }
 
 Maze::~Maze() {
-    // 智能指针会自动处理内存清理
+    // 异步规划的作业引用着this，先取消并等待它结束；其余由智能指针自动清理
+    cancelPlan();
 }
 
-bool Maze::loadFromJson(const std::string& filename) {
-    try {
-        // 打开并解析JSON文件
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            return false;
-        }
-        
-        json data = json::parse(file);
-        
-        // 读取地图尺寸
-        if (data.contains("width") && data.contains("height")) {
-            width_ = data["width"];
-            height_ = data["height"];
-        }
-        
-        // 读取起点和终点
-        if (data.contains("start")) {
-            start_.x = data["start"][0];
-            start_.y = data["start"][1];
-            current_ = start_; // 初始化当前位置为起点
-        }
-        
-        if (data.contains("goal")) {
-            goal_.x = data["goal"][0];
-            goal_.y = data["goal"][1];
-        }
-        
-        // 读取静态障碍物
-        if (data.contains("static_obstacles")) {
-            for (const auto& obs : data["static_obstacles"]) {
-                double x = obs["x"];
-                double y = obs["y"];
-                Point position(x, y);
-                addStaticObstacle(position);
-            }
+// 流式加载时把解析器回调直接写入迷宫
+class MazeJsonLoader : public MazeJsonHandler {
+public:
+    explicit MazeJsonLoader(Maze& maze) : maze_(maze) {}
+
+    void onSize(int width, int height) override {
+        maze_.width_ = width;
+        maze_.height_ = height;
+        // 逐个加入的静态障碍物不增量更新距离场，读完后一次重建
+        maze_.rebuildOccupancy(false);
+    }
+
+    void onStart(double x, double y) override {
+        maze_.start_ = Point(x, y);
+        maze_.current_ = maze_.start_; // 初始化当前位置为起点
+    }
+
+    void onGoal(double x, double y) override {
+        maze_.goal_ = Point(x, y);
+    }
+
+    void onStaticObstacle(double x, double y) override {
+        maze_.addStaticObstacle(Point(x, y));
+    }
+
+    // 解析器在文档末尾（静态障碍物都已加入后）一次性交出动态障碍物，直接批量加入
+    void onDynamicObstacles(std::vector<MazeFileDynamicObstacle>&& obstacles) override {
+        maze_.addDynamicObstacles(obstacles.data(), obstacles.size());
+    }
+
+    void finish() {
+        if (!maze_.distanceField_.isBuilt()) {
+            maze_.distanceField_.build(maze_.occupancy_);
         }
-        
-        // 读取动态障碍物
-        if (data.contains("dynamic_obstacles")) {
-            for (const auto& obs : data["dynamic_obstacles"]) {
-                double x = obs["x"];
-                double y = obs["y"];
-                Point position(x, y);
-                MovementType moveType = obs["movement_type"].get<std::string>() == "linear" ? 
-                                      MovementType::LINEAR : MovementType::CIRCULAR;
-                
-                if (moveType == MovementType::LINEAR) {
-                    float speed = obs["speed"];
-                    glm::vec2 direction(obs["direction"][0], obs["direction"][1]);
-                    addDynamicObstacle(position, speed, direction);
-                } else {
-                    Point center(obs["center"][0], obs["center"][1]);
-                    float radius = obs["radius"];
-                    float angularSpeed = obs["angular_speed"];
-                    addDynamicObstacle(position, center, radius, angularSpeed);
-                }
-            }
+    }
+
+private:
+    Maze& maze_;
+};
+
+bool Maze::loadFromJson(const std::string& filename) {
+    cancelPlan();
+    MazeJsonLoader loader(*this);
+    std::string error;
+    if (!parseMazeJson(filename, loader, error)) {
+        std::cerr << "JSON parsing error (" << filename << "): " << error << std::endl;
+        // 已读入的部分保留，距离场仍要与占据位图一致
+        if (!distanceField_.isBuilt()) {
+            distanceField_.build(occupancy_);
         }
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
         return false;
     }
+    loader.finish();
+    return true;
+}
+
+bool Maze::loadFromBinary(const std::string& filename) {
+    cancelPlan();
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    std::string error;
+    const MazeFileHeader* header = validateMazeFile(file.data(), file.size(), error);
+    if (header == nullptr) {
+        std::cerr << "Maze file error (" << filename << "): " << error << std::endl;
+        return false;
+    }
+
+    width_ = header->width;
+    height_ = header->height;
+    occupancy_.resize(width_, height_);
+    occupancy_.assignRows(reinterpret_cast<const uint64_t*>(file.data() + header->occupancyOffset),
+                          header->wordsPerRow);
+    staticObstacles_.clear();
+    staticObstaclesStale_ = true;
+    invalidateStaticObstacles();
+
+    if (header->flags & MAZE_FILE_HAS_START) {
+        start_ = Point(header->startX, header->startY);
+        current_ = start_;
+    }
+    if (header->flags & MAZE_FILE_HAS_GOAL) {
+        goal_ = Point(header->goalX, header->goalY);
+    }
+
+    dynamicObstacles_.clear();
+    dynamicObstacles_.setBounds(width_, height_);
+    addDynamicObstacles(reinterpret_cast<const MazeFileDynamicObstacle*>(file.data() + header->dynamicOffset),
+                        header->dynamicCount);
+
+    clearPath();
+    return true;
+}
+
+bool Maze::loadFromFile(const std::string& filename) {
+    const std::string extension = MAZE_FILE_EXTENSION;
+    if (filename.size() >= extension.size() &&
+        filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0) {
+        return loadFromBinary(filename);
+    }
+    return loadFromJson(filename);
 }
 
 void Maze::setStart(const Point& position) {
     if (isInBounds(position) && !isStaticObstacle(position) && !isDynamicObstacle(position)) {
+        cancelPlan();
         start_ = position;
         current_ = start_; // 重置当前位置
-        path_.clear(); // 清除现有路径
+        clearPath(); // 清除现有路径
     }
 }
 
 void Maze::setGoal(const Point& position) {
     if (isInBounds(position) && !isStaticObstacle(position) && !isDynamicObstacle(position)) {
+        cancelPlan();
         goal_ = position;
-        path_.clear(); // 清除现有路径
+        clearPath(); // 清除现有路径
     }
 }
 
 void Maze::setPath(const std::vector<Point>& path) {
     path_ = path;
+    ++pathRevision_;
 }
 
 void Maze::clearStaticObstacles() {
+    cancelPlan();
+    staticObstacles_.clear();
+    staticObstaclesStale_ = false;
+    occupancy_.clear();
+    invalidateStaticObstacles();
+}
+
+void Maze::rebuildOccupancy(bool buildDistanceField) {
+    cancelPlan();
+    materializeStaticObstacles();
+    occupancy_.resize(width_, height_);
+    dynamicObstacles_.setBounds(width_, height_);
+    for (const auto& obstacle : staticObstacles_) {
+        Point gridPos = obstacle->getGridPosition();
+        if (isValid(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y))) {
+            occupancy_.set(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+        }
+    }
+    invalidateStaticObstacles(buildDistanceField);
+}
+
+void Maze::invalidateStaticObstacles(bool buildDistanceField) {
+    if (buildDistanceField) {
+        distanceField_.build(occupancy_);
+    } else {
+        distanceField_.clear();
+    }
+    jps_.invalidateTables();
+    dstar_.reset();
+    hpa_.invalidate();
+    ++staticRevision_;
+}
+
+void Maze::materializeStaticObstacles() const {
+    if (!staticObstaclesStale_) {
+        return;
+    }
+    staticObstaclesStale_ = false;
     staticObstacles_.clear();
+    staticObstacles_.reserve(occupancy_.countBlocked());
+    for (int y = 0; y < height_; ++y) {
+        // 整行为空时跳过逐格检查
+        if (!occupancy_.anyBlocked(0, y, width_, 1)) {
+            continue;
+        }
+        for (int x = 0; x < width_; ++x) {
+            if (occupancy_.isBlocked(x, y)) {
+                staticObstacles_.push_back(std::make_shared<StaticObstacle>(Point(x, y), width_, height_));
+            }
+        }
+    }
 }
 
 void Maze::clearDynamicObstacles() {
     dynamicObstacles_.clear();
+    rebuildDynamicHash();
 }
 
-void Maze::reset() {
-    for (auto& obstacle : dynamicObstacles_) {
-        obstacle->reset();
+void Maze::rebuildDynamicHash() {
+    // 覆盖整个地图，网格中心为整数坐标，因此向外扩半格。
+    // 每次重建都要清空所有桶，大地图上障碍物很少时按2的幂放大桶边长，使桶数与障碍物数相称
+    const double maxBuckets = std::max(DYNAMIC_HASH_MIN_BUCKETS, 4.0 * static_cast<double>(dynamicObstacles_.size()));
+    float cellSize = DYNAMIC_HASH_CELL_SIZE;
+    while ((width_ / cellSize) * (height_ / cellSize) > maxBuckets) {
+        cellSize *= 2.0f;
     }
+    dynamicHash_.configure(-0.5f, -0.5f, static_cast<float>(width_), static_cast<float>(height_), cellSize);
+    predictedHash_.configure(-0.5f, -0.5f, static_cast<float>(width_), static_cast<float>(height_), cellSize);
+    
+    dynamicObstacles_.getPositions(hashPositions_);
+    dynamicHash_.rebuild(hashPositions_);
+    
+    dynamicObstacles_.predictPositions(DWA_PREDICTION_TIME, hashPositions_);
+    predictedHash_.rebuild(hashPositions_);
+}
+
+void Maze::reset() {
+    cancelPlan();
+    dynamicObstacles_.reset();
+    rebuildDynamicHash();
     current_ = start_;
 }
 
-// 路径搜索 - 使用网格坐标系统进行规划
-std::vector<Point> Maze::findPathAStar() {
-    // 清除现有路径
-    path_.clear();
-    
-    // 定义方向数组（8个方向：上、右、下、左及四个对角线）
-    const int dx[] = {-1, -1, 0, 1, 1, 1, 0, -1};
-    const int dy[] = {0, 1, 1, 1, 0, -1, -1, -1};
-    
-    // 重新定义比较函数，用于std::shared_ptr的比较
-    auto compare = [](const std::shared_ptr<AStarNode>& a, const std::shared_ptr<AStarNode>& b) {
-        return a->f > b->f;
-    };
-    
-    // 创建优先队列，全部使用智能指针
-    std::priority_queue<std::shared_ptr<AStarNode>, 
-                         std::vector<std::shared_ptr<AStarNode>>, 
-                         decltype(compare)> openSet(compare);
-    
-    // 创建访问标记数组
-    std::vector<std::vector<bool>> visited(width_, std::vector<bool>(height_, false));
-    
-    // 创建起始节点
-    int startX = static_cast<int>(current_.x);
-    int startY = static_cast<int>(current_.y);
-    int goalX = static_cast<int>(goal_.x);
-    int goalY = static_cast<int>(goal_.y);
-    
-    auto startNode = std::make_shared<AStarNode>(
-        startX, startY, 
-        0, 
-        heuristic(startX, startY, goalX, goalY),
-        nullptr // 起始节点没有父节点
-    );
-    openSet.push(startNode);
-    
-    bool pathFound = false;
-    
-    // A*主循环
-    while (!openSet.empty()) {
-        // 获取代价最小的节点
-        auto current = openSet.top();
-        openSet.pop();
-        
-        // 检查是否到达目标
-        if (current->x == goalX && current->y == goalY) {
-            reconstructPath(current);  // 使用智能指针
-            pathFound = true;
+// 路径搜索 - 使用网格坐标系统进行规划，结果写入并返回内部路径
+const std::vector<Point>& Maze::findPathAStar() {
+    return planPath(PlannerType::ASTAR);
+}
+
+const std::vector<Point>& Maze::findPathJPS(bool usePrecomputed) {
+    return planPath(usePrecomputed ? PlannerType::JPS_PLUS : PlannerType::JPS);
+}
+
+const std::vector<Point>& Maze::findPathDStarLite() {
+    return planPath(PlannerType::DSTAR_LITE);
+}
+
+const std::vector<Point>& Maze::findPathHPA() {
+    return planPath(PlannerType::HPA_STAR);
+}
+
+const std::vector<Point>& Maze::planPath(PlannerType type) {
+    cancelPlan();
+    // 引擎复用path_的容量，未找到路径时path_为空
+    planInto(type, static_cast<int>(current_.x), static_cast<int>(current_.y),
+             static_cast<int>(goal_.x), static_cast<int>(goal_.y), path_, lastPlannerStats_, nullptr);
+    ++pathRevision_;
+    return path_;
+}
+
+bool Maze::planInto(PlannerType type, int startX, int startY, int goalX, int goalY,
+                    std::vector<Point>& outPath, PlannerStats& stats, PlanProgress* progress) {
+    bool found = false;
+    switch (type) {
+        case PlannerType::HPA_STAR:
+            found = hpa_.search(*this, startX, startY, goalX, goalY, outPath, progress);
+            stats = hpa_.getStats();
             break;
-        }
-        
-        // 标记为已访问
-        visited[current->x][current->y] = true;
-        
-        // 遍历所有可能的移动方向
-        for (int i = 0; i < 8; ++i) {
-            int newX = current->x + dx[i];
-            int newY = current->y + dy[i];
-            
-            // 检查新位置是否有效且安全
-            if (isValid(newX, newY) && isSafe(newX, newY) && !visited[newX][newY]) {
-                // 计算移动代价（对角线移动代价为1.414，垂直/水平移动代价为1.0）
-                double moveCost = (i % 2 == 0) ? 1.0 : 1.414;
-                double newG = current->g + moveCost;
-                double newH = heuristic(newX, newY, goalX, goalY);
-                
-                // 创建新节点，直接使用智能指针
-                auto neighbor = std::make_shared<AStarNode>(newX, newY, newG, newH, current);
-                
-                // 添加到开集
-                openSet.push(neighbor);
-                visited[newX][newY] = true;  // 提前标记以避免重复添加
+        case PlannerType::DSTAR_LITE:
+            found = dstar_.plan(*this, startX, startY, goalX, goalY, outPath, progress);
+            stats = dstar_.getStats();
+            break;
+        case PlannerType::JPS:
+        case PlannerType::JPS_PLUS:
+            found = jps_.search(*this, startX, startY, goalX, goalY, type == PlannerType::JPS_PLUS, outPath,
+                                progress);
+            stats = jps_.getStats();
+            break;
+        case PlannerType::FLOW_FIELD: {
+            ProfileScope zone("FlowField");
+            // 流场已经以同一目标建好时只沿方向场走一遍，不计扩展
+            bool rebuilt = false;
+            stats = PlannerStats{};
+            if (refreshFlowField(goalX, goalY, progress, rebuilt)) {
+                if (rebuilt) {
+                    stats = flowField_.getStats();
+                }
+                found = flowField_.extractPath(startX, startY, outPath, stats.pathCost);
             }
+            break;
+        }
+        case PlannerType::ASTAR:
+        default: {
+            ProfileScope zone("A*");
+            found = astar_.search(*this, startX, startY, goalX, goalY, outPath, progress);
+            stats = astar_.getStats();
+            break;
         }
     }
-    
-    return path_; // 返回生成的路径
+    return found;
 }
 
-// 更新动态障碍物
-void Maze::update(float deltaTime) {
-    for (auto& obstacle : dynamicObstacles_) {
-        obstacle->update(deltaTime);
+bool Maze::refreshFlowField(int goalX, int goalY, PlanProgress* progress, bool& rebuilt) {
+    rebuilt = false;
+    if (flowField_.isBuilt() && flowField_.getGoalX() == goalX && flowField_.getGoalY() == goalY &&
+        flowFieldRevision_ == staticRevision_) {
+        return true;
     }
+    rebuilt = true;
+    flowFieldRevision_ = staticRevision_;
+    return flowField_.build(occupancy_, goalX, goalY, nullptr, progress);
 }
 
-// 判断位置是否有静态障碍物
-bool Maze::isStaticObstacle(const Point& position) const {
-    // 检查所有静态障碍物
-    for (const auto& obstacle : staticObstacles_) {
-        if (position.distanceTo(obstacle->getGridPosition()) < 0.5) {
-            return true;
+bool Maze::isFlowFieldCurrent() const {
+    return flowField_.isBuilt() && flowFieldRevision_ == staticRevision_ &&
+           flowField_.getGoalX() == static_cast<int>(goal_.x) && flowField_.getGoalY() == static_cast<int>(goal_.y);
+}
+
+std::shared_ptr<PlanJob> Maze::submitPlan(PlannerType type, ThreadPool* pool) {
+    cancelPlan();
+    auto job = std::make_shared<PlanJob>(type, static_cast<int>(current_.x), static_cast<int>(current_.y),
+                                         static_cast<int>(goal_.x), static_cast<int>(goal_.y));
+    activePlan_ = job;
+    // 作业持有自己的引用；Maze析构前会取消并等待，因此捕获this是安全的
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.submit([this, job] {
+        const bool found = planInto(job->planner_, job->startX_, job->startY_, job->goalX_, job->goalY_,
+                                    job->path_, job->stats_, &job->progress_);
+        if (job->progress_.isCancelled()) {
+            job->finish(PlanStatus::CANCELLED);
+        } else {
+            job->finish(found ? PlanStatus::SUCCEEDED : PlanStatus::FAILED);
         }
+    });
+    return job;
+}
+
+bool Maze::acceptPlan(const PlanJob& job) {
+    // 编辑会通过cancelPlan清掉activePlan_，之后完成的旧作业不再采用
+    if (activePlan_.get() != &job) {
+        return false;
     }
-    
-    return false;
+    const PlanStatus status = job.getStatus();
+    if (status != PlanStatus::SUCCEEDED && status != PlanStatus::FAILED) {
+        return false;
+    }
+    path_ = job.getPath();
+    lastPlannerStats_ = job.getStats();
+    ++pathRevision_;
+    activePlan_.reset();
+    return true;
 }
 
-// 判断位置是否有动态障碍物
-bool Maze::isDynamicObstacle(const Point& position) const {
-    // 检查所有动态障碍物
-    for (const auto& obstacle : dynamicObstacles_) {
-        if (position.distanceTo(obstacle->getGridPosition()) < 0.5) {
-            return true;
+void Maze::cancelPlan() {
+    if (!activePlan_) {
+        return;
+    }
+    activePlan_->cancel();
+    activePlan_->wait();
+    activePlan_.reset();
+}
+
+namespace {
+
+// 只读查询的搜索数组，每个线程一份，在同一线程的多次查询间复用
+struct QueryScratch {
+    GridAStar astar;
+    JumpPointSearch jps;
+    std::vector<Point> path;  // storePath为false时的临时路径
+};
+
+QueryScratch& queryScratch() {
+    thread_local QueryScratch scratch;
+    return scratch;
+}
+
+// 批量查询时每个线程一次领取的查询数
+constexpr size_t BATCH_GRAIN = 16;
+
+} // namespace
+
+PathResult Maze::findPath(const Point& start, const Point& goal, const PathQueryOptions& options) const {
+    PathResult result;
+    findPath(start, goal, options, result);
+    return result;
+}
+
+bool Maze::findPath(const Point& start, const Point& goal, const PathQueryOptions& options,
+                    PathResult& result) const {
+    QueryScratch& scratch = queryScratch();
+    std::vector<Point>& outPath = options.storePath ? result.path : scratch.path;
+    result.path.clear();
+
+    int startX = static_cast<int>(start.x);
+    int startY = static_cast<int>(start.y);
+    int goalX = static_cast<int>(goal.x);
+    int goalY = static_cast<int>(goal.y);
+
+    switch (options.planner) {
+        case PlannerType::JPS:
+        case PlannerType::JPS_PLUS:
+            result.found = scratch.jps.search(*this, startX, startY, goalX, goalY, false, outPath);
+            result.stats = scratch.jps.getStats();
+            break;
+        default:
+            result.found = scratch.astar.search(*this, startX, startY, goalX, goalY, outPath);
+            result.stats = scratch.astar.getStats();
+            break;
+    }
+    return result.found;
+}
+
+std::vector<PathResult> Maze::findPaths(const std::vector<PathQuery>& queries,
+                                        const PathQueryOptions& options, ThreadPool* pool) const {
+    std::vector<PathResult> results(queries.size());
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    workers.parallelFor(queries.size(), BATCH_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            findPath(queries[i].start, queries[i].goal, options, results[i]);
         }
+    });
+    return results;
+}
+
+bool Maze::findCollisionFreePaths(const std::vector<PathQuery>& queries, const ConflictBasedSearch::Params& params,
+                                  std::vector<std::vector<Point>>& outPaths, ConflictBasedSearch::Stats* stats,
+                                  PlanProgress* progress) const {
+    std::vector<AgentTask> agents(queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        agents[i].startX = static_cast<int>(queries[i].start.x);
+        agents[i].startY = static_cast<int>(queries[i].start.y);
+        agents[i].goalX = static_cast<int>(queries[i].goal.x);
+        agents[i].goalY = static_cast<int>(queries[i].goal.y);
     }
-    
-    return false;
+
+    ConflictBasedSearch search;
+    const bool found = search.solve(occupancy_, agents, params, outPaths, progress);
+    if (stats) {
+        *stats = search.getStats();
+    }
+    return found;
+}
+
+// 更新动态障碍物
+void Maze::update(float deltaTime) {
+    dynamicObstacles_.update(deltaTime);
+    rebuildDynamicHash();
+}
+
+// 判断位置是否有静态障碍物 - 四舍五入到网格后查询占据位图
+bool Maze::isStaticObstacle(const Point& position) const {
+    Point gridPos = position.toInt();
+    int x = static_cast<int>(gridPos.x);
+    int y = static_cast<int>(gridPos.y);
+    return isValid(x, y) && occupancy_.isBlocked(x, y);
+}
+
+// 判断位置是否有动态障碍物
+bool Maze::isDynamicObstacle(const Point& position) const {
+    // 比较的是障碍物取整后的网格坐标，与实际位置最多相差约0.71，查询半径留足余量
+    return dynamicHash_.visitNear(position.x, position.y, 1.5f, [&](uint32_t index, const glm::vec2&) {
+        glm::vec2 obstaclePos = dynamicObstacles_.getPosition(index);
+        return position.distanceTo(Point(obstaclePos.x, obstaclePos.y).toInt()) < 0.5;
+    });
 }
 
 // 检查是否到达目标
@@ -238,20 +475,37 @@ bool Maze::hasReachedGoal() const {
 
 // 碰撞检测 - 检查点是否与任何障碍物碰撞
 bool Maze::checkCollision(const Point& pos, float radius) const {
+    const float reach = OBSTACLE_RADIUS + radius;
+    
     // 检查是否与静态障碍物碰撞
-    for (const auto& obstacle : staticObstacles_) {
-        if (obstacle->intersects(pos, radius)) {
-            return true;
-        }
+    if (hasStaticObstacleWithin(pos.x, pos.y, reach)) {
+        return true;
     }
     
-    // 检查是否与动态障碍物碰撞
-    for (const auto& obstacle : dynamicObstacles_) {
-        if (obstacle->intersects(pos, radius)) {
-            return true;
+    // 检查是否与动态障碍物碰撞（只访问附近的桶）
+    return dynamicHash_.anyWithin(pos.x, pos.y, reach);
+}
+
+bool Maze::hasStaticObstacleWithin(float x, float y, float radius) const {
+    // 静态障碍物位于整数格点上，只需检查半径覆盖的格子
+    const int x0 = std::max(0, static_cast<int>(std::ceil(x - radius)));
+    const int x1 = std::min(width_ - 1, static_cast<int>(std::floor(x + radius)));
+    const int y0 = std::max(0, static_cast<int>(std::ceil(y - radius)));
+    const int y1 = std::min(height_ - 1, static_cast<int>(std::floor(y + radius)));
+    const float radiusSq = radius * radius;
+    
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            if (!occupancy_.isBlocked(cx, cy)) {
+                continue;
+            }
+            float dx = x - cx;
+            float dy = y - cy;
+            if (dx * dx + dy * dy < radiusSq) {
+                return true;
+            }
         }
     }
-    
     return false;
 }
 
@@ -263,27 +517,8 @@ bool Maze::isValid(int x, int y) const {
 
 // 判断位置是否安全（无障碍物）
 bool Maze::isSafe(int x, int y) const {
-    // 整数坐标表示网格中心，直接作为Point使用
-    return !isStaticObstacle(Point(x, y));
-}
-
-// 启发式函数 
-double Maze::heuristic(int x1, int y1, int x2, int y2) const {
-     return std::sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
-}
-
-// 从A*节点重建路径
-void Maze::reconstructPath(std::shared_ptr<AStarNode> node) {
-    // 清除现有路径
-    path_.clear();
-    
-    // 从目标节点回溯到起始节点
-    while (node != nullptr) {
-        // 转换网格坐标为逻辑坐标（网格中心）
-        Point logicalPos = Point(node->x, node->y) ;
-        path_.insert(path_.begin(), logicalPos);
-        node = node->parent;
-    }
+    // 整数坐标表示网格中心，直接查询占据位图
+    return !occupancy_.isBlocked(x, y);
 }
 
 // 添加静态障碍物
@@ -292,12 +527,25 @@ void Maze::addStaticObstacle(const Point& position) {
         return;
     }
     
+    // 规划器状态即将改变，先停下正在进行的异步规划
+    cancelPlan();
+    
     // 创建新的静态障碍物
     auto obstacle = std::make_shared<StaticObstacle>(position, width_, height_);
-    staticObstacles_.push_back(obstacle);
+    // 对象尚未创建时只写位图，之后补建时会一并包含
+    if (!staticObstaclesStale_) {
+        staticObstacles_.push_back(obstacle);
+    }
+    Point gridPos = obstacle->getGridPosition();
+    occupancy_.set(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    distanceField_.updateCell(occupancy_, static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    jps_.updateCell(occupancy_, static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    dstar_.notifyCellChanged(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    hpa_.notifyCellChanged(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+    ++staticRevision_;
     
     // 清除现有路径（因为可能被新障碍物阻断）
-    path_.clear();
+    clearPath();
 }
 
 // 添加线性运动的动态障碍物
@@ -313,11 +561,11 @@ void Maze::addDynamicObstacle(const Point& position, float speed, glm::vec2 dire
     }
     
     // 创建新的动态障碍物(线性运动)
-    auto obstacle = std::make_shared<DynamicObstacle>(position, speed, direction, width_, height_);
-    dynamicObstacles_.push_back(obstacle);
+    dynamicObstacles_.addLinear(glm::vec2(position.x, position.y), speed, direction);
+    rebuildDynamicHash();
     
     // 清除现有路径（因为可能被新障碍物阻断）
-    path_.clear();
+    clearPath();
 }
 
 // 添加圆周运动的动态障碍物
@@ -333,16 +581,70 @@ void Maze::addDynamicObstacle(const Point& position, Point center, float radius,
     }
     
     // 创建新的动态障碍物(圆周运动)
-    auto obstacle = std::make_shared<DynamicObstacle>(position, center, radius, angularSpeed, width_, height_);
-    dynamicObstacles_.push_back(obstacle);
+    dynamicObstacles_.addCircular(glm::vec2(position.x, position.y), glm::vec2(center.x, center.y), radius, angularSpeed);
+    rebuildDynamicHash();
     
     // 清除现有路径（因为可能被新障碍物阻断）
-    path_.clear();
+    clearPath();
+}
+
+// 批量添加动态障碍物
+void Maze::addDynamicObstacles(const MazeFileDynamicObstacle* records, size_t count) {
+    // 逐个添加时每次都要重建空间哈希，这里改用已占用网格的集合检查重叠，最后只重建一次。
+    // 障碍物位置都是整数，与某点距离小于0.5的只可能是该点取整后的格子
+    auto cellKey = [](const Point& cell) {
+        return (static_cast<int64_t>(cell.x) << 32) ^ static_cast<uint32_t>(static_cast<int32_t>(cell.y));
+    };
+    std::unordered_set<int64_t> occupied;
+    occupied.reserve(dynamicObstacles_.size() + count);
+    for (size_t i = 0; i < dynamicObstacles_.size(); ++i) {
+        glm::vec2 obstaclePos = dynamicObstacles_.getPosition(i);
+        occupied.insert(cellKey(Point(obstaclePos.x, obstaclePos.y).toInt()));
+    }
+
+    // 先按文件顺序决定取舍，再分组加入，线性组整体排在圆周组之前不需要移动元素
+    std::vector<size_t> accepted;
+    accepted.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Point position(records[i].x, records[i].y);
+        if (!isInBounds(position) || isStaticObstacle(position)) {
+            continue;
+        }
+        Point cell = position.toInt();
+        if (position.distanceTo(cell) < 0.5 && !occupied.insert(cellKey(cell)).second) {
+            continue;
+        }
+        accepted.push_back(i);
+    }
+
+    const size_t linearCount = static_cast<size_t>(std::count_if(accepted.begin(), accepted.end(),
+        [&](size_t i) { return records[i].movementType == 0; }));
+    const size_t existingLinear = dynamicObstacles_.getLinearCount();
+    dynamicObstacles_.reserve(existingLinear + linearCount,
+                              dynamicObstacles_.size() - existingLinear + accepted.size() - linearCount);
+    for (size_t i : accepted) {
+        if (records[i].movementType == 0) {
+            dynamicObstacles_.addLinear(glm::vec2(records[i].x, records[i].y), records[i].speed,
+                                        glm::vec2(records[i].directionX, records[i].directionY));
+        }
+    }
+    for (size_t i : accepted) {
+        if (records[i].movementType != 0) {
+            dynamicObstacles_.addCircular(glm::vec2(records[i].x, records[i].y),
+                                          glm::vec2(records[i].centerX, records[i].centerY),
+                                          records[i].radius, records[i].angularSpeed);
+        }
+    }
+    rebuildDynamicHash();
+    clearPath();
 }
 
 // 移除障碍物
 void Maze::removeObstacle(const Point& position, double tolerance) {
+    cancelPlan();
+    
     // 移除静态障碍物
+    materializeStaticObstacles();
     for (auto it = staticObstacles_.begin(); it != staticObstacles_.end();) {
         Point obstaclePos = (*it)->getLogicalPosition();
         float dx = position.x - obstaclePos.x;
@@ -350,28 +652,34 @@ void Maze::removeObstacle(const Point& position, double tolerance) {
         float distSq = dx * dx + dy * dy;
         
         if (distSq <= tolerance * tolerance) {
+            Point gridPos = (*it)->getGridPosition();
+            occupancy_.reset(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+            distanceField_.updateCell(occupancy_, static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+            jps_.updateCell(occupancy_, static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+            dstar_.notifyCellChanged(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
+            hpa_.notifyCellChanged(static_cast<int>(gridPos.x), static_cast<int>(gridPos.y));
             it = staticObstacles_.erase(it);
+            ++staticRevision_;
         } else {
             ++it;
         }
     }
     
     // 移除动态障碍物
-    for (auto it = dynamicObstacles_.begin(); it != dynamicObstacles_.end();) {
-        Point obstaclePos = (*it)->getLogicalPosition();
+    for (size_t i = dynamicObstacles_.size(); i-- > 0;) {
+        glm::vec2 obstaclePos = dynamicObstacles_.getPosition(i);
         float dx = position.x - obstaclePos.x;
         float dy = position.y - obstaclePos.y;
         float distSq = dx * dx + dy * dy;
         
         if (distSq <= tolerance * tolerance) {
-            it = dynamicObstacles_.erase(it);
-        } else {
-            ++it;
+            dynamicObstacles_.remove(i);
         }
     }
+    rebuildDynamicHash();
     
     // 清除现有路径（因为可能需要重新计算）
-    path_.clear();
+    clearPath();
 }
 
 // 世界坐标转逻辑坐标
@@ -381,44 +689,64 @@ Point Maze::worldToLogical(const glm::vec3& worldPos) const {
 
 // DWA局部规划
 glm::vec2 Maze::findBestLocalVelocity(const Point& currentPos, const glm::vec2& currentVel, 
-                                    const Point& targetPos, float maxSpeed, float maxRotSpeed) {
-    // 生成速度空间采样
-    const int VELOCITY_SAMPLES = 20;  // 速度采样数量
-    const float PREDICTION_TIME = 2.0f; // 轨迹预测时间(秒)
-    
-    std::vector<glm::vec2> velocitySamples;
-    generateVelocitySamples(currentVel, maxSpeed, maxRotSpeed, VELOCITY_SAMPLES, velocitySamples);
-    
-    // 找到最佳速度
-    float bestScore = -std::numeric_limits<float>::max();
-    glm::vec2 bestVelocity = currentVel;
+                                    const Point& targetPos, float maxSpeed, float maxRotSpeed,
+                                    std::mt19937& random) {
+    ProfileScope zone("DWA");
+    // 生成速度空间采样，写入评估器的样本数组
+    generateVelocitySamples(currentVel, maxSpeed, maxRotSpeed, DWA_VELOCITY_SAMPLES, random);
+    
+    DwaEvaluator::Params params;
+    params.position = glm::vec2(currentPos.x, currentPos.y);
+    params.target = glm::vec2(targetPos.x, targetPos.y);
+    params.predictTime = DWA_PREDICTION_TIME;
+    params.collisionRadius = OBSTACLE_RADIUS + 0.5f;  // 与checkCollision的默认半径一致
+    params.window = dwa_.getMaxSpeed() * DWA_PREDICTION_TIME + params.collisionRadius + DWA_CLEARANCE_MARGIN;
+    params.width = width_;
+    params.height = height_;
+    params.staticField = &distanceField_;
+    gatherDwaObstacles(params.position, params.window);
+    
+    // 窗口外的动态障碍物可能更近时，用与逐点检查相同的查询补算终点净空
+    const size_t best = dwa_.evaluate(params, [this](float x, float y) {
+        return std::min(distanceField_.sample(x, y), predictedHash_.nearestDistance(x, y));
+    });
+    return best == DwaEvaluator::NONE ? currentVel : dwa_.getSample(best);
+}
+
+// 收集DWA窗口内的动态障碍物：当前位置用于碰撞，预测位置用于净空（静态障碍物由距离场负责）
+void Maze::gatherDwaObstacles(const glm::vec2& center, float window) {
+    dwa_.clearObstacles();
     
-    for (const auto& velocity : velocitySamples) {
-        float score = evaluateTrajectory(velocity, currentPos, targetPos, PREDICTION_TIME);
-        
-        if (score > bestScore) {
-            bestScore = score;
-            bestVelocity = velocity;
+    auto inWindow = [&](const glm::vec2& p) {
+        return std::abs(p.x - center.x) <= window && std::abs(p.y - center.y) <= window;
+    };
+    dynamicHash_.visitNear(center.x, center.y, window, [&](uint32_t, const glm::vec2& p) {
+        if (inWindow(p)) {
+            dwa_.addCollisionObstacle(p.x, p.y);
         }
-    }
-    
-    return bestVelocity;
+        return false;
+    });
+    predictedHash_.visitNear(center.x, center.y, window, [&](uint32_t, const glm::vec2& p) {
+        if (inWindow(p)) {
+            dwa_.addClearanceObstacle(p.x, p.y);
+        }
+        return false;
+    });
 }
 
 // 生成速度采样
 void Maze::generateVelocitySamples(const glm::vec2& currentVel, float maxSpeed, float maxRotSpeed, 
-                                 int samples, std::vector<glm::vec2>& velocitySamples) {
-    // 使用随机数生成器来采样速度空间
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> speedDist(0, maxSpeed);
-    std::uniform_real_distribution<> angleDist(-maxRotSpeed, maxRotSpeed);
+                                 int samples, std::mt19937& random) {
+    // 用调用方的随机数生成器采样速度空间，结果随种子复现
+    // 单精度分布每个值只取一次随机数，比双精度分布快一倍
+    std::uniform_real_distribution<float> speedDist(0.0f, maxSpeed);
+    std::uniform_real_distribution<float> angleDist(-maxRotSpeed, maxRotSpeed);
     
-    // 清空速度样本容器
-    velocitySamples.clear();
+    // 清空速度样本（保留容量）
+    dwa_.clearSamples();
     
     // 添加当前速度
-    velocitySamples.push_back(currentVel);
+    dwa_.addSample(currentVel);
     
     // 计算当前速度的角度
     float currentAngle = atan2(currentVel.y, currentVel.x);
@@ -427,144 +755,18 @@ void Maze::generateVelocitySamples(const glm::vec2& currentVel, float maxSpeed,
     // 生成速度样本
     for (int i = 0; i < samples; ++i) {
         // 随机调整当前速度和方向
-        float speedAdjustment = speedDist(gen);
-        float angleAdjustment = angleDist(gen);
+        float speedAdjustment = speedDist(random);
+        float angleAdjustment = angleDist(random);
         
         // 计算新速度和角度
         float speed = std::min(currentSpeed + speedAdjustment, maxSpeed);
         speed = std::max(0.1f, speed); // 确保速度不会太小
         float newAngle = currentAngle + angleAdjustment;
         
-        // 创建新的速度向量
-        glm::vec2 newVel(speed * cos(newAngle), speed * sin(newAngle));
-        velocitySamples.push_back(newVel);
-    }
-}
-
-// 评估轨迹得分
-float Maze::evaluateTrajectory(const glm::vec2& velocity, const Point& currentPos, 
-                             const Point& targetPos, float predictTime) {
-    // 距离目标的接近程度、避障能力、与目标方向的一致性
-    
-    // 1. 模拟轨迹，计算终点位置
-    float x = currentPos.x;
-    float y = currentPos.y;
-    
-    // 简单欧拉积分计算终点
-    x += velocity.x * predictTime;
-    y += velocity.y * predictTime;
-    
-    Point endPos(x, y);
-    
-    // 边界检查 - 如果终点超出边界，给予极低的评分
-    if (!isInBounds(endPos)) {
-        return -2000; // 比障碍物碰撞更低的分数
-    }
-    
-    // 收集轨迹上的点（用于检查碰撞）
-    std::vector<Point> trajectory;
-    const int steps = 10; // 轨迹分段数
-    
-    for (int i = 0; i <= steps; ++i) {
-        float t = static_cast<float>(i) / steps * predictTime;
-        float px = currentPos.x + velocity.x * t;
-        float py = currentPos.y + velocity.y * t;
-        Point predictedPos(px, py);
-        
-        // 对轨迹上的每个点也进行边界检查
-        if (!isInBounds(predictedPos)) {
-            return -2000;
-        }
-        
-        trajectory.push_back(predictedPos);
+        // 速度向量在所有样本生成后统一换算
+        dwa_.addPolarSample(speed, newAngle);
     }
-    
-    // 2. 计算各种得分
-    float obstacleScore = calculateObstacleAvoidanceScore(trajectory);
-    float directionScore = calculateGoalDirectionScore(velocity, currentPos, targetPos);
-    float distanceScore = calculateGoalDistanceScore(endPos, targetPos);
-    
-    // 如果轨迹会导致碰撞，给予极低的评分
-    if (obstacleScore < 0) {
-        return -1000;
-    }
-    
-    // 3. 综合评分（权重可调整）
-    float finalScore = obstacleScore * 0.4f + directionScore * 0.3f + distanceScore * 0.3f;
-    
-    return finalScore;
-}
-
-// 计算轨迹的避障得分
-float Maze::calculateObstacleAvoidanceScore(const std::vector<Point>& trajectory) {
-    // 判断轨迹上的点是否与当前障碍物碰撞
-    for (const auto& point : trajectory) {
-        if (checkCollision(point)) {
-            return -1000; // 如果发生碰撞，给予极低的得分
-        }
-    }
-    
-    // 计算最小距离
-    float minDistance = std::numeric_limits<float>::max();
-    const Point& endPoint = trajectory.back();
-    
-    // 检查静态障碍物
-    for (const auto& obstacle : staticObstacles_) {
-        Point obstaclePos = obstacle->getLogicalPosition();
-        float dx = endPoint.x - obstaclePos.x;
-        float dy = endPoint.y - obstaclePos.y;
-        float distSq = dx * dx + dy * dy;
-        minDistance = std::min(minDistance, static_cast<float>(sqrt(distSq)));
-    }
-    
-    // 检查动态障碍物的未来位置
-    const float PREDICTION_TIME = 2.0f; // 同evaluateTrajectory中的预测时间保持一致
-    
-    for (const auto& obstacle : dynamicObstacles_) {
-        // 获取障碍物在未来时间的预测位置
-        glm::vec3 futurePos = obstacle->getPredictedPosition(PREDICTION_TIME);
-        Point futurePosPoint(futurePos.x, futurePos.z);
-        
-        float dx = endPoint.x - futurePosPoint.x;
-        float dy = endPoint.y - futurePosPoint.y;
-        float distSq = dx * dx + dy * dy;
-        minDistance = std::min(minDistance, static_cast<float>(sqrt(distSq)));
-    }
-    
-    return minDistance;
-}
-
-// 计算轨迹的方向得分
-float Maze::calculateGoalDirectionScore(const glm::vec2& velocity, const Point& currentPos, 
-                                      const Point& targetPos) {
-    // 计算到目标的方向向量
-    glm::vec2 toGoal(targetPos.x - currentPos.x, targetPos.y - currentPos.y);
-    float goalDist = glm::length(toGoal);
-    
-    if (goalDist < 0.001f) {
-        return 1.0f; // 已经非常接近目标
-    }
-    
-    // 归一化向量
-    toGoal = glm::normalize(toGoal);
-    glm::vec2 normVelocity = glm::normalize(velocity);
-    
-    // 计算方向相似度（点积）
-    float dotProduct = glm::dot(toGoal, normVelocity);
-    
-    // 转换为[0,1]范围的得分
-    return (dotProduct + 1.0f) / 2.0f;
-}
-
-// 计算轨迹的距离得分
-float Maze::calculateGoalDistanceScore(const Point& endPos, const Point& targetPos) {
-    // 计算轨迹终点到目标的距离
-    float dx = endPos.x - targetPos.x;
-    float dy = endPos.y - targetPos.y;
-    float distance = sqrt(dx * dx + dy * dy);
-    
-    // 使用指数衰减函数计算得分，距离越近得分越高
-    return exp(-distance / 10.0f); // 调整常数以控制衰减速率
+    dwa_.convertPolarSamples();
 }
 
 } // namespace PathGlyph
\ No newline at end of file
@@ -1,38 +1,65 @@
 #pragma once
 #include "maze/obstacle.h"
 #include "common/types.h"
+#include "maze/occupancyGrid.h"
+#include "maze/spatialHash.h"
+#include "maze/dynamicObstacleSet.h"
+#include "maze/dwaEvaluator.h"
+#include "maze/distanceField.h"
+#include "maze/mazeFile.h"
+#include "planner/gridAStar.h"
+#include "planner/jumpPointSearch.h"
+#include "planner/dstarLite.h"
+#include "planner/hpaStar.h"
+#include "planner/flowField.h"
+#include "planner/conflictBasedSearch.h"
+#include "planner/planJob.h"
+#include "common/threadPool.h"
 #include <vector>
-#include <queue>
 #include <memory>
 #include <string>
+#include <random>
 #include <glm/glm.hpp>
 #include <unordered_map>
 
 namespace PathGlyph {
 
-// A*路径规划节点
-struct AStarNode {
-    int x, y;          // 保持使用整数网格坐标用于寻路
-    double g;          // 起点到当前的代价
-    double h;          // 启发式：当前到终点的估计代价
-    double f;          // f = g + h
-    std::shared_ptr<AStarNode> parent = nullptr;
-    
-    AStarNode(int x_, int y_, double g_ = 0, double h_ = 0, std::shared_ptr<AStarNode> parent_ = nullptr)
-        : x(x_), y(y_), g(g_), h(h_), f(g_ + h_), parent(parent_) {}
-        
-    bool operator>(const AStarNode& other) const {
-        return f > other.f;
-    }
+// 只读路径查询的参数
+struct PathQueryOptions {
+    // 只读查询只使用无状态的规划器：JPS_PLUS按JPS执行（跳跃表属于迷宫的可变状态），
+    // DSTAR_LITE、HPA_STAR和FLOW_FIELD按A*执行
+    PlannerType planner = PlannerType::ASTAR;
+    // 为false时只返回是否找到和统计信息，不保留逐格路径
+    bool storePath = true;
+};
+
+// 一对起点/目标
+struct PathQuery {
+    Point start;
+    Point goal;
+};
+
+// 一次只读查询的结果
+struct PathResult {
+    bool found = false;
+    std::vector<Point> path;
+    PlannerStats stats;
 };
 
 class Maze {
 public:
+    friend class MazeJsonLoader;
+
     Maze(int width = 50, int height = 50);
     ~Maze();
 
-    // 从JSON文件加载地图配置
+    // 从JSON文件加载地图配置，边解析边写入障碍物（见mazeJson.h）
     bool loadFromJson(const std::string& filename);
+    // 从二进制迷宫文件（.pgmaze，见mazeFile.h）加载，替换现有的全部障碍物；
+    // 文件以内存映射方式打开，占据位图按字整体拷入，不逐个创建静态障碍物
+    bool loadFromBinary(const std::string& filename);
+    // 按扩展名选择：.pgmaze为二进制格式，其他按JSON加载
+    bool loadFromFile(const std::string& filename);
     
     int getWidth() const { return width_; }
     int getHeight() const { return height_; }
@@ -46,8 +73,8 @@ public:
     // 设置起点和终点
     void setStart(const Point& position);
     void setGoal(const Point& position);
-    void clearStart() { start_ = Point(-1.0, -1.0); }
-    void clearGoal() { goal_ = Point(-1.0, -1.0); }
+    void clearStart() { cancelPlan(); start_ = Point(-1.0, -1.0); }
+    void clearGoal() { cancelPlan(); goal_ = Point(-1.0, -1.0); }
     
     // 位置管理
     void setCurrentPosition(const Point& pos) { current_ = pos; }
@@ -66,7 +93,7 @@ public:
     
     // 路径管理
     void setPath(const std::vector<Point>& path);
-    void clearPath() { path_.clear(); }
+    void clearPath() { path_.clear(); ++pathRevision_; }
     
     // 路径状态查询
     bool isPathFound() const { return !path_.empty(); }
@@ -81,6 +108,9 @@ public:
                gridPos.y >= 0.0 && gridPos.y < static_cast<double>(height_); 
     }
     
+    // 网格是否可通行（在地图内且没有静态障碍物），供规划器使用
+    bool isWalkable(int x, int y) const { return !occupancy_.isBlocked(x, y); }
+    
     // 障碍物检测
     bool isStaticObstacle(const Point& position) const;
     bool isDynamicObstacle(const Point& position) const;
@@ -98,19 +128,79 @@ public:
     
     
     const std::vector<Point>& getPath() const { return path_; }
-    const std::vector<std::shared_ptr<StaticObstacle>>& getStaticObstacles() const { return staticObstacles_; }
-    const std::vector<std::shared_ptr<DynamicObstacle>>& getDynamicObstacles() const { return dynamicObstacles_; }
+    
+    // 修订号 - 渲染缓存据此判断是否需要重建
+    uint64_t getStaticRevision() const { return staticRevision_; }  // 静态障碍物或地图尺寸变化时递增
+    uint64_t getPathRevision() const { return pathRevision_; }      // path_每次重新规划或清除时递增
+    // 二进制加载后静态障碍物只存在于占据位图中，第一次调用时才按位图创建对象
+    const std::vector<std::shared_ptr<StaticObstacle>>& getStaticObstacles() const {
+        materializeStaticObstacles();
+        return staticObstacles_;
+    }
+    const DynamicObstacleSet& getDynamicObstacles() const { return dynamicObstacles_; }
+    // 静态障碍物占据位图，是静态障碍物的权威来源
+    const OccupancyGrid& getOccupancy() const { return occupancy_; }
+    // 静态障碍物的欧氏距离场，随编辑增量更新，渲染器据此绘制净空热力图
+    const DistanceField& getDistanceField() const { return distanceField_; }
+    // 到最近静态障碍物中心的距离（距离场双线性插值），没有静态障碍物时返回float最大值
+    float getStaticClearance(const Point& position) const {
+        return distanceField_.sample(static_cast<float>(position.x), static_cast<float>(position.y));
+    }
     
 
     // 世界坐标向逻辑坐标的转换
     Point worldToLogical(const glm::vec3& worldPos) const;
 
-    // A*全局路径规划
-    std::vector<Point> findPathAStar();
+    // A*全局路径规划，结果写入并返回内部路径
+    const std::vector<Point>& findPathAStar();
+    // 跳点搜索全局路径规划，usePrecomputed为true时使用JPS+跳跃表
+    const std::vector<Point>& findPathJPS(bool usePrecomputed);
+    // D* Lite增量规划，保留搜索状态，只修复自上次规划以来编辑过的格子
+    const std::vector<Point>& findPathDStarLite();
+    // HPA*分层规划，抽象图随静态障碍物按簇增量重建
+    const std::vector<Point>& findPathHPA();
+    // 按指定算法进行全局路径规划
+    const std::vector<Point>& planPath(PlannerType type);
+    // 最近一次全局规划的统计信息
+    const PlannerStats& getLastPlannerStats() const { return lastPlannerStats_; }
+    // 以当前目标为根的流场，由FLOW_FIELD规划构建，目标或静态障碍物变化后下一次规划时重建。
+    // 流场有效（isBuilt()且根为当前目标）时，代理按所在格查表前进即可，不需要各自搜索
+    const FlowField& getFlowField() const { return flowField_; }
+    bool isFlowFieldCurrent() const;
+    
+    // 异步全局规划：以当前位置和目标创建作业，提交到线程池（为空时使用共享线程池）后立即返回。
+    // 作业只读写规划器状态，不修改path_，与动态障碍物的更新可以同时进行。
+    // 同一时间只有一个作业：再次提交、同步规划、修改起点/目标、编辑静态障碍物、加载和reset
+    // 都会先取消并等待当前作业。这些调用与编辑一样需要由调用方串行化
+    std::shared_ptr<PlanJob> submitPlan(PlannerType type, ThreadPool* pool = nullptr);
+    // 采用已完成的作业：写入path_（失败时为空）和统计信息。
+    // 作业仍在执行、已被取消或已被更新的编辑作废时返回false
+    bool acceptPlan(const PlanJob& job);
+    // 取消并等待当前作业
+    void cancelPlan();
     
-    // DWA局部路径规划
+    // 只读、可重入的路径查询：不修改迷宫状态（包括path_），每个线程使用自己的搜索数组，
+    // 可以在多个线程中同时调用，但调用期间不能编辑障碍物
+    PathResult findPath(const Point& start, const Point& goal, const PathQueryOptions& options = {}) const;
+    // 同上，结果写入result并复用其路径容量
+    bool findPath(const Point& start, const Point& goal, const PathQueryOptions& options,
+                  PathResult& result) const;
+    // 批量查询，分摊到线程池（为空时使用共享线程池）并行执行，结果与queries一一对应
+    std::vector<PathResult> findPaths(const std::vector<PathQuery>& queries,
+                                      const PathQueryOptions& options = {},
+                                      ThreadPool* pool = nullptr) const;
+    // 多代理规划：queries中的每一项是一个代理，为所有代理求互不冲突的路径（见conflictBasedSearch.h），
+    // outPaths[i][t]为代理i在时刻t的格子。与findPath一样只读、可重入，只考虑静态障碍物。
+    // stats非空时写入搜索统计，失败时outPaths为空
+    bool findCollisionFreePaths(const std::vector<PathQuery>& queries, const ConflictBasedSearch::Params& params,
+                                std::vector<std::vector<Point>>& outPaths,
+                                ConflictBasedSearch::Stats* stats = nullptr,
+                                PlanProgress* progress = nullptr) const;
+    
+    // DWA局部路径规划，速度采样使用random（通常是Simulation的生成器），所有样本由dwa_批量评估
     glm::vec2 findBestLocalVelocity(const Point& currentPos, const glm::vec2& currentVel, 
-                                 const Point& targetPos, float maxSpeed, float maxRotSpeed);
+                                 const Point& targetPos, float maxSpeed, float maxRotSpeed,
+                                 std::mt19937& random);
 private:
     int width_;
     int height_;
@@ -120,32 +210,66 @@ private:
     Point current_;
     
     std::vector<Point> path_;  // 规划路径
-    std::vector<std::shared_ptr<StaticObstacle>> staticObstacles_;  // 静态障碍物
-    std::vector<std::shared_ptr<DynamicObstacle>> dynamicObstacles_;  // 动态障碍物
+    uint64_t pathRevision_ = 0;
+    uint64_t staticRevision_ = 0;
+    // 静态障碍物对象，staticObstaclesStale_为true时尚未按占据位图创建
+    mutable std::vector<std::shared_ptr<StaticObstacle>> staticObstacles_;
+    mutable bool staticObstaclesStale_ = false;
+    DynamicObstacleSet dynamicObstacles_;  // 动态障碍物（结构数组）
+    OccupancyGrid occupancy_;  // 静态障碍物占据位图（每格一位）
+    DistanceField distanceField_;  // 静态障碍物距离场，与占据位图同步
+    SpatialHash dynamicHash_;    // 动态障碍物当前位置，下标对应dynamicObstacles_
+    SpatialHash predictedHash_;  // 动态障碍物在DWA预测时间后的位置
+    std::vector<glm::vec2> hashPositions_;  // 重建空间哈希时的临时数组
+    
+    GridAStar astar_;  // A*引擎，搜索数组在多次规划间复用
+    JumpPointSearch jps_;  // JPS/JPS+引擎，跳跃表随静态障碍物增量更新
+    DStarLite dstar_;      // D* Lite引擎，搜索状态跨编辑和代理移动保留
+    HPAStar hpa_;          // HPA*引擎，只重建受编辑影响的簇
+    FlowField flowField_;  // 以目标为根的流场
+    uint64_t flowFieldRevision_ = 0;  // 构建流场时的静态修订号
+    DwaEvaluator dwa_;     // DWA样本和窗口内障碍物，缓冲跨调用复用
+    PlannerStats lastPlannerStats_;
+    std::shared_ptr<PlanJob> activePlan_;  // 正在执行或尚未采用的异步规划
     
     // A*算法辅助方法
     // 检查是否在地图边界内
     bool isValid(int x, int y) const;
     // 检查是否没有静态障碍物
     bool isSafe(int x, int y) const;
-    // 计算距离
-    double heuristic(int x1, int y1, int x2, int y2) const;
-    // 通过回溯来构建完整路径
-    void reconstructPath(std::shared_ptr<AStarNode> node);
+    // 地图尺寸变化后按staticObstacles_重建占据位图；buildDistanceField为false时只清空距离场，
+    // 由调用方在批量写入后自行重建
+    void rebuildOccupancy(bool buildDistanceField = true);
+    // 批量添加动态障碍物（文件加载用），取舍与逐个调用addDynamicObstacle相同，但空间哈希只重建一次
+    void addDynamicObstacles(const MazeFileDynamicObstacle* records, size_t count);
+    // 用指定算法从(startX, startY)规划到(goalX, goalY)，不修改path_和lastPlannerStats_
+    bool planInto(PlannerType type, int startX, int startY, int goalX, int goalY,
+                  std::vector<Point>& outPath, PlannerStats& stats, PlanProgress* progress);
+    // 流场不是以(goalX, goalY)为根或静态障碍物已变化时重建，rebuilt表示是否重建了。
+    // 流场无效（目标不可达或被取消）时返回false
+    bool refreshFlowField(int goalX, int goalY, PlanProgress* progress, bool& rebuilt);
+    // 占据位图被整体替换后重建距离场（buildDistanceField为false时清空），让规划器和渲染缓存失效
+    void invalidateStaticObstacles(bool buildDistanceField = true);
+    // 按占据位图补建staticObstacles_（行优先顺序）
+    void materializeStaticObstacles() const;
+    // 动态障碍物移动或增删后重建空间哈希
+    void rebuildDynamicHash();
+    // 与(x, y)距离小于radius的静态障碍物是否存在（只检查附近的格子）
+    bool hasStaticObstacleWithin(float x, float y, float radius) const;
+    
+    static constexpr float OBSTACLE_RADIUS = 0.5f;        // 障碍物碰撞半径（半个网格单元）
+    static constexpr float DWA_PREDICTION_TIME = 2.0f;    // DWA轨迹预测时间（秒）
+    static constexpr int DWA_VELOCITY_SAMPLES = 20;       // 每次DWA的随机速度样本数（另加当前速度）
+    static constexpr float DWA_CLEARANCE_MARGIN = 4.0f;   // 障碍物收集窗口在轨迹范围外多留的距离
+    static constexpr float DYNAMIC_HASH_CELL_SIZE = 2.0f; // 动态障碍物空间哈希的桶边长
+    static constexpr double DYNAMIC_HASH_MIN_BUCKETS = 4096.0; // 桶边长开始放大前允许的桶数
     
     // DWA算法辅助方法
-    // 生成速度样本的函数。它根据当前速度、最大速度和最大旋转速度，在给定的样本数量内生成一系列可能的速度向量。
+    // 生成速度样本的函数。它根据当前速度、最大速度和最大旋转速度，在给定的样本数量内生成一系列可能的速度向量，写入dwa_。
     void generateVelocitySamples(const glm::vec2& currentVel, float maxSpeed, float maxRotSpeed, 
-                               int samples, std::vector<glm::vec2>& velocitySamples);
-    // 计算轨迹的障碍物避开分数。它评估一条轨迹避开障碍物的能力，分数越高表示轨迹越安全
-    float evaluateTrajectory(const glm::vec2& velocity, const Point& currentPos, 
-                           const Point& targetPos, float predictTime);
-    float calculateObstacleAvoidanceScore(const std::vector<Point>& trajectory);
-    // 计算目标方向分数。它评估速度向量与朝向目标方向的一致程度，分数越高表示方向越接近目标
-    float calculateGoalDirectionScore(const glm::vec2& velocity, const Point& currentPos, 
-                                    const Point& targetPos);
-    // 计算目标距离分数。它评估轨迹终点与目标位置的接近程度，分数越高表示越接近目标
-    float calculateGoalDistanceScore(const Point& endPos, const Point& targetPos);
+                               int samples, std::mt19937& random);
+    // 把以center为中心、半边长window的正方形内的障碍物交给dwa_
+    void gatherDwaObstacles(const glm::vec2& center, float window);
 };
 
 } // namespace PathGlyph
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "maze/mazeFile.h"
+#include "maze/mazeJson.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace PathGlyph {
+
+namespace {
+
+// 段从offset开始、长度为bytes时是否完整落在文件内
+bool sectionInRange(uint64_t offset, uint64_t bytes, size_t size) {
+    return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+}
+
+uint64_t alignTo8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+void MazeFileData::resize(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    occupancy.assign(static_cast<size_t>(height) * wordsPerRow(width), 0);
+}
+
+const MazeFileHeader* validateMazeFile(const unsigned char* data, size_t size, std::string& error) {
+    if (data == nullptr || size < sizeof(MazeFileHeader)) {
+        error = "file too small";
+        return nullptr;
+    }
+    const auto* header = reinterpret_cast<const MazeFileHeader*>(data);
+    if (std::memcmp(header->magic, MAZE_FILE_MAGIC, sizeof(MAZE_FILE_MAGIC)) != 0) {
+        error = "not a PathGlyph maze file";
+        return nullptr;
+    }
+    if (header->version != MAZE_FILE_VERSION || header->headerSize != sizeof(MazeFileHeader)) {
+        error = "unsupported maze file version";
+        return nullptr;
+    }
+    if (header->width <= 0 || header->height <= 0 ||
+        header->wordsPerRow != MazeFileData::wordsPerRow(header->width)) {
+        error = "invalid map size";
+        return nullptr;
+    }
+
+    uint64_t occupancyBytes = static_cast<uint64_t>(header->height) * header->wordsPerRow * sizeof(uint64_t);
+    uint64_t dynamicBytes = static_cast<uint64_t>(header->dynamicCount) * sizeof(MazeFileDynamicObstacle);
+    if (header->occupancyOffset < sizeof(MazeFileHeader) ||
+        !sectionInRange(header->occupancyOffset, occupancyBytes, size) ||
+        !sectionInRange(header->dynamicOffset, dynamicBytes, size)) {
+        error = "truncated maze file";
+        return nullptr;
+    }
+    return header;
+}
+
+bool writeMazeFile(const std::string& filename, const MazeFileData& maze) {
+    const size_t wordsPerRow = MazeFileData::wordsPerRow(maze.width);
+    if (maze.width <= 0 || maze.height <= 0 ||
+        maze.occupancy.size() != static_cast<size_t>(maze.height) * wordsPerRow) {
+        return false;
+    }
+
+    MazeFileHeader header{};
+    std::memcpy(header.magic, MAZE_FILE_MAGIC, sizeof(MAZE_FILE_MAGIC));
+    header.version = MAZE_FILE_VERSION;
+    header.headerSize = sizeof(MazeFileHeader);
+    header.width = maze.width;
+    header.height = maze.height;
+    header.flags = maze.flags;
+    header.wordsPerRow = static_cast<uint32_t>(wordsPerRow);
+    header.dynamicCount = static_cast<uint32_t>(maze.dynamicObstacles.size());
+    header.startX = maze.startX;
+    header.startY = maze.startY;
+    header.goalX = maze.goalX;
+    header.goalY = maze.goalY;
+    header.occupancyOffset = alignTo8(sizeof(MazeFileHeader));
+    header.dynamicOffset = alignTo8(header.occupancyOffset + maze.occupancy.size() * sizeof(uint64_t));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    // 各段之间的填充字节写0
+    const char padding[8] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, static_cast<std::streamsize>(header.occupancyOffset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(maze.occupancy.data()),
+               static_cast<std::streamsize>(maze.occupancy.size() * sizeof(uint64_t)));
+    file.write(padding, static_cast<std::streamsize>(
+        header.dynamicOffset - header.occupancyOffset - maze.occupancy.size() * sizeof(uint64_t)));
+    file.write(reinterpret_cast<const char*>(maze.dynamicObstacles.data()),
+               static_cast<std::streamsize>(maze.dynamicObstacles.size() * sizeof(MazeFileDynamicObstacle)));
+    return static_cast<bool>(file);
+}
+
+bool readMazeJson(const std::string& filename, MazeFileData& maze, std::string& error) {
+    // 把解析器回调写入紧凑位图
+    class Builder : public MazeJsonHandler {
+    public:
+        explicit Builder(MazeFileData& maze) : maze_(maze) {}
+
+        void onSize(int width, int height) override { maze_.resize(width, height); }
+        void onStart(double x, double y) override {
+            maze_.startX = x;
+            maze_.startY = y;
+            maze_.flags |= MAZE_FILE_HAS_START;
+        }
+        void onGoal(double x, double y) override {
+            maze_.goalX = x;
+            maze_.goalY = y;
+            maze_.flags |= MAZE_FILE_HAS_GOAL;
+        }
+        // 按Maze::addStaticObstacle的规则取整到网格，地图外的忽略
+        void onStaticObstacle(double x, double y) override {
+            x = std::round(x);
+            y = std::round(y);
+            if (x >= 0.0 && x < maze_.width && y >= 0.0 && y < maze_.height) {
+                maze_.setBlocked(static_cast<int>(x), static_cast<int>(y));
+            }
+        }
+        // 动态障碍物原样保存，加载时再经过Maze::addDynamicObstacle的检查
+        void onDynamicObstacles(std::vector<MazeFileDynamicObstacle>&& obstacles) override {
+            maze_.dynamicObstacles = std::move(obstacles);
+        }
+
+    private:
+        MazeFileData& maze_;
+    };
+
+    // 未给出尺寸时与Maze的默认尺寸一致
+    maze.resize(50, 50);
+    maze.flags = 0;
+    maze.dynamicObstacles.clear();
+    Builder builder(maze);
+    return parseMazeJson(filename, builder, error);
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace PathGlyph {
+
+// 二进制迷宫文件（.pgmaze）
+// 布局为 文件头 | 占据位图 | 动态障碍物记录，各段按8字节对齐，所有字段为小端序。
+// 占据位图按行优先存储，每行wordsPerRow个64位字，第y行第x列对应字y*wordsPerRow + x/64的第x%64位；
+// 加载时直接把映射的位图按字拷入OccupancyGrid，不需要逐个障碍物解析。
+// 用pathglyph_convert把JSON迷宫转换为此格式。
+constexpr char MAZE_FILE_MAGIC[8] = {'P', 'G', 'M', 'A', 'Z', 'E', '\0', '\0'};
+constexpr uint32_t MAZE_FILE_VERSION = 1;
+constexpr const char* MAZE_FILE_EXTENSION = ".pgmaze";
+
+enum MazeFileFlags : uint32_t {
+    MAZE_FILE_HAS_START = 1u << 0,
+    MAZE_FILE_HAS_GOAL = 1u << 1,
+};
+
+struct MazeFileHeader {
+    char magic[8];
+    uint32_t version;        // 大端机器上读出的版本号不匹配，加载会直接失败
+    uint32_t headerSize;     // sizeof(MazeFileHeader)
+    int32_t width;
+    int32_t height;
+    uint32_t flags;          // MazeFileFlags
+    uint32_t wordsPerRow;    // (width + 63) / 64
+    uint32_t dynamicCount;
+    uint32_t reserved;
+    double startX;
+    double startY;
+    double goalX;
+    double goalY;
+    uint64_t occupancyOffset;  // 占据位图相对文件开头的偏移
+    uint64_t dynamicOffset;    // 动态障碍物记录相对文件开头的偏移
+};
+static_assert(sizeof(MazeFileHeader) == 88, "MazeFileHeader layout must stay fixed");
+
+struct MazeFileDynamicObstacle {
+    uint32_t movementType;   // 0为线性运动，1为圆周运动
+    float speed;             // 线性运动速度
+    double x;
+    double y;
+    float directionX;        // 线性运动方向
+    float directionY;
+    float radius;            // 圆周运动半径
+    float angularSpeed;      // 圆周运动角速度（弧度/秒）
+    double centerX;          // 圆周运动中心
+    double centerY;
+};
+static_assert(sizeof(MazeFileDynamicObstacle) == 56, "MazeFileDynamicObstacle layout must stay fixed");
+
+// 写文件前在内存中组装的迷宫内容
+struct MazeFileData {
+    int width = 0;
+    int height = 0;
+    uint32_t flags = 0;
+    double startX = 0.0;
+    double startY = 0.0;
+    double goalX = 0.0;
+    double goalY = 0.0;
+    std::vector<uint64_t> occupancy;  // height * wordsPerRow个字
+    std::vector<MazeFileDynamicObstacle> dynamicObstacles;
+
+    static size_t wordsPerRow(int width) { return (static_cast<size_t>(width) + 63) / 64; }
+    // 按宽高分配空位图
+    void resize(int newWidth, int newHeight);
+    void setBlocked(int x, int y) {
+        occupancy[static_cast<size_t>(y) * wordsPerRow(width) + static_cast<size_t>(x >> 6)] |=
+            uint64_t(1) << (x & 63);
+    }
+};
+
+// 检查映射的文件内容，各段都在文件范围内时返回文件头，否则返回nullptr并写出原因
+const MazeFileHeader* validateMazeFile(const unsigned char* data, size_t size, std::string& error);
+
+// 写出二进制迷宫文件，失败时返回false
+bool writeMazeFile(const std::string& filename, const MazeFileData& maze);
+
+// 读取JSON迷宫（格式同Maze::loadFromJson）并组装为二进制文件内容
+bool readMazeJson(const std::string& filename, MazeFileData& maze, std::string& error);
+
+} // namespace PathGlyph
@@ -0,0 +1,377 @@
+#include "maze/mazeJson.h"
+#include <fstream>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace PathGlyph {
+
+namespace {
+
+// 根对象中的键
+enum class Section { OTHER, WIDTH, HEIGHT, START, GOAL, STATIC_OBSTACLES, DYNAMIC_OBSTACLES };
+
+// 障碍物对象中的键
+enum class Field { OTHER, X, Y, MOVEMENT_TYPE, SPEED, DIRECTION, CENTER, RADIUS, ANGULAR_SPEED };
+
+enum FieldBits : uint32_t {
+    HAS_X = 1u << 0,
+    HAS_Y = 1u << 1,
+    HAS_MOVEMENT_TYPE = 1u << 2,
+    HAS_SPEED = 1u << 3,
+    HAS_DIRECTION = 1u << 4,
+    HAS_CENTER = 1u << 5,
+    HAS_RADIUS = 1u << 6,
+    HAS_ANGULAR_SPEED = 1u << 7,
+};
+
+Section sectionOf(const std::string& key) {
+    if (key == "width") return Section::WIDTH;
+    if (key == "height") return Section::HEIGHT;
+    if (key == "start") return Section::START;
+    if (key == "goal") return Section::GOAL;
+    if (key == "static_obstacles") return Section::STATIC_OBSTACLES;
+    if (key == "dynamic_obstacles") return Section::DYNAMIC_OBSTACLES;
+    return Section::OTHER;
+}
+
+Field fieldOf(const std::string& key) {
+    if (key == "x") return Field::X;
+    if (key == "y") return Field::Y;
+    if (key == "movement_type") return Field::MOVEMENT_TYPE;
+    if (key == "speed") return Field::SPEED;
+    if (key == "direction") return Field::DIRECTION;
+    if (key == "center") return Field::CENTER;
+    if (key == "radius") return Field::RADIUS;
+    if (key == "angular_speed") return Field::ANGULAR_SPEED;
+    return Field::OTHER;
+}
+
+// 嵌套深度：根对象内为1，start/goal和障碍物数组内为2，障碍物对象内为3，direction/center数组内为4。
+// 不关心的键对应的容器整体跳过，其中的值不做检查。
+class MazeJsonSax {
+public:
+    using number_integer_t = json::number_integer_t;
+    using number_unsigned_t = json::number_unsigned_t;
+    using number_float_t = json::number_float_t;
+    using string_t = json::string_t;
+    using binary_t = json::binary_t;
+
+    MazeJsonSax(MazeJsonHandler& handler, std::string& error) : handler_(handler), error_(error) {}
+
+    bool null() { return scalar("null"); }
+    bool boolean(bool) { return scalar("boolean"); }
+    bool number_integer(number_integer_t value) { return number(static_cast<double>(value)); }
+    bool number_unsigned(number_unsigned_t value) { return number(static_cast<double>(value)); }
+    bool number_float(number_float_t value, const string_t&) { return number(value); }
+    bool binary(binary_t&) { return scalar("binary"); }
+
+    bool string(string_t& value) {
+        if (skipDepth_ != 0) {
+            return true;
+        }
+        if (depth_ == 3 && field_ == Field::MOVEMENT_TYPE) {
+            if (value == "linear") {
+                obstacle_.movementType = 0;
+            } else if (value == "circular") {
+                obstacle_.movementType = 1;
+            } else {
+                return fail(obstacleContext() + ": unknown movement_type \"" + value + "\"");
+            }
+            fields_ |= HAS_MOVEMENT_TYPE;
+            return true;
+        }
+        return scalar("string");
+    }
+
+    bool start_object(std::size_t) {
+        if (skipDepth_ != 0 || (depth_ == 1 && section_ == Section::OTHER) ||
+            (depth_ == 3 && field_ == Field::OTHER)) {
+            return skip();
+        }
+        if (depth_ == 0) {
+            depth_ = 1;
+            return true;
+        }
+        if (depth_ == 2 && isObstacleSection()) {
+            obstacle_ = MazeFileDynamicObstacle{};
+            fields_ = 0;
+            field_ = Field::OTHER;
+            depth_ = 3;
+            return true;
+        }
+        return fail(context() + ": unexpected object");
+    }
+
+    bool end_object() {
+        if (skipDepth_ != 0) {
+            return leaveSkipped();
+        }
+        if (depth_ == 3) {
+            depth_ = 2;
+            return finishObstacle();
+        }
+        depth_ = 0;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if (skipDepth_ != 0 || (depth_ == 1 && section_ == Section::OTHER) ||
+            (depth_ == 3 && field_ == Field::OTHER)) {
+            return skip();
+        }
+        if (depth_ == 1 && (section_ == Section::START || section_ == Section::GOAL || isObstacleSection())) {
+            vectorCount_ = 0;
+            obstacleIndex_ = 0;
+            depth_ = 2;
+            return true;
+        }
+        if (depth_ == 3 && (field_ == Field::DIRECTION || field_ == Field::CENTER)) {
+            vectorCount_ = 0;
+            depth_ = 4;
+            return true;
+        }
+        return fail(context() + ": unexpected array");
+    }
+
+    bool end_array() {
+        if (skipDepth_ != 0) {
+            return leaveSkipped();
+        }
+        if (depth_ == 4) {
+            depth_ = 3;
+            if (vectorCount_ < 2) {
+                return fail(context() + ": expected two numbers");
+            }
+            if (field_ == Field::DIRECTION) {
+                obstacle_.directionX = static_cast<float>(vector_[0]);
+                obstacle_.directionY = static_cast<float>(vector_[1]);
+                fields_ |= HAS_DIRECTION;
+            } else {
+                obstacle_.centerX = vector_[0];
+                obstacle_.centerY = vector_[1];
+                fields_ |= HAS_CENTER;
+            }
+            return true;
+        }
+        // depth_ == 2
+        depth_ = 1;
+        if (section_ == Section::START || section_ == Section::GOAL) {
+            if (vectorCount_ < 2) {
+                return fail(context() + ": expected two numbers");
+            }
+            if (section_ == Section::START) {
+                handler_.onStart(vector_[0], vector_[1]);
+            } else {
+                handler_.onGoal(vector_[0], vector_[1]);
+            }
+        }
+        return true;
+    }
+
+    bool key(string_t& key) {
+        if (skipDepth_ != 0) {
+            return true;
+        }
+        if (depth_ == 1) {
+            sectionKey_ = key;
+            section_ = sectionOf(key);
+        } else if (depth_ == 3) {
+            fieldKey_ = key;
+            field_ = fieldOf(key);
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) {
+        // 异常信息中已包含行列号
+        error_ = ex.what();
+        return false;
+    }
+
+    // 文档读完后补发尺寸之前缓存的静态障碍物，再交出全部动态障碍物
+    void finish() {
+        flushPendingStatic();
+        if (!dynamicObstacles_.empty()) {
+            handler_.onDynamicObstacles(std::move(dynamicObstacles_));
+        }
+    }
+
+private:
+    bool isObstacleSection() const {
+        return section_ == Section::STATIC_OBSTACLES || section_ == Section::DYNAMIC_OBSTACLES;
+    }
+
+    std::string obstacleContext() const {
+        return sectionKey_ + "[" + std::to_string(obstacleIndex_) + "]";
+    }
+
+    std::string context() const {
+        if (depth_ == 0) {
+            return "root";
+        }
+        if (depth_ >= 3) {
+            return obstacleContext() + "." + fieldKey_;
+        }
+        return "\"" + sectionKey_ + "\"";
+    }
+
+    bool fail(const std::string& message) {
+        error_ = message;
+        return false;
+    }
+
+    bool skip() {
+        ++depth_;
+        if (skipDepth_ == 0) {
+            skipDepth_ = depth_;
+        }
+        return true;
+    }
+
+    bool leaveSkipped() {
+        if (depth_ == skipDepth_) {
+            skipDepth_ = 0;
+        }
+        --depth_;
+        return true;
+    }
+
+    // 不关心的键的标量值直接忽略，已知键上出现错误类型时报错
+    bool scalar(const char* type) {
+        if (skipDepth_ != 0 || (depth_ == 1 && section_ == Section::OTHER) ||
+            (depth_ == 3 && field_ == Field::OTHER)) {
+            return true;
+        }
+        return fail(context() + ": unexpected " + type);
+    }
+
+    bool number(double value) {
+        if (skipDepth_ != 0) {
+            return true;
+        }
+        if (depth_ == 1 && (section_ == Section::WIDTH || section_ == Section::HEIGHT)) {
+            (section_ == Section::WIDTH ? width_ : height_) = static_cast<int>(value);
+            if (width_ && height_ && !sizeKnown_) {
+                if (*width_ <= 0 || *height_ <= 0) {
+                    return fail("width and height must be positive");
+                }
+                sizeKnown_ = true;
+                handler_.onSize(*width_, *height_);
+                flushPendingStatic();
+            }
+            return true;
+        }
+        if ((depth_ == 2 && (section_ == Section::START || section_ == Section::GOAL)) || depth_ == 4) {
+            if (vectorCount_ < 2) {
+                vector_[vectorCount_] = value;
+            }
+            ++vectorCount_;
+            return true;
+        }
+        if (depth_ == 3) {
+            switch (field_) {
+            case Field::X: obstacle_.x = value; fields_ |= HAS_X; return true;
+            case Field::Y: obstacle_.y = value; fields_ |= HAS_Y; return true;
+            case Field::SPEED: obstacle_.speed = static_cast<float>(value); fields_ |= HAS_SPEED; return true;
+            case Field::RADIUS: obstacle_.radius = static_cast<float>(value); fields_ |= HAS_RADIUS; return true;
+            case Field::ANGULAR_SPEED:
+                obstacle_.angularSpeed = static_cast<float>(value);
+                fields_ |= HAS_ANGULAR_SPEED;
+                return true;
+            case Field::OTHER: return true;
+            default: break;
+            }
+        }
+        return scalar("number");
+    }
+
+    bool finishObstacle() {
+        const std::string where = obstacleContext();
+        ++obstacleIndex_;
+        if ((fields_ & (HAS_X | HAS_Y)) != (HAS_X | HAS_Y)) {
+            return fail(where + ": missing \"x\" or \"y\"");
+        }
+
+        if (section_ == Section::STATIC_OBSTACLES) {
+            // 尺寸未知时先缓存，保证越界判断使用文件中的尺寸
+            if (sizeKnown_) {
+                handler_.onStaticObstacle(obstacle_.x, obstacle_.y);
+            } else {
+                pendingStatic_.emplace_back(obstacle_.x, obstacle_.y);
+            }
+            return true;
+        }
+
+        if (!(fields_ & HAS_MOVEMENT_TYPE)) {
+            return fail(where + ": missing \"movement_type\"");
+        }
+        const uint32_t required = obstacle_.movementType == 0
+            ? (HAS_SPEED | HAS_DIRECTION)
+            : (HAS_CENTER | HAS_RADIUS | HAS_ANGULAR_SPEED);
+        if ((fields_ & required) != required) {
+            return fail(where + (obstacle_.movementType == 0
+                ? ": linear obstacle needs \"speed\" and \"direction\""
+                : ": circular obstacle needs \"center\", \"radius\" and \"angular_speed\""));
+        }
+        dynamicObstacles_.push_back(obstacle_);
+        return true;
+    }
+
+    void flushPendingStatic() {
+        for (const auto& [x, y] : pendingStatic_) {
+            handler_.onStaticObstacle(x, y);
+        }
+        pendingStatic_.clear();
+        pendingStatic_.shrink_to_fit();
+    }
+
+    MazeJsonHandler& handler_;
+    std::string& error_;
+
+    int depth_ = 0;
+    int skipDepth_ = 0;  // 正在跳过的容器所在深度，0表示没有在跳过
+    Section section_ = Section::OTHER;
+    Field field_ = Field::OTHER;
+    std::string sectionKey_;
+    std::string fieldKey_;
+
+    double vector_[2] = {0.0, 0.0};  // 正在读取的[x, y]
+    int vectorCount_ = 0;
+
+    MazeFileDynamicObstacle obstacle_{};  // 正在读取的障碍物
+    uint32_t fields_ = 0;                 // FieldBits
+    size_t obstacleIndex_ = 0;
+
+    std::optional<int> width_;
+    std::optional<int> height_;
+    bool sizeKnown_ = false;
+    std::vector<std::pair<double, double>> pendingStatic_;
+    std::vector<MazeFileDynamicObstacle> dynamicObstacles_;
+};
+
+} // namespace
+
+bool parseMazeJson(std::istream& input, MazeJsonHandler& handler, std::string& error) {
+    MazeJsonSax sax(handler, error);
+    // 严格模式：根值之后不允许有多余内容
+    if (!json::sax_parse(input, &sax, json::input_format_t::json, true)) {
+        return false;
+    }
+    sax.finish();
+    return true;
+}
+
+bool parseMazeJson(const std::string& filename, MazeJsonHandler& handler, std::string& error) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    return parseMazeJson(file, handler, error);
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,34 @@
+#pragma once
+#include "maze/mazeFile.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace PathGlyph {
+
+// 流式读取JSON迷宫时的回调
+// 解析器保证onSize（文件中同时给出width和height时）先于所有onStaticObstacle调用，
+// 动态障碍物在文件读完后一次性交给onDynamicObstacles，与按DOM读取时先静态后动态的顺序一致；
+// 回调可以直接接管数组，不必再复制一份。
+class MazeJsonHandler {
+public:
+    virtual ~MazeJsonHandler() = default;
+
+    virtual void onSize(int width, int height) = 0;
+    virtual void onStart(double x, double y) = 0;
+    virtual void onGoal(double x, double y) = 0;
+    virtual void onStaticObstacle(double x, double y) = 0;
+    virtual void onDynamicObstacles(std::vector<MazeFileDynamicObstacle>&& obstacles) = 0;
+};
+
+// 以SAX方式解析JSON迷宫，边读边回调，不在内存中构建整个文档。
+// 格式：{"width", "height", "start": [x, y], "goal": [x, y],
+//        "static_obstacles": [{"x", "y"}],
+//        "dynamic_obstacles": [{"x", "y", "movement_type": "linear", "speed", "direction": [x, y]} |
+//                              {"x", "y", "movement_type": "circular", "center": [x, y], "radius", "angular_speed"}]}
+// 未知的键被忽略。失败时error给出语法错误的行列号，或出错的键和障碍物下标；
+// 出错前已经回调的内容不会撤销。
+bool parseMazeJson(std::istream& input, MazeJsonHandler& handler, std::string& error);
+bool parseMazeJson(const std::string& filename, MazeJsonHandler& handler, std::string& error);
+
+} // namespace PathGlyph
@@ -0,0 +1,106 @@
+#include "maze/occupancyGrid.h"
+#include <algorithm>
+#include <bit>
+
+namespace PathGlyph {
+
+void OccupancyGrid::resize(int width, int height) {
+    width_ = std::max(0, width);
+    height_ = std::max(0, height);
+    // 左右各一列边界格
+    stride_ = (static_cast<size_t>(width_) + 2 + 63) / 64;
+    clear();
+}
+
+void OccupancyGrid::clear() {
+    words_.assign(stride_ * (static_cast<size_t>(height_) + 2), 0);
+
+    // 上下边界行全部置位
+    const int paddedWidth = width_ + 2;
+    for (int px = 0; px < paddedWidth; ++px) {
+        words_[wordIndex(px, 0)] |= bitMask(px);
+        words_[wordIndex(px, height_ + 1)] |= bitMask(px);
+    }
+    // 左右边界列置位
+    for (int py = 1; py <= height_; ++py) {
+        words_[wordIndex(0, py)] |= bitMask(0);
+        words_[wordIndex(width_ + 1, py)] |= bitMask(width_ + 1);
+    }
+}
+
+bool OccupancyGrid::anyBlocked(int x0, int y0, int w, int h) const {
+    if (w <= 0 || h <= 0) {
+        return false;
+    }
+    // 块的任何部分落在地图外都视为占据
+    if (x0 < 0 || y0 < 0 || x0 + w > width_ || y0 + h > height_) {
+        return true;
+    }
+
+    for (int py = y0 + 1; py <= y0 + h; ++py) {
+        for (int px = x0 + 1, remaining = w; remaining > 0; ) {
+            int count = std::min(remaining, 64);
+            if (rowBits(px, py, count) != 0) {
+                return true;
+            }
+            px += count;
+            remaining -= count;
+        }
+    }
+    return false;
+}
+
+size_t OccupancyGrid::countBlocked() const {
+    size_t count = 0;
+    for (uint64_t word : words_) {
+        count += static_cast<size_t>(std::popcount(word));
+    }
+    // 扣除边界格
+    size_t border = 2 * (static_cast<size_t>(width_) + 2) + 2 * static_cast<size_t>(height_);
+    return count - border;
+}
+
+void OccupancyGrid::assignRows(const uint64_t* rows, size_t wordsPerRow) {
+    const size_t packedWords = packedWordsPerRow(width_);
+    const uint64_t lastMask = (width_ & 63) ? (uint64_t(1) << (width_ & 63)) - 1 : ~uint64_t(0);
+
+    // padded行比紧凑行整体右移一位（第0位是左边界格），逐字移位拼接
+    for (int y = 0; y < height_; ++y) {
+        const uint64_t* src = rows + static_cast<size_t>(y) * wordsPerRow;
+        uint64_t* dst = &words_[wordIndex(0, y + 1)];
+        uint64_t carry = 0;
+        for (size_t k = 0; k < stride_; ++k) {
+            uint64_t word = 0;
+            if (k < packedWords) {
+                word = k + 1 == packedWords ? src[k] & lastMask : src[k];
+            }
+            dst[k] = (word << 1) | carry;
+            carry = word >> 63;
+        }
+        dst[0] |= bitMask(0);
+        words_[wordIndex(width_ + 1, y + 1)] |= bitMask(width_ + 1);
+    }
+}
+
+void OccupancyGrid::copyRows(uint64_t* rows, size_t wordsPerRow) const {
+    const size_t packedWords = packedWordsPerRow(width_);
+    const uint64_t lastMask = (width_ & 63) ? (uint64_t(1) << (width_ & 63)) - 1 : ~uint64_t(0);
+
+    for (int y = 0; y < height_; ++y) {
+        const uint64_t* src = &words_[wordIndex(0, y + 1)];
+        uint64_t* dst = rows + static_cast<size_t>(y) * wordsPerRow;
+        for (size_t k = 0; k < wordsPerRow; ++k) {
+            if (k >= packedWords) {
+                dst[k] = 0;
+                continue;
+            }
+            uint64_t word = src[k] >> 1;
+            if (k + 1 < stride_) {
+                word |= src[k + 1] << 63;
+            }
+            dst[k] = k + 1 == packedWords ? word & lastMask : word;
+        }
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathGlyph {
+
+// 静态占据位图 - 每个网格一位
+// 内部四周各多存一圈恒为占据的边界格，邻域查询不需要再做边界判断。
+// 每行按64位字对齐存储，单格查询、八邻域查询和矩形块查询都归结为字级位运算。
+class OccupancyGrid {
+public:
+    OccupancyGrid() = default;
+    OccupancyGrid(int width, int height) { resize(width, height); }
+
+    // 重新分配并清空（边界格除外）
+    void resize(int width, int height);
+    // 清除所有占据
+    void clear();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    // 地图外的格子一律视为占据
+    bool isBlocked(int x, int y) const {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(width_) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(height_)) {
+            return true;
+        }
+        return testPadded(x + 1, y + 1);
+    }
+
+    // 设置/清除单格占据，调用方保证坐标在地图内
+    void set(int x, int y) { words_[wordIndex(x + 1, y + 1)] |= bitMask(x + 1); }
+    void reset(int x, int y) { words_[wordIndex(x + 1, y + 1)] &= ~bitMask(x + 1); }
+
+    // 八邻域占据掩码，第i位对应方向(GRID_DX[i], GRID_DY[i])，(x, y)必须在地图内
+    uint8_t neighborMask(int x, int y) const {
+        const int px = x + 1;
+        const int py = y + 1;
+        uint32_t below = static_cast<uint32_t>(rowBits(px - 1, py - 1, 3));
+        uint32_t middle = static_cast<uint32_t>(rowBits(px - 1, py, 3));
+        uint32_t above = static_cast<uint32_t>(rowBits(px - 1, py + 1, 3));
+        return static_cast<uint8_t>(
+            ((middle & 1u))            |  // (-1,  0)
+            ((above & 1u) << 1)        |  // (-1, +1)
+            (((above >> 1) & 1u) << 2) |  // ( 0, +1)
+            (((above >> 2) & 1u) << 3) |  // (+1, +1)
+            (((middle >> 2) & 1u) << 4)|  // (+1,  0)
+            (((below >> 2) & 1u) << 5) |  // (+1, -1)
+            (((below >> 1) & 1u) << 6) |  // ( 0, -1)
+            ((below & 1u) << 7));         // (-1, -1)
+    }
+
+    // 矩形块[x0, x0+w) x [y0, y0+h)内是否存在占据，超出地图的部分视为占据
+    // 每行至多64格时只需一次掩码运算
+    bool anyBlocked(int x0, int y0, int w, int h) const;
+
+    // 已占据的格子数量
+    size_t countBlocked() const;
+
+    // 紧凑位图的每行字数：行优先，第x列对应第x/64个字的第x%64位，不含边界格
+    static size_t packedWordsPerRow(int width) { return (static_cast<size_t>(width) + 63) / 64; }
+    // 用紧凑位图整体替换占据（每行wordsPerRow >= packedWordsPerRow(width)个字），超出宽度的位被忽略
+    void assignRows(const uint64_t* rows, size_t wordsPerRow);
+    // 把占据导出为紧凑位图，每行wordsPerRow个字，多余的字填0
+    void copyRows(uint64_t* rows, size_t wordsPerRow) const;
+
+private:
+    size_t wordIndex(int px, int py) const {
+        return static_cast<size_t>(py) * stride_ + static_cast<size_t>(px >> 6);
+    }
+    static uint64_t bitMask(int px) { return uint64_t(1) << (px & 63); }
+    bool testPadded(int px, int py) const { return (words_[wordIndex(px, py)] & bitMask(px)) != 0; }
+
+    // 取出padded行py中从px开始的count(<=64)位，低位对应px
+    uint64_t rowBits(int px, int py, int count) const {
+        size_t index = wordIndex(px, py);
+        int shift = px & 63;
+        uint64_t bits = words_[index] >> shift;
+        if (shift != 0 && shift + count > 64) {
+            bits |= words_[index + 1] << (64 - shift);
+        }
+        return count >= 64 ? bits : bits & ((uint64_t(1) << count) - 1);
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    size_t stride_ = 0;            // 每个padded行的字数
+    std::vector<uint64_t> words_;  // (height_ + 2)行，每行stride_个字
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,97 @@
+#include "maze/spatialHash.h"
+
+namespace PathGlyph {
+
+void SpatialHash::configure(float minX, float minY, float width, float height, float cellSize) {
+    if (minX == minX_ && minY == minY_ && width == width_ && height == height_ && cellSize == cellSize_) {
+        return;
+    }
+    minX_ = minX;
+    minY_ = minY;
+    width_ = width;
+    height_ = height;
+    cellSize_ = std::max(cellSize, 1e-3f);
+    inverseCellSize_ = 1.0f / cellSize_;
+    bucketsX_ = std::max(1, static_cast<int>(std::ceil(width_ * inverseCellSize_)));
+    bucketsY_ = std::max(1, static_cast<int>(std::ceil(height_ * inverseCellSize_)));
+
+    bucketStart_.assign(static_cast<size_t>(bucketsX_) * bucketsY_ + 1, 0);
+    items_.clear();
+    positions_.clear();
+}
+
+void SpatialHash::rebuild(const std::vector<glm::vec2>& positions) {
+    const size_t bucketCount = static_cast<size_t>(bucketsX_) * bucketsY_;
+    std::fill(bucketStart_.begin(), bucketStart_.end(), 0);
+
+    // 计数排序：先统计每个桶的元素数，前缀和得到起始位置，再把元素放进去
+    bucketOf_.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        uint32_t bucket = static_cast<uint32_t>(bucketY(positions[i].y) * bucketsX_ + bucketX(positions[i].x));
+        bucketOf_[i] = bucket;
+        ++bucketStart_[bucket + 1];
+    }
+    for (size_t b = 0; b < bucketCount; ++b) {
+        bucketStart_[b + 1] += bucketStart_[b];
+    }
+
+    items_.resize(positions.size());
+    positions_.resize(positions.size());
+    // 借用bucketStart_[b]作为写指针，填完后它变成桶b+1的起点，最后整体右移一位还原
+    for (size_t i = 0; i < positions.size(); ++i) {
+        uint32_t slot = bucketStart_[bucketOf_[i]]++;
+        items_[slot] = static_cast<uint32_t>(i);
+        positions_[slot] = positions[i];
+    }
+    for (size_t b = bucketCount; b > 0; --b) {
+        bucketStart_[b] = bucketStart_[b - 1];
+    }
+    bucketStart_[0] = 0;
+}
+
+float SpatialHash::nearestDistance(float x, float y) const {
+    float bestSq = std::numeric_limits<float>::max();
+    if (positions_.empty()) {
+        return bestSq;
+    }
+
+    auto scanBucket = [&](int bx, int by) {
+        const size_t bucket = static_cast<size_t>(by) * bucketsX_ + bx;
+        for (uint32_t k = bucketStart_[bucket]; k < bucketStart_[bucket + 1]; ++k) {
+            float dx = positions_[k].x - x;
+            float dy = positions_[k].y - y;
+            bestSq = std::min(bestSq, dx * dx + dy * dy);
+        }
+    };
+
+    // 以查询点所在桶为中心逐圈向外扫描
+    const int qx = bucketX(x);
+    const int qy = bucketY(y);
+    const int maxRing = std::max(std::max(qx, bucketsX_ - 1 - qx), std::max(qy, bucketsY_ - 1 - qy));
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        const int x0 = qx - ring;
+        const int x1 = qx + ring;
+        for (int by = std::max(qy - ring, 0); by <= std::min(qy + ring, bucketsY_ - 1); ++by) {
+            if (by == qy - ring || by == qy + ring) {
+                for (int bx = std::max(x0, 0); bx <= std::min(x1, bucketsX_ - 1); ++bx) {
+                    scanBucket(bx, by);
+                }
+            } else {
+                if (x0 >= 0) {
+                    scanBucket(x0, by);
+                }
+                if (ring > 0 && x1 < bucketsX_) {
+                    scanBucket(x1, by);
+                }
+            }
+        }
+        // 更外圈的元素与查询点的距离至少为ring个桶宽
+        float bound = ring * cellSize_;
+        if (bestSq <= bound * bound) {
+            break;
+        }
+    }
+    return std::sqrt(bestSq);
+}
+
+} // namespace PathGlyph
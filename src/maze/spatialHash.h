@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/glm.hpp>
+
+namespace PathGlyph {
+
+// 均匀网格空间哈希 - 用于动态障碍物的邻近查询
+// 覆盖一个固定矩形区域，超出区域的元素归入最近的边缘桶（查询时同样夹到边缘，结果仍然正确）。
+// 每次rebuild用计数排序把元素按桶连续存放，查询只访问与查询圆相交的桶。
+class SpatialHash {
+public:
+    SpatialHash() = default;
+
+    // 设置覆盖区域[minX, minX + width) x [minY, minY + height)和桶边长，参数不变时不做任何事情
+    void configure(float minX, float minY, float width, float height, float cellSize);
+
+    // 重建，positions[i]为元素i的位置
+    void rebuild(const std::vector<glm::vec2>& positions);
+
+    size_t size() const { return positions_.size(); }
+    bool empty() const { return positions_.empty(); }
+
+    // 对可能落在圆(x, y, radius)内的元素调用visit(index, position)
+    // visit返回true时停止遍历并返回true
+    template <typename Visitor>
+    bool visitNear(float x, float y, float radius, Visitor&& visit) const {
+        if (positions_.empty()) {
+            return false;
+        }
+        const int bx0 = bucketX(x - radius);
+        const int bx1 = bucketX(x + radius);
+        const int by0 = bucketY(y - radius);
+        const int by1 = bucketY(y + radius);
+        for (int by = by0; by <= by1; ++by) {
+            for (int bx = bx0; bx <= bx1; ++bx) {
+                const size_t bucket = static_cast<size_t>(by) * bucketsX_ + bx;
+                for (uint32_t k = bucketStart_[bucket]; k < bucketStart_[bucket + 1]; ++k) {
+                    if (visit(items_[k], positions_[k])) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // 是否有元素与(x, y)的距离小于radius
+    bool anyWithin(float x, float y, float radius) const {
+        const float radiusSq = radius * radius;
+        return visitNear(x, y, radius, [&](uint32_t, const glm::vec2& p) {
+            float dx = p.x - x;
+            float dy = p.y - y;
+            return dx * dx + dy * dy < radiusSq;
+        });
+    }
+
+    // 最近元素的距离，没有元素时返回float最大值
+    float nearestDistance(float x, float y) const;
+
+private:
+    int bucketX(float x) const {
+        return std::clamp(static_cast<int>(std::floor((x - minX_) * inverseCellSize_)), 0, bucketsX_ - 1);
+    }
+    int bucketY(float y) const {
+        return std::clamp(static_cast<int>(std::floor((y - minY_) * inverseCellSize_)), 0, bucketsY_ - 1);
+    }
+
+    float minX_ = 0.0f;
+    float minY_ = 0.0f;
+    float width_ = 0.0f;
+    float height_ = 0.0f;
+    float cellSize_ = 1.0f;
+    float inverseCellSize_ = 1.0f;
+    int bucketsX_ = 1;
+    int bucketsY_ = 1;
+
+    std::vector<uint32_t> bucketStart_ = std::vector<uint32_t>(2, 0);  // 桶b的元素为[bucketStart_[b], bucketStart_[b+1])
+    std::vector<uint32_t> items_;          // 按桶排序后的元素下标
+    std::vector<glm::vec2> positions_;     // 与items_对应的位置
+    std::vector<uint32_t> bucketOf_;       // 重建时的临时数组
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,642 @@
+#include "planner/conflictBasedSearch.h"
+#include "planner/planJob.h"
+#include "maze/occupancyGrid.h"
+#include "common/threadPool.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <unordered_set>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr double COST_EPSILON = 1e-6;
+
+uint64_t vertexKey(int32_t cell, int32_t time) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(time)) << 32) | static_cast<uint32_t>(cell);
+}
+
+// 出发格和方向确定一条边，时刻为到达时刻
+uint64_t edgeKey(int32_t from, int direction, int32_t time) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(time)) << 35) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(from)) << 3) | static_cast<uint64_t>(direction);
+}
+
+double stepCost(int direction) {
+    // 等待与直线移动一样占用一个时间步
+    return (direction >= 0 && (direction & 1)) ? DIAGONAL_COST : STRAIGHT_COST;
+}
+
+// 按八邻域（允许切角，与单代理规划相同）标记连通分量，-1为占据格
+void labelComponents(const OccupancyGrid& occupancy, std::vector<int32_t>& labels) {
+    const int width = occupancy.getWidth();
+    const int height = occupancy.getHeight();
+    labels.assign(static_cast<size_t>(width) * height, -1);
+    std::vector<int32_t> stack;
+    int32_t component = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int32_t seed = y * width + x;
+            if (labels[seed] >= 0 || occupancy.isBlocked(x, y)) {
+                continue;
+            }
+            labels[seed] = component;
+            stack.push_back(seed);
+            while (!stack.empty()) {
+                const int32_t cell = stack.back();
+                stack.pop_back();
+                const int cx = cell % width;
+                const int cy = cell / width;
+                const uint8_t blocked = occupancy.neighborMask(cx, cy);
+                for (int d = 0; d < 8; ++d) {
+                    const int32_t next = (cy + GRID_DY[d]) * width + cx + GRID_DX[d];
+                    if (!(blocked & (1u << d)) && labels[next] < 0) {
+                        labels[next] = component;
+                        stack.push_back(next);
+                    }
+                }
+            }
+            ++component;
+        }
+    }
+}
+
+// 从goal出发的Dijkstra，distances为各格到goal的最短距离（移动可逆，正反向代价相同），不可达为无穷大
+void computeDistances(const OccupancyGrid& occupancy, int32_t goal, std::vector<double>& distances) {
+    const int width = occupancy.getWidth();
+    distances.assign(static_cast<size_t>(width) * occupancy.getHeight(), std::numeric_limits<double>::infinity());
+    using Entry = std::pair<double, int32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    distances[goal] = 0.0;
+    queue.push({0.0, goal});
+    while (!queue.empty()) {
+        const auto [distance, cell] = queue.top();
+        queue.pop();
+        if (distance > distances[cell]) {
+            continue;
+        }
+        const int cx = cell % width;
+        const int cy = cell / width;
+        const uint8_t blocked = occupancy.neighborMask(cx, cy);
+        for (int d = 0; d < 8; ++d) {
+            if (blocked & (1u << d)) {
+                continue;
+            }
+            const int32_t next = (cy + GRID_DY[d]) * width + cx + GRID_DX[d];
+            const double candidate = distance + stepCost(d);
+            if (candidate < distances[next]) {
+                distances[next] = candidate;
+                queue.push({candidate, next});
+            }
+        }
+    }
+}
+
+} // namespace
+
+// 一个线程的临时数据：低层搜索状态、预约表和冲突检测数组，跨搜索复用容量
+struct ConflictBasedSearch::Scratch {
+    struct LowNode {
+        int32_t cell;
+        int32_t time;
+        double g;
+        double f;
+        uint32_t conflicts;  // 从起点到此与其他代理的冲突数
+        int32_t parent;
+        bool closed;
+        bool inFocal;
+    };
+
+    // 焦点表：冲突少者优先，其次f小、g大（更靠近目标）
+    struct FocalKey {
+        uint32_t conflicts;
+        double f;
+        double g;
+        int32_t id;
+        bool operator<(const FocalKey& other) const {
+            if (conflicts != other.conflicts) return conflicts < other.conflicts;
+            if (f != other.f) return f < other.f;
+            if (g != other.g) return g > other.g;
+            return id < other.id;
+        }
+    };
+
+    // 其他代理路径的预约表
+    std::unordered_map<uint64_t, uint16_t> reservedVertices;  // (格子, 时刻)，只含到达目标之前
+    std::unordered_map<uint64_t, uint16_t> reservedEdges;     // (出发格, 方向, 到达时刻)
+    std::unordered_map<int32_t, int32_t> parked;              // 目标格 -> 开始停留的时刻
+    int32_t reservationHorizon = 0;                           // 最晚的到达时刻
+
+    std::unordered_set<uint64_t> vertexConstraints;
+    std::unordered_set<uint64_t> edgeConstraints;
+    std::vector<Constraint> constraints;
+
+    std::vector<LowNode> nodes;
+    std::unordered_map<uint64_t, int32_t> nodeIndex;  // (格子, 合并后的时刻) -> nodes的下标
+    std::set<std::pair<double, int32_t>> open;
+    std::set<FocalKey> focal;
+
+    std::vector<uint32_t> stamp;  // 冲突检测：等于generation表示本时刻已有代理
+    std::vector<int32_t> owner;
+    uint32_t generation = 0;
+
+    void clearReservations() {
+        reservedVertices.clear();
+        reservedEdges.clear();
+        parked.clear();
+        reservationHorizon = 0;
+    }
+
+    void reserve(const std::vector<int32_t>& cells, int width) {
+        const int32_t arrival = static_cast<int32_t>(cells.size()) - 1;
+        for (int32_t t = 0; t < arrival; ++t) {
+            ++reservedVertices[vertexKey(cells[t], t)];
+            const int32_t from = cells[t];
+            const int32_t to = cells[t + 1];
+            if (from != to) {
+                const int direction = directionIndex(to % width - from % width, to / width - from / width);
+                ++reservedEdges[edgeKey(from, direction, t + 1)];
+            }
+        }
+        parked[cells.back()] = arrival;
+        reservationHorizon = std::max(reservationHorizon, arrival);
+    }
+
+    // 从cell沿direction（-1为等待）在time时刻到达next时与其他代理的冲突数
+    uint32_t countReserved(int32_t cell, int32_t next, int direction, int32_t time) const {
+        uint32_t count = 0;
+        if (time <= reservationHorizon) {
+            auto vertex = reservedVertices.find(vertexKey(next, time));
+            if (vertex != reservedVertices.end()) {
+                count += vertex->second;
+            }
+        }
+        auto stay = parked.find(next);
+        if (stay != parked.end() && time >= stay->second) {
+            ++count;
+        }
+        if (direction < 0 || time > reservationHorizon) {
+            return count;
+        }
+        // 对向互换：有代理同一步从next走到cell
+        auto swap = reservedEdges.find(edgeKey(next, (direction + 4) & 7, time));
+        if (swap != reservedEdges.end()) {
+            count += swap->second;
+        }
+        // 对角交叉：有代理同一步走另一条对角线
+        if (direction & 1) {
+            const int dx = GRID_DX[direction];
+            const int dy = GRID_DY[direction];
+            auto cross = reservedEdges.find(edgeKey(cell + dx, directionIndex(-dx, dy), time));
+            if (cross != reservedEdges.end()) {
+                count += cross->second;
+            }
+        }
+        return count;
+    }
+
+    // 时空A*（suboptimality > 1时为焦点搜索），在约束下为task规划，路径写入out。
+    // distances为空时启发值用八方向距离
+    bool plan(const OccupancyGrid& occupancy, const AgentTask& task, const std::vector<double>* distances,
+              double suboptimality, AgentPath& out, size_t& expanded);
+
+    void pushNode(int32_t id, double bound) {
+        LowNode& node = nodes[id];
+        open.insert({node.f, id});
+        node.inFocal = node.f <= bound;
+        if (node.inFocal) {
+            focal.insert({node.conflicts, node.f, node.g, id});
+        }
+    }
+};
+
+bool ConflictBasedSearch::Scratch::plan(const OccupancyGrid& occupancy, const AgentTask& task,
+                                        const std::vector<double>* distances, double suboptimality,
+                                        AgentPath& out, size_t& expanded) {
+    const int width = occupancy.getWidth();
+    const int32_t start = task.startY * width + task.startX;
+    const int32_t goal = task.goalY * width + task.goalX;
+
+    vertexConstraints.clear();
+    edgeConstraints.clear();
+    int32_t earliestFinish = 0;   // 目标格上最晚的顶点约束之后才能停下
+    int32_t lastConstraint = 0;
+    for (const Constraint& constraint : constraints) {
+        if (constraint.from < 0) {
+            vertexConstraints.insert(vertexKey(constraint.cell, constraint.time));
+            if (constraint.cell == goal) {
+                earliestFinish = std::max(earliestFinish, constraint.time + 1);
+            }
+        } else {
+            const int direction = directionIndex(constraint.cell % width - constraint.from % width,
+                                                 constraint.cell / width - constraint.from / width);
+            edgeConstraints.insert(edgeKey(constraint.from, direction, constraint.time));
+        }
+        lastConstraint = std::max(lastConstraint, constraint.time);
+    }
+    // 此后没有约束，预约只剩停在目标上的代理，时刻不再影响搜索
+    const int32_t horizon = std::max(lastConstraint, reservationHorizon) + 1;
+
+    nodes.clear();
+    nodeIndex.clear();
+    open.clear();
+    focal.clear();
+    auto heuristic = [&](int32_t cell) {
+        return distances ? (*distances)[cell] : octileDistance(cell % width, cell / width, task.goalX, task.goalY);
+    };
+
+    nodes.push_back({start, 0, 0.0, heuristic(start), 0, -1, false, false});
+    nodeIndex.emplace(vertexKey(start, 0), 0);
+    double bound = -1.0;
+    pushNode(0, bound);
+
+    while (!open.empty()) {
+        // 下界上升时把新进入范围的节点加入焦点表
+        const double minF = open.begin()->first;
+        const double newBound = minF * suboptimality + COST_EPSILON;
+        if (newBound > bound) {
+            for (auto it = open.upper_bound({bound, std::numeric_limits<int32_t>::max()});
+                 it != open.end() && it->first <= newBound; ++it) {
+                LowNode& node = nodes[it->second];
+                if (!node.inFocal) {
+                    node.inFocal = true;
+                    focal.insert({node.conflicts, node.f, node.g, it->second});
+                }
+            }
+            bound = newBound;
+        }
+
+        const int32_t id = focal.begin()->id;
+        focal.erase(focal.begin());
+        LowNode current = nodes[id];
+        open.erase({current.f, id});
+        nodes[id].inFocal = false;
+        nodes[id].closed = true;
+        ++expanded;
+
+        if (current.cell == goal && current.time >= earliestFinish) {
+            out.cells.clear();
+            for (int32_t at = id; at >= 0; at = nodes[at].parent) {
+                out.cells.push_back(nodes[at].cell);
+            }
+            std::reverse(out.cells.begin(), out.cells.end());
+            out.cost = current.g;
+            out.lowerBound = std::min(minF, current.g);
+            return true;
+        }
+
+        const int cx = current.cell % width;
+        const int cy = current.cell / width;
+        const uint8_t blocked = occupancy.neighborMask(cx, cy);
+        const int32_t time = current.time + 1;
+        const int32_t keyTime = std::min(time, horizon);
+        for (int direction = -1; direction < 8; ++direction) {
+            if (direction >= 0 && (blocked & (1u << direction))) {
+                continue;
+            }
+            const int32_t next = direction < 0
+                ? current.cell : (cy + GRID_DY[direction]) * width + cx + GRID_DX[direction];
+            if (time <= lastConstraint) {
+                if (vertexConstraints.count(vertexKey(next, time)) ||
+                    (direction >= 0 && edgeConstraints.count(edgeKey(current.cell, direction, time)))) {
+                    continue;
+                }
+            }
+            const double g = current.g + stepCost(direction);
+            const uint32_t conflicts = current.conflicts + countReserved(current.cell, next, direction, time);
+
+            auto [slot, inserted] = nodeIndex.try_emplace(vertexKey(next, keyTime), static_cast<int32_t>(nodes.size()));
+            if (inserted) {
+                nodes.push_back({next, time, g, g + heuristic(next), conflicts, id, false, false});
+                pushNode(slot->second, bound);
+                continue;
+            }
+            LowNode& node = nodes[slot->second];
+            // 更短的代价总是更新（已关闭的重新打开）；代价相同时只为尚未关闭的节点换成冲突更少的父节点
+            const bool better = g < node.g - COST_EPSILON ||
+                                (!node.closed && g <= node.g + COST_EPSILON && conflicts < node.conflicts);
+            if (!better) {
+                continue;
+            }
+            if (!node.closed) {
+                open.erase({node.f, slot->second});
+                if (node.inFocal) {
+                    focal.erase({node.conflicts, node.f, node.g, slot->second});
+                }
+            }
+            node.time = time;
+            node.g = g;
+            node.f = g + heuristic(next);
+            node.conflicts = conflicts;
+            node.parent = id;
+            node.closed = false;
+            pushNode(slot->second, bound);
+        }
+    }
+    return false;
+}
+
+ConflictBasedSearch::ConflictBasedSearch() = default;
+ConflictBasedSearch::~ConflictBasedSearch() = default;
+
+bool ConflictBasedSearch::solve(const OccupancyGrid& occupancy, const std::vector<AgentTask>& agents,
+                                const Params& params, std::vector<std::vector<Point>>& outPaths,
+                                PlanProgress* progress) {
+    stats_ = Stats{};
+    outPaths.clear();
+    nodes_.clear();
+    occupancy_ = &occupancy;
+    agents_ = agents;
+    suboptimality_ = std::max(params.suboptimality, 1.0);
+    width_ = occupancy.getWidth();
+    if (agents.empty()) {
+        return true;
+    }
+
+    // 起点和目标必须空闲且互不相同（两个代理不可能停在同一个目标上），并且在同一个连通分量中
+    std::unordered_set<int32_t> starts;
+    std::unordered_set<int32_t> goals;
+    for (const AgentTask& task : agents) {
+        if (occupancy.isBlocked(task.startX, task.startY) || occupancy.isBlocked(task.goalX, task.goalY) ||
+            !starts.insert(task.startY * width_ + task.startX).second ||
+            !goals.insert(task.goalY * width_ + task.goalX).second) {
+            return false;
+        }
+    }
+    std::vector<int32_t> components;
+    labelComponents(occupancy, components);
+    for (const AgentTask& task : agents) {
+        if (components[task.startY * width_ + task.startX] != components[task.goalY * width_ + task.goalX]) {
+            return false;
+        }
+    }
+
+    // 各代理的距离表互相独立，并行计算
+    distances_.clear();
+    const size_t cellCount = static_cast<size_t>(width_) * occupancy.getHeight();
+    ThreadPool& workers = params.pool ? *params.pool : ThreadPool::shared();
+    if (agents.size() * cellCount <= DISTANCE_TABLE_LIMIT) {
+        distances_.resize(agents.size());
+        workers.parallelFor(agents.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                computeDistances(occupancy, agents[i].goalY * width_ + agents[i].goalX, distances_[i]);
+            }
+        });
+    }
+    auto distancesOf = [&](size_t agent) { return distances_.empty() ? nullptr : &distances_[agent]; };
+
+    // 根节点：依次规划各代理，已规划的代理作为预约，初始冲突就少得多
+    auto root = std::make_unique<Node>();
+    root->paths.resize(agents.size());
+    {
+        std::unique_ptr<Scratch> scratch = acquireScratch();
+        scratch->clearReservations();
+        scratch->constraints.clear();
+        for (size_t i = 0; i < agents.size(); ++i) {
+            auto path = std::make_shared<AgentPath>();
+            if (!scratch->plan(occupancy, agents[i], distancesOf(i), suboptimality_, *path,
+                               stats_.lowLevelExpanded)) {
+                return false;
+            }
+            scratch->reserve(path->cells, width_);
+            root->cost += path->cost;
+            root->lowerBound += path->lowerBound;
+            root->paths[i] = std::move(path);
+        }
+        detectConflicts(*root, *scratch);
+        releaseScratch(std::move(scratch));
+    }
+    root->valid = true;
+    nodes_.push_back(std::move(root));
+    stats_.highLevelGenerated = 1;
+
+    // 开表按下界排序；焦点表是代价不超过suboptimality倍最小下界的节点，按冲突数排序
+    std::set<std::pair<double, int32_t>> open;
+    std::set<std::pair<double, int32_t>> byCost;
+    std::set<std::tuple<size_t, double, int32_t>> focal;
+    double bound = -1.0;
+    auto insertNode = [&](int32_t id) {
+        const Node& node = *nodes_[id];
+        open.insert({node.lowerBound, id});
+        byCost.insert({node.cost, id});
+        if (node.cost <= bound) {
+            focal.insert({node.conflicts, node.cost, id});
+        }
+    };
+    insertNode(0);
+
+    std::vector<int32_t> batch;
+    std::vector<std::unique_ptr<Node>> children;
+    while (!open.empty()) {
+        const double lowerBound = open.begin()->first;
+        const double newBound = lowerBound * suboptimality_ + COST_EPSILON;
+        if (newBound > bound) {
+            for (auto it = byCost.upper_bound({bound, std::numeric_limits<int32_t>::max()});
+                 it != byCost.end() && it->first <= newBound; ++it) {
+                focal.insert({nodes_[it->second]->conflicts, it->first, it->second});
+            }
+            bound = newBound;
+        }
+
+        // 取出一批节点，按焦点表顺序第一个没有冲突的节点就是解
+        batch.clear();
+        while (batch.size() < HIGH_LEVEL_BATCH && !focal.empty()) {
+            const int32_t id = std::get<2>(*focal.begin());
+            focal.erase(focal.begin());
+            const Node& node = *nodes_[id];
+            open.erase({node.lowerBound, id});
+            byCost.erase({node.cost, id});
+            if (node.conflicts == 0) {
+                stats_.sumOfCosts = node.cost;
+                stats_.lowerBound = std::min(node.cost, lowerBound);
+                outPaths.resize(agents.size());
+                for (size_t i = 0; i < agents.size(); ++i) {
+                    const std::vector<int32_t>& cells = node.paths[i]->cells;
+                    stats_.makespan = std::max(stats_.makespan, cells.size() - 1);
+                    outPaths[i].reserve(cells.size());
+                    for (int32_t cell : cells) {
+                        outPaths[i].emplace_back(cell % width_, cell / width_);
+                    }
+                }
+                return true;
+            }
+            batch.push_back(id);
+        }
+
+        // 每个节点按最早的冲突分裂为两个子节点，所有子节点并行重新规划
+        children.clear();
+        for (int32_t id : batch) {
+            const Node& parent = *nodes_[id];
+            for (const Constraint& constraint : {parent.firstConflict.constraintA, parent.firstConflict.constraintB}) {
+                auto child = std::make_unique<Node>();
+                child->parent = id;
+                child->constraint = constraint;
+                child->paths = parent.paths;
+                child->cost = parent.cost;
+                child->lowerBound = parent.lowerBound;
+                children.push_back(std::move(child));
+            }
+        }
+        workers.parallelFor(children.size(), 1, [&](size_t begin, size_t end) {
+            std::unique_ptr<Scratch> scratch = acquireScratch();
+            for (size_t i = begin; i < end; ++i) {
+                expandChild(children[i]->parent, *children[i], *scratch);
+            }
+            releaseScratch(std::move(scratch));
+        });
+
+        // 父节点的路径已复制给子节点，释放以控制约束树的内存
+        for (int32_t id : batch) {
+            std::vector<PathPtr>().swap(nodes_[id]->paths);
+        }
+        stats_.highLevelExpanded += batch.size();
+        for (size_t i = 0; i < children.size(); ++i) {
+            stats_.lowLevelExpanded += children[i]->lowLevelExpanded;
+            if (!children[i]->valid) {
+                continue;
+            }
+            nodes_.push_back(std::move(children[i]));
+            insertNode(static_cast<int32_t>(nodes_.size() - 1));
+            ++stats_.highLevelGenerated;
+        }
+
+        if (stats_.highLevelGenerated >= params.maxHighLevelNodes ||
+            (progress && !progress->report(stats_.lowLevelExpanded))) {
+            break;
+        }
+    }
+    return false;
+}
+
+void ConflictBasedSearch::collectConstraints(int32_t node, int32_t agent, std::vector<Constraint>& out) const {
+    for (int32_t at = node; at >= 0; at = nodes_[at]->parent) {
+        if (nodes_[at]->constraint.agent == agent) {
+            out.push_back(nodes_[at]->constraint);
+        }
+    }
+}
+
+void ConflictBasedSearch::expandChild(int32_t parent, Node& child, Scratch& scratch) {
+    const int32_t agent = child.constraint.agent;
+    scratch.constraints.clear();
+    collectConstraints(parent, agent, scratch.constraints);
+    scratch.constraints.push_back(child.constraint);
+
+    scratch.clearReservations();
+    for (size_t i = 0; i < child.paths.size(); ++i) {
+        if (static_cast<int32_t>(i) != agent) {
+            scratch.reserve(child.paths[i]->cells, width_);
+        }
+    }
+
+    auto path = std::make_shared<AgentPath>();
+    const std::vector<double>* distances = distances_.empty() ? nullptr : &distances_[agent];
+    if (!scratch.plan(*occupancy_, agents_[agent], distances, suboptimality_, *path, child.lowLevelExpanded)) {
+        child.valid = false;
+        return;
+    }
+    // 约束只会增加，子节点的下界不低于父节点
+    const AgentPath& previous = *child.paths[agent];
+    path->lowerBound = std::max(path->lowerBound, previous.lowerBound);
+    child.cost += path->cost - previous.cost;
+    child.lowerBound += path->lowerBound - previous.lowerBound;
+    child.paths[agent] = std::move(path);
+    detectConflicts(child, scratch);
+    child.valid = true;
+}
+
+void ConflictBasedSearch::detectConflicts(Node& node, Scratch& scratch) const {
+    node.conflicts = 0;
+    node.firstConflict = Conflict{};
+    const size_t cellCount = static_cast<size_t>(width_) * occupancy_->getHeight();
+    if (scratch.stamp.size() != cellCount) {
+        scratch.stamp.assign(cellCount, 0);
+        scratch.owner.assign(cellCount, -1);
+        scratch.generation = 0;
+    }
+
+    const int32_t agentCount = static_cast<int32_t>(node.paths.size());
+    int32_t makespan = 0;
+    for (const PathPtr& path : node.paths) {
+        makespan = std::max(makespan, static_cast<int32_t>(path->cells.size()) - 1);
+    }
+    auto at = [&](int32_t agent, int32_t time) {
+        const std::vector<int32_t>& cells = node.paths[agent]->cells;
+        return cells[std::min(time, static_cast<int32_t>(cells.size()) - 1)];
+    };
+    auto record = [&](int32_t a, int32_t b, const Constraint& first, const Constraint& second) {
+        if (node.conflicts++ == 0) {
+            node.firstConflict = {a, b, first, second};
+        }
+    };
+
+    for (int32_t t = 0; t <= makespan; ++t) {
+        if (++scratch.generation == 0) {
+            std::fill(scratch.stamp.begin(), scratch.stamp.end(), 0u);
+            scratch.generation = 1;
+        }
+        const uint32_t generation = scratch.generation;
+        for (int32_t j = 0; j < agentCount; ++j) {
+            const int32_t cell = at(j, t);
+            if (scratch.stamp[cell] == generation) {
+                const int32_t k = scratch.owner[cell];
+                record(k, j, {k, -1, cell, t}, {j, -1, cell, t});
+            } else {
+                scratch.stamp[cell] = generation;
+                scratch.owner[cell] = j;
+            }
+        }
+        if (t == 0) {
+            continue;
+        }
+        for (int32_t j = 0; j < agentCount; ++j) {
+            const int32_t from = at(j, t - 1);
+            const int32_t to = at(j, t);
+            if (from == to) {
+                continue;
+            }
+            // 互换：现在在from上的代理上一步在to上
+            if (scratch.stamp[from] == generation) {
+                const int32_t k = scratch.owner[from];
+                if (k > j && at(k, t - 1) == to) {
+                    record(j, k, {j, from, to, t}, {k, to, from, t});
+                }
+            }
+            // 对角交叉：另一个代理同一步从(toX, fromY)走到(fromX, toY)
+            const int fromX = from % width_;
+            const int fromY = from / width_;
+            const int toX = to % width_;
+            const int toY = to / width_;
+            if (fromX != toX && fromY != toY) {
+                const int32_t crossFrom = fromY * width_ + toX;
+                const int32_t crossTo = toY * width_ + fromX;
+                if (scratch.stamp[crossTo] == generation) {
+                    const int32_t k = scratch.owner[crossTo];
+                    if (k > j && at(k, t - 1) == crossFrom) {
+                        record(j, k, {j, from, to, t}, {k, crossFrom, crossTo, t});
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::unique_ptr<ConflictBasedSearch::Scratch> ConflictBasedSearch::acquireScratch() {
+    std::lock_guard<std::mutex> guard(scratchMutex_);
+    if (freeScratch_.empty()) {
+        return std::make_unique<Scratch>();
+    }
+    std::unique_ptr<Scratch> scratch = std::move(freeScratch_.back());
+    freeScratch_.pop_back();
+    return scratch;
+}
+
+void ConflictBasedSearch::releaseScratch(std::unique_ptr<Scratch> scratch) {
+    std::lock_guard<std::mutex> guard(scratchMutex_);
+    freeScratch_.push_back(std::move(scratch));
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,128 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathGlyph {
+
+class OccupancyGrid;
+class ThreadPool;
+class PlanProgress;
+
+// 多代理路径规划中的一个代理
+struct AgentTask {
+    int startX = 0;
+    int startY = 0;
+    int goalX = 0;
+    int goalY = 0;
+};
+
+// 基于冲突的多代理路径规划（CBS/ECBS）
+// 每个动作（八邻域移动或原地等待）用一个时间步，代价与单代理规划相同，等待的代价为STRAIGHT_COST；
+// 代理到达目标后一直停在目标上。两个代理在同一时刻占据同一格、同一步互换位置或沿对角线交叉时冲突。
+// 高层在约束树上搜索：每个节点为每个代理保存一条路径，取最早的冲突分裂为两个子节点，
+// 各给冲突的一方加一条约束，只重新规划这一个代理。
+// 低层是时空A*：状态为(格子, 时刻)，本代理的约束和其他代理路径的预约表都按时刻查表；
+// 晚于所有约束和预约的时刻互相等价，合并为同一状态，因此目标可达时搜索一定结束。
+// 启发值是每个代理到目标的真实最短距离（开始时对每个目标做一次反向Dijkstra），等待多的实例扩展少得多。
+// suboptimality为1时是最优的CBS，代价相同的节点中优先冲突少的；大于1时是ECBS：
+// 高层和低层都在代价不超过suboptimality倍下界的节点中优先展开冲突最少的，
+// 解的代价和不超过最优值的suboptimality倍，冲突密集的大规模实例搜索量小得多。
+// 高层每轮从焦点表取出固定数量的节点，它们的子节点在线程池中并行重新规划并统计冲突，
+// 再按固定顺序插入约束树，结果与线程数无关。
+class ConflictBasedSearch {
+public:
+    static constexpr size_t HIGH_LEVEL_BATCH = 8;  // 每轮并行展开的约束树节点数
+    // 距离表的总格数上限（代理数 × 地图格数），超过时启发值退回八方向距离
+    static constexpr size_t DISTANCE_TABLE_LIMIT = size_t(1) << 23;
+
+    struct Params {
+        double suboptimality = 1.0;        // 不小于1，1为最优的CBS
+        size_t maxHighLevelNodes = 50000;  // 生成的约束树节点数上限，超过时放弃
+        ThreadPool* pool = nullptr;        // 为空时使用共享线程池
+    };
+
+    struct Stats {
+        size_t highLevelExpanded = 0;   // 展开的约束树节点数
+        size_t highLevelGenerated = 0;  // 生成的约束树节点数
+        size_t lowLevelExpanded = 0;    // 所有时空A*扩展的状态数
+        double sumOfCosts = 0.0;        // 解的代价和
+        double lowerBound = 0.0;        // 最优代价和的下界
+        size_t makespan = 0;            // 最后一个代理到达的时刻
+    };
+
+    ConflictBasedSearch();
+    ~ConflictBasedSearch();
+
+    // 为所有代理规划互不冲突的路径，outPaths[i][t]为代理i在时刻t所在的格子（到达后不再列出）。
+    // 起点或目标被占据、在地图外或重复，某个目标不可达，节点数超过上限，
+    // 或progress被取消时返回false，outPaths被清空
+    bool solve(const OccupancyGrid& occupancy, const std::vector<AgentTask>& agents, const Params& params,
+               std::vector<std::vector<Point>>& outPaths, PlanProgress* progress = nullptr);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct AgentPath {
+        std::vector<int32_t> cells;  // cells[t]为时刻t的格子，最后一个是目标
+        double cost = 0.0;
+        double lowerBound = 0.0;     // 该代理在当前约束下最优代价的下界
+    };
+    using PathPtr = std::shared_ptr<const AgentPath>;
+
+    // 代理agent在time时刻不能位于cell（from < 0），或不能在time时刻沿from -> cell到达
+    struct Constraint {
+        int32_t agent = -1;
+        int32_t from = -1;
+        int32_t cell = -1;
+        int32_t time = 0;
+    };
+
+    struct Conflict {
+        int32_t agentA = -1;
+        int32_t agentB = -1;
+        Constraint constraintA;
+        Constraint constraintB;
+    };
+
+    struct Node {
+        int32_t parent = -1;
+        Constraint constraint;              // 相对父节点新增的约束，根节点没有
+        std::vector<PathPtr> paths;         // 展开后释放，子节点各自持有副本
+        double cost = 0.0;
+        double lowerBound = 0.0;
+        size_t conflicts = 0;
+        Conflict firstConflict;
+        size_t lowLevelExpanded = 0;        // 生成该节点时低层扩展的状态数
+        bool valid = false;                 // 重新规划失败的子节点不进入约束树
+    };
+
+    struct Scratch;
+
+    // 从node沿父节点收集代理agent的约束
+    void collectConstraints(int32_t node, int32_t agent, std::vector<Constraint>& out) const;
+    // 为一个子节点重新规划代理并统计冲突，在线程池中执行
+    void expandChild(int32_t parent, Node& child, Scratch& scratch);
+    // 统计node的冲突数和最早的冲突
+    void detectConflicts(Node& node, Scratch& scratch) const;
+    // 借用/归还线程的临时数据
+    std::unique_ptr<Scratch> acquireScratch();
+    void releaseScratch(std::unique_ptr<Scratch> scratch);
+
+    const OccupancyGrid* occupancy_ = nullptr;
+    std::vector<AgentTask> agents_;
+    std::vector<std::vector<double>> distances_;  // 每个代理各格到目标的最短距离，可能为空
+    double suboptimality_ = 1.0;
+    int width_ = 0;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    Stats stats_;
+
+    std::mutex scratchMutex_;
+    std::vector<std::unique_ptr<Scratch>> freeScratch_;
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,369 @@
+#include "planner/dstarLite.h"
+#include "maze/maze.h"
+#include "planner/planJob.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace PathGlyph {
+
+namespace {
+
+using Cost = int64_t;
+
+// 定点代价，与STRAIGHT_COST/DIAGONAL_COST对应
+constexpr Cost STRAIGHT = 1000;
+constexpr Cost DIAGONAL = 1414;
+constexpr double COST_SCALE = 1000.0;
+// 足够大又不会在相加时溢出
+constexpr Cost INF = std::numeric_limits<Cost>::max() / 4;
+
+inline Cost moveCost(int dir) { return (dir % 2 == 0) ? STRAIGHT : DIAGONAL; }
+
+inline Cost heuristic(int x1, int y1, int x2, int y2) {
+    Cost dx = std::abs(x1 - x2);
+    Cost dy = std::abs(y1 - y2);
+    Cost diagonal = std::min(dx, dy);
+    return diagonal * DIAGONAL + (std::max(dx, dy) - diagonal) * STRAIGHT;
+}
+
+// 任一项为∞时结果仍为∞
+inline Cost addCost(Cost a, Cost b) { return (a >= INF || b >= INF) ? INF : a + b; }
+
+} // namespace
+
+void DStarLite::resize(int width, int height) {
+    if (width == width_ && height == height_) {
+        return;
+    }
+
+    width_ = width;
+    height_ = height;
+
+    size_t cellCount = static_cast<size_t>(width_) * static_cast<size_t>(height_);
+    g_.assign(cellCount, INF);
+    rhs_.assign(cellCount, INF);
+    heapPos_.assign(cellCount, -1);
+    stamp_.assign(cellCount, 0);
+    generation_ = 0;
+    heap_.clear();
+    pendingCells_.clear();
+    initialized_ = false;
+}
+
+void DStarLite::notifyCellChanged(int x, int y) {
+    if (initialized_ && x >= 0 && x < width_ && y >= 0 && y < height_) {
+        pendingCells_.push_back(y * width_ + x);
+    }
+}
+
+void DStarLite::initialize(int goalX, int goalY) {
+    ++generation_;
+    if (generation_ == 0) {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        generation_ = 1;
+    }
+    heap_.clear();
+    pendingCells_.clear();
+
+    goalX_ = goalX;
+    goalY_ = goalY;
+    km_ = 0;
+
+    int32_t goalIndex = goalY * width_ + goalX;
+    touch(goalIndex);
+    rhs_[goalIndex] = 0;
+    heapPush(goalIndex, calculateKey(goalIndex));
+    initialized_ = true;
+}
+
+void DStarLite::touch(int32_t index) {
+    if (stamp_[index] != generation_) {
+        stamp_[index] = generation_;
+        g_[index] = INF;
+        rhs_[index] = INF;
+        heapPos_[index] = -1;
+    }
+}
+
+DStarLite::Key DStarLite::calculateKey(int32_t index) const {
+    Cost best = std::min(g_[index], rhs_[index]);
+    Cost h = heuristic(startX_, startY_, index % width_, index / width_);
+    return {addCost(addCost(best, h), km_), best};
+}
+
+Cost DStarLite::edgeCost(const OccupancyGrid& occupancy, int32_t index, int dir) const {
+    int nx = index % width_ + GRID_DX[dir];
+    int ny = index / width_ + GRID_DY[dir];
+    if (occupancy.isBlocked(nx, ny)) {
+        return INF;
+    }
+    return moveCost(dir);
+}
+
+Cost DStarLite::computeRhs(const OccupancyGrid& occupancy, int32_t index) {
+    const int x = index % width_;
+    const int y = index / width_;
+    const uint8_t blocked = occupancy.neighborMask(x, y);
+
+    Cost best = INF;
+    for (int dir = 0; dir < 8; ++dir) {
+        if (blocked & (1u << dir)) {
+            continue;
+        }
+        int32_t neighbor = (y + GRID_DY[dir]) * width_ + (x + GRID_DX[dir]);
+        touch(neighbor);
+        best = std::min(best, addCost(moveCost(dir), g_[neighbor]));
+    }
+    return best;
+}
+
+void DStarLite::updateVertex(int32_t index) {
+    bool inconsistent = g_[index] != rhs_[index];
+    bool inHeap = heapPos_[index] >= 0;
+    if (inconsistent && inHeap) {
+        heapUpdate(index, calculateKey(index));
+    } else if (inconsistent) {
+        heapPush(index, calculateKey(index));
+    } else if (inHeap) {
+        heapRemove(index);
+    }
+}
+
+bool DStarLite::computeShortestPath(const OccupancyGrid& occupancy, PlanProgress* progress) {
+    const int32_t startIndex = startY_ * width_ + startX_;
+    const int32_t goalIndex = goalY_ * width_ + goalX_;
+    touch(startIndex);
+
+    while (!heap_.empty() &&
+           (heap_.front().key < calculateKey(startIndex) || rhs_[startIndex] > g_[startIndex])) {
+        const int32_t u = heap_.front().index;
+        const Key oldKey = heap_.front().key;
+        const Key newKey = calculateKey(u);
+        ++stats_.nodesExpanded;
+        // 在处理u之前中断，g/rhs和开集保持一致
+        if (progress && PlanProgress::shouldReport(stats_.nodesExpanded) &&
+            !progress->report(stats_.nodesExpanded)) {
+            return false;
+        }
+
+        if (oldKey < newKey) {
+            // 键因km增大而过期，重新排序
+            heapUpdate(u, newKey);
+            continue;
+        }
+
+        const int ux = u % width_;
+        const int uy = u / width_;
+
+        if (g_[u] > rhs_[u]) {
+            // 过一致：降低g并放宽前驱
+            g_[u] = rhs_[u];
+            heapRemove(u);
+            for (int dir = 0; dir < 8; ++dir) {
+                int px = ux + GRID_DX[dir];
+                int py = uy + GRID_DY[dir];
+                if (px < 0 || px >= width_ || py < 0 || py >= height_) {
+                    continue;
+                }
+                int32_t pred = py * width_ + px;
+                touch(pred);
+                // 前驱pred到u的方向与dir相反
+                Cost cost = addCost(edgeCost(occupancy, pred, (dir + 4) & 7), g_[u]);
+                if (pred != goalIndex && cost < rhs_[pred]) {
+                    rhs_[pred] = cost;
+                    updateVertex(pred);
+                }
+            }
+        } else {
+            // 欠一致：g置为∞，重新计算依赖u的前驱及u自身
+            const Cost oldG = g_[u];
+            g_[u] = INF;
+            for (int dir = 0; dir < 8; ++dir) {
+                int px = ux + GRID_DX[dir];
+                int py = uy + GRID_DY[dir];
+                if (px < 0 || px >= width_ || py < 0 || py >= height_) {
+                    continue;
+                }
+                int32_t pred = py * width_ + px;
+                touch(pred);
+                Cost cost = addCost(edgeCost(occupancy, pred, (dir + 4) & 7), oldG);
+                if (pred != goalIndex && cost < INF && rhs_[pred] == cost) {
+                    rhs_[pred] = computeRhs(occupancy, pred);
+                }
+                updateVertex(pred);
+            }
+            if (u != goalIndex) {
+                rhs_[u] = computeRhs(occupancy, u);
+            }
+            updateVertex(u);
+        }
+    }
+    return true;
+}
+
+bool DStarLite::extractPath(const OccupancyGrid& occupancy, std::vector<Point>& outPath) {
+    int x = startX_;
+    int y = startY_;
+    outPath.emplace_back(x, y);
+
+    // 最多走遍所有格子，防止数值问题导致死循环
+    const size_t maxSteps = static_cast<size_t>(width_) * static_cast<size_t>(height_);
+    for (size_t step = 0; step < maxSteps && (x != goalX_ || y != goalY_); ++step) {
+        const uint8_t blocked = occupancy.neighborMask(x, y);
+        int bestDir = -1;
+        Cost bestCost = INF;
+        for (int dir = 0; dir < 8; ++dir) {
+            if (blocked & (1u << dir)) {
+                continue;
+            }
+            int32_t neighbor = (y + GRID_DY[dir]) * width_ + (x + GRID_DX[dir]);
+            touch(neighbor);
+            Cost cost = addCost(moveCost(dir), g_[neighbor]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestDir = dir;
+            }
+        }
+        if (bestDir < 0) {
+            outPath.clear();
+            return false;
+        }
+        x += GRID_DX[bestDir];
+        y += GRID_DY[bestDir];
+        outPath.emplace_back(x, y);
+    }
+
+    if (x != goalX_ || y != goalY_) {
+        outPath.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DStarLite::plan(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                     std::vector<Point>& outPath, PlanProgress* progress) {
+    outPath.clear();
+    stats_ = PlannerStats{};
+    resize(maze.getWidth(), maze.getHeight());
+
+    if (startX < 0 || startX >= width_ || startY < 0 || startY >= height_ ||
+        goalX < 0 || goalX >= width_ || goalY < 0 || goalY >= height_) {
+        return false;
+    }
+    const OccupancyGrid& occupancy = maze.getOccupancy();
+
+    if (!initialized_ || goalX != goalX_ || goalY != goalY_) {
+        startX_ = startX;
+        startY_ = startY;
+        initialize(goalX, goalY);
+    } else if (startX != startX_ || startY != startY_) {
+        // 代理移动：累加启发式偏移，已有键保持有效的下界
+        km_ += heuristic(startX_, startY_, startX, startY);
+        startX_ = startX;
+        startY_ = startY;
+    }
+
+    // 修复受编辑影响的顶点：只有指向变化格子的边代价改变，即其八邻域的rhs
+    const int32_t goalIndex = goalY_ * width_ + goalX_;
+    for (int32_t cell : pendingCells_) {
+        const int cx = cell % width_;
+        const int cy = cell / width_;
+        for (int dir = 0; dir < 8; ++dir) {
+            int px = cx + GRID_DX[dir];
+            int py = cy + GRID_DY[dir];
+            if (px < 0 || px >= width_ || py < 0 || py >= height_) {
+                continue;
+            }
+            int32_t pred = py * width_ + px;
+            touch(pred);
+            if (pred != goalIndex) {
+                rhs_[pred] = computeRhs(occupancy, pred);
+            }
+            updateVertex(pred);
+        }
+    }
+    pendingCells_.clear();
+
+    if (!computeShortestPath(occupancy, progress)) {
+        return false;
+    }
+
+    const int32_t startIndex = startY_ * width_ + startX_;
+    if (rhs_[startIndex] >= INF) {
+        return false;
+    }
+    stats_.pathCost = static_cast<double>(rhs_[startIndex]) / COST_SCALE;
+    return extractPath(occupancy, outPath);
+}
+
+void DStarLite::heapSwap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    heapPos_[heap_[a].index] = static_cast<int32_t>(a);
+    heapPos_[heap_[b].index] = static_cast<int32_t>(b);
+}
+
+void DStarLite::siftUp(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!(heap_[pos].key < heap_[parent].key)) {
+            break;
+        }
+        heapSwap(pos, parent);
+        pos = parent;
+    }
+}
+
+void DStarLite::siftDown(size_t pos) {
+    const size_t size = heap_.size();
+    while (true) {
+        size_t left = pos * 2 + 1;
+        size_t right = left + 1;
+        size_t smallest = pos;
+        if (left < size && heap_[left].key < heap_[smallest].key) {
+            smallest = left;
+        }
+        if (right < size && heap_[right].key < heap_[smallest].key) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            break;
+        }
+        heapSwap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void DStarLite::heapPush(int32_t index, const Key& key) {
+    heap_.push_back({key, index});
+    heapPos_[index] = static_cast<int32_t>(heap_.size() - 1);
+    siftUp(heap_.size() - 1);
+    ++stats_.nodesGenerated;
+}
+
+void DStarLite::heapUpdate(int32_t index, const Key& key) {
+    size_t pos = static_cast<size_t>(heapPos_[index]);
+    Key oldKey = heap_[pos].key;
+    heap_[pos].key = key;
+    if (key < oldKey) {
+        siftUp(pos);
+    } else {
+        siftDown(pos);
+    }
+}
+
+void DStarLite::heapRemove(int32_t index) {
+    size_t pos = static_cast<size_t>(heapPos_[index]);
+    size_t last = heap_.size() - 1;
+    if (pos != last) {
+        heapSwap(pos, last);
+    }
+    heap_.pop_back();
+    heapPos_[index] = -1;
+    if (pos < heap_.size()) {
+        siftUp(pos);
+        siftDown(pos);
+    }
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,103 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include <vector>
+#include <cstdint>
+
+namespace PathGlyph {
+
+class Maze;
+class PlanProgress;
+class OccupancyGrid;
+
+// D* Lite增量规划器
+// 从目标向起点反向搜索，g/rhs按 y * width + x 下标寻址并在多次规划间保留。
+// 障碍物编辑只登记发生变化的格子，下次规划时仅修复这些格子周围的顶点；
+// 代理移动通过km累加启发式偏移，不需要重新搜索。
+// 更换目标或地图尺寸时才整体重新初始化（同样依靠代数计数器，无需清空数组）。
+// 代价使用定点整数（直线1000、对角1414），保证键的比较与km累加没有舍入误差。
+class DStarLite {
+public:
+    DStarLite() = default;
+
+    // 调整内部数组大小，尺寸变化时丢弃搜索状态
+    void resize(int width, int height);
+    // 丢弃全部搜索状态，下次规划从头开始
+    void reset() { initialized_ = false; }
+
+    // 登记一个占据状态改变的格子，下次规划时增量修复
+    void notifyCellChanged(int x, int y);
+
+    // 从(startX, startY)规划到(goalX, goalY)，找到路径时逐格写入outPath并返回true。
+    // progress非空时定期汇报扩展数并检查取消（反向搜索没有从起点出发的部分路径）；
+    // 被取消时返回false，已完成的修复保留，下次规划从中断处继续
+    bool plan(const Maze& maze, int startX, int startY, int goalX, int goalY,
+              std::vector<Point>& outPath, PlanProgress* progress = nullptr);
+
+    bool isInitialized() const { return initialized_; }
+    const PlannerStats& getStats() const { return stats_; }
+
+private:
+    using Cost = int64_t;
+
+    // 优先级键，按字典序比较
+    struct Key {
+        Cost k1;
+        Cost k2;
+        bool operator<(const Key& other) const {
+            return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+        }
+    };
+
+    struct HeapEntry {
+        Key key;
+        int32_t index;
+    };
+
+    // 以新目标开始一代搜索
+    void initialize(int goalX, int goalY);
+    // 格子第一次在本代被访问时惰性初始化为g = rhs = ∞
+    void touch(int32_t index);
+
+    Key calculateKey(int32_t index) const;
+    // 从index移动到dir方向邻居的代价，目标格被占据时为∞
+    Cost edgeCost(const OccupancyGrid& occupancy, int32_t index, int dir) const;
+    // rhs = min(c(s, s') + g(s'))
+    Cost computeRhs(const OccupancyGrid& occupancy, int32_t index);
+    void updateVertex(int32_t index);
+    // 被progress取消时返回false
+    bool computeShortestPath(const OccupancyGrid& occupancy, PlanProgress* progress);
+    // 沿g下降方向从起点走到目标
+    bool extractPath(const OccupancyGrid& occupancy, std::vector<Point>& outPath);
+
+    // 带位置索引的二叉堆，支持更新和删除
+    void heapPush(int32_t index, const Key& key);
+    void heapUpdate(int32_t index, const Key& key);
+    void heapRemove(int32_t index);
+    void heapSwap(size_t a, size_t b);
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+
+    int width_ = 0;
+    int height_ = 0;
+
+    std::vector<Cost> g_;
+    std::vector<Cost> rhs_;
+    std::vector<int32_t> heapPos_;    // 在heap_中的位置，不在开集中为-1
+    std::vector<uint32_t> stamp_;     // 等于generation_表示本代已初始化
+    uint32_t generation_ = 0;
+    std::vector<HeapEntry> heap_;
+
+    std::vector<int32_t> pendingCells_;  // 待修复的格子
+
+    bool initialized_ = false;
+    int startX_ = 0;
+    int startY_ = 0;
+    int goalX_ = -1;
+    int goalY_ = -1;
+    Cost km_ = 0;                     // 起点移动累积的启发式偏移
+
+    PlannerStats stats_;
+};
+
+} // namespace PathGlyph
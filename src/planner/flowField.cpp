@@ -0,0 +1,346 @@
+#include "planner/flowField.h"
+#include "maze/occupancyGrid.h"
+#include "planner/planJob.h"
+#include "common/threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr size_t DIRECTION_ROW_GRAIN = 64;
+// 每轮处理的图块的候选代价与波前的最大差距，约为两个图块宽的路程
+constexpr float WAVEFRONT_BAND = 2.0f * FlowField::TILE_SIZE;
+
+inline float stepCost(int direction) {
+    return (direction % 2 == 0) ? static_cast<float>(STRAIGHT_COST) : static_cast<float>(DIAGONAL_COST);
+}
+
+// 堆元素：高32位是代价的位模式（非负浮点数的位模式与数值同序），低32位是格子下标
+inline uint64_t packEntry(float cost, uint32_t index) {
+    uint32_t bits;
+    std::memcpy(&bits, &cost, sizeof(bits));
+    return (static_cast<uint64_t>(bits) << 32) | index;
+}
+
+inline float entryCost(uint64_t entry) {
+    const uint32_t bits = static_cast<uint32_t>(entry >> 32);
+    float cost;
+    std::memcpy(&cost, &bits, sizeof(cost));
+    return cost;
+}
+
+// 按行遍历图块[x0, x1) x [y0, y1)的边界格
+template <typename Visit>
+void forEachBorderCell(int x0, int y0, int x1, int y1, Visit&& visit) {
+    for (int y = y0; y < y1; ++y) {
+        if (y == y0 || y == y1 - 1) {
+            for (int x = x0; x < x1; ++x) {
+                visit(x, y);
+            }
+        } else {
+            visit(x0, y);
+            if (x1 - 1 > x0) {
+                visit(x1 - 1, y);
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool FlowField::build(const OccupancyGrid& occupancy, int goalX, int goalY, ThreadPool* pool,
+                      PlanProgress* progress) {
+    built_ = false;
+    stats_ = PlannerStats{};
+    width_ = occupancy.getWidth();
+    height_ = occupancy.getHeight();
+    goalX_ = goalX;
+    goalY_ = goalY;
+    if (occupancy.isBlocked(goalX, goalY)) {
+        return false;
+    }
+
+    const size_t cells = static_cast<size_t>(width_) * height_;
+    tilesX_ = (width_ + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY_ = (height_ + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t tiles = static_cast<size_t>(tilesX_) * tilesY_;
+    cost_.assign(cells, UNREACHABLE);
+    incoming_.assign(cells, UNREACHABLE);
+    direction_.assign(cells, NO_DIRECTION);
+    pending_.assign(tiles, 0);
+    tileMin_.assign(tiles, UNREACHABLE);
+    borderChanged_.assign(tiles, 0);
+    tileStats_.assign(tiles, PlannerStats{});
+
+    // 目标作为候选代价0进入它所在的图块
+    incoming_[static_cast<size_t>(goalY) * width_ + goalX] = 0.0f;
+    const int goalTile = (goalY / TILE_SIZE) * tilesX_ + goalX / TILE_SIZE;
+    pendingList_.assign(1, goalTile);
+    pending_[goalTile] = 1;
+    tileMin_[goalTile] = 0.0f;
+    bool firstRound = true;
+
+    ThreadPool& workers = pool ? *pool : ThreadPool::shared();
+    while (!pendingList_.empty()) {
+        if (!firstRound) {
+            workers.parallelFor(pendingList_.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    gatherBorder(occupancy, pendingList_[i]);
+                }
+            });
+        }
+        firstRound = false;
+
+        // 只处理候选代价在波前附近的图块，更远的等波前推进过来再处理，避免同一图块被反复松弛
+        float front = UNREACHABLE;
+        for (int tile : pendingList_) {
+            front = std::min(front, tileMin_[tile]);
+        }
+        const float threshold = front + WAVEFRONT_BAND;
+        activeList_.clear();
+        nextList_.clear();
+        for (int tile : pendingList_) {
+            if (tileMin_[tile] <= threshold) {
+                activeList_.push_back(tile);
+                pending_[tile] = 0;
+            } else if (tileMin_[tile] != UNREACHABLE) {
+                nextList_.push_back(tile);
+            } else {
+                pending_[tile] = 0;
+            }
+        }
+
+        workers.parallelFor(activeList_.size(), 1, [&](size_t begin, size_t end) {
+            thread_local std::vector<uint64_t> heap;
+            for (size_t i = begin; i < end; ++i) {
+                relaxTile(occupancy, activeList_[i], heap);
+            }
+        });
+
+        // 边界有变化的图块唤醒八个相邻图块
+        for (int tile : activeList_) {
+            stats_.nodesExpanded += tileStats_[tile].nodesExpanded;
+            stats_.nodesGenerated += tileStats_[tile].nodesGenerated;
+            if (!borderChanged_[tile]) {
+                continue;
+            }
+            const int tx = tile % tilesX_;
+            const int ty = tile / tilesX_;
+            for (int i = 0; i < 8; ++i) {
+                const int nx = tx + GRID_DX[i];
+                const int ny = ty + GRID_DY[i];
+                if (nx < 0 || nx >= tilesX_ || ny < 0 || ny >= tilesY_) {
+                    continue;
+                }
+                const int neighbor = ny * tilesX_ + nx;
+                if (!pending_[neighbor]) {
+                    pending_[neighbor] = 1;
+                    nextList_.push_back(neighbor);
+                }
+            }
+        }
+        pendingList_.swap(nextList_);
+
+        if (progress && !progress->report(stats_.nodesExpanded)) {
+            return false;
+        }
+    }
+
+    const size_t rows = static_cast<size_t>(height_);
+    workers.parallelFor(rows, DIRECTION_ROW_GRAIN, [&](size_t begin, size_t end) {
+        computeDirections(occupancy, static_cast<int>(begin), static_cast<int>(end));
+    });
+    built_ = true;
+    return true;
+}
+
+void FlowField::gatherBorder(const OccupancyGrid& occupancy, int tile) {
+    const int x0 = (tile % tilesX_) * TILE_SIZE;
+    const int y0 = (tile / tilesX_) * TILE_SIZE;
+    const int x1 = std::min(x0 + TILE_SIZE, width_);
+    const int y1 = std::min(y0 + TILE_SIZE, height_);
+
+    // 只读相邻图块的代价、只写本图块的候选代价；代价对称，从邻居走到本格与反向相同
+    float tileMin = UNREACHABLE;
+    forEachBorderCell(x0, y0, x1, y1, [&](int x, int y) {
+        if (occupancy.isBlocked(x, y)) {
+            return;
+        }
+        const uint8_t blocked = occupancy.neighborMask(x, y);
+        float best = incoming_[static_cast<size_t>(y) * width_ + x];
+        for (int i = 0; i < 8; ++i) {
+            if (blocked & (1u << i)) {
+                continue;
+            }
+            const int nx = x + GRID_DX[i];
+            const int ny = y + GRID_DY[i];
+            if (nx >= x0 && nx < x1 && ny >= y0 && ny < y1) {
+                continue;
+            }
+            const float neighborCost = cost_[static_cast<size_t>(ny) * width_ + nx];
+            if (neighborCost != UNREACHABLE) {
+                best = std::min(best, neighborCost + stepCost(i));
+            }
+        }
+        const size_t index = static_cast<size_t>(y) * width_ + x;
+        incoming_[index] = best;
+        if (best < cost_[index]) {
+            tileMin = std::min(tileMin, best);
+        }
+    });
+    tileMin_[tile] = tileMin;
+}
+
+void FlowField::relaxTile(const OccupancyGrid& occupancy, int tile, std::vector<uint64_t>& heap) {
+    const int x0 = (tile % tilesX_) * TILE_SIZE;
+    const int y0 = (tile / tilesX_) * TILE_SIZE;
+    const int x1 = std::min(x0 + TILE_SIZE, width_);
+    const int y1 = std::min(y0 + TILE_SIZE, height_);
+    PlannerStats& stats = tileStats_[tile];
+    stats = PlannerStats{};
+    bool borderChanged = false;
+    auto onBorder = [&](int x, int y) { return x == x0 || x == x1 - 1 || y == y0 || y == y1 - 1; };
+    const std::greater<uint64_t> minHeap;
+
+    // 候选代价更小的格子作为起点，候选代价用过即清除
+    heap.clear();
+    tileMin_[tile] = UNREACHABLE;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const size_t index = static_cast<size_t>(y) * width_ + x;
+            const float candidate = incoming_[index];
+            if (candidate == UNREACHABLE) {
+                continue;
+            }
+            incoming_[index] = UNREACHABLE;
+            if (candidate < cost_[index]) {
+                cost_[index] = candidate;
+                heap.push_back(packEntry(candidate, static_cast<uint32_t>(index)));
+                borderChanged = borderChanged || onBorder(x, y);
+            }
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), minHeap);
+    stats.nodesGenerated = heap.size();
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), minHeap);
+        const uint64_t entry = heap.back();
+        heap.pop_back();
+        const float current = entryCost(entry);
+        const uint32_t index = static_cast<uint32_t>(entry);
+        if (current > cost_[index]) {
+            continue;  // 过期的堆元素
+        }
+        ++stats.nodesExpanded;
+
+        const int cx = static_cast<int>(index % static_cast<uint32_t>(width_));
+        const int cy = static_cast<int>(index / static_cast<uint32_t>(width_));
+        const uint8_t blocked = occupancy.neighborMask(cx, cy);
+        for (int i = 0; i < 8; ++i) {
+            if (blocked & (1u << i)) {
+                continue;
+            }
+            const int nx = cx + GRID_DX[i];
+            const int ny = cy + GRID_DY[i];
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1) {
+                continue;  // 本轮不写其他图块，留给它们下一轮从边界读取
+            }
+            const size_t neighbor = static_cast<size_t>(ny) * width_ + nx;
+            const float newCost = current + stepCost(i);
+            if (newCost < cost_[neighbor]) {
+                cost_[neighbor] = newCost;
+                heap.push_back(packEntry(newCost, static_cast<uint32_t>(neighbor)));
+                std::push_heap(heap.begin(), heap.end(), minHeap);
+                ++stats.nodesGenerated;
+                borderChanged = borderChanged || onBorder(nx, ny);
+            }
+        }
+    }
+    borderChanged_[tile] = borderChanged ? 1 : 0;
+}
+
+void FlowField::computeDirections(const OccupancyGrid& occupancy, int firstRow, int lastRow) {
+    for (int y = firstRow; y < lastRow; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            const size_t index = static_cast<size_t>(y) * width_ + x;
+            if (cost_[index] == UNREACHABLE || (x == goalX_ && y == goalY_)) {
+                continue;
+            }
+            // 沿代价加移动代价最小的邻居前进，它就是最短路径上的下一格
+            const uint8_t blocked = occupancy.neighborMask(x, y);
+            float best = UNREACHABLE;
+            uint8_t bestDirection = NO_DIRECTION;
+            for (int i = 0; i < 8; ++i) {
+                if (blocked & (1u << i)) {
+                    continue;
+                }
+                const float neighborCost = cost_[static_cast<size_t>(y + GRID_DY[i]) * width_ + x + GRID_DX[i]];
+                if (neighborCost == UNREACHABLE) {
+                    continue;
+                }
+                const float through = neighborCost + stepCost(i);
+                if (through < best) {
+                    best = through;
+                    bestDirection = static_cast<uint8_t>(i);
+                }
+            }
+            direction_[index] = bestDirection;
+        }
+    }
+}
+
+float FlowField::getCost(int x, int y) const {
+    if (!built_ || x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return UNREACHABLE;
+    }
+    return cost_[static_cast<size_t>(y) * width_ + x];
+}
+
+int FlowField::getDirection(int x, int y) const {
+    if (!built_ || x < 0 || x >= width_ || y < 0 || y >= height_) {
+        return -1;
+    }
+    const uint8_t direction = direction_[static_cast<size_t>(y) * width_ + x];
+    return direction == NO_DIRECTION ? -1 : direction;
+}
+
+glm::vec2 FlowField::getSteering(float x, float y) const {
+    const int direction = getDirection(static_cast<int>(std::floor(x + 0.5f)), static_cast<int>(std::floor(y + 0.5f)));
+    if (direction < 0) {
+        return glm::vec2(0.0f);
+    }
+    return glm::normalize(glm::vec2(static_cast<float>(GRID_DX[direction]), static_cast<float>(GRID_DY[direction])));
+}
+
+bool FlowField::extractPath(int startX, int startY, std::vector<Point>& outPath, double& pathCost) const {
+    outPath.clear();
+    pathCost = 0.0;
+    if (getCost(startX, startY) == UNREACHABLE) {
+        return false;
+    }
+    // 代价沿方向严格下降，步数不会超过格子数；上限只是防御
+    const size_t maxSteps = static_cast<size_t>(width_) * height_;
+    int x = startX;
+    int y = startY;
+    outPath.emplace_back(x, y);
+    while (x != goalX_ || y != goalY_) {
+        const int direction = getDirection(x, y);
+        if (direction < 0 || outPath.size() > maxSteps) {
+            outPath.clear();
+            pathCost = 0.0;
+            return false;
+        }
+        x += GRID_DX[direction];
+        y += GRID_DY[direction];
+        pathCost += (direction % 2 == 0) ? STRAIGHT_COST : DIAGONAL_COST;
+        outPath.emplace_back(x, y);
+    }
+    return true;
+}
+
+} // namespace PathGlyph
@@ -0,0 +1,84 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
+
+namespace PathGlyph {
+
+class OccupancyGrid;
+class ThreadPool;
+class PlanProgress;
+
+// 以目标为根的流场 - 许多代理共用一个目标时只搜索一次，之后每个代理按所在格查表前进
+// 积分场是每格到目标的最短路径代价（与A*相同的八邻域和移动代价），方向场是每格代价下降最快的邻居。
+// 积分场按TILE_SIZE见方的图块并行计算：每一轮先让待处理的图块从相邻图块的边界格读取候选代价，
+// 再对候选代价接近波前的图块各做一次图块内的Dijkstra；边界格的代价有变化时，相邻图块变为待处理，
+// 直到没有待处理的图块。两个阶段都只写本图块的格子，图块之间不需要加锁，结果与整张图的Dijkstra相同。
+class FlowField {
+public:
+    static constexpr int TILE_SIZE = 64;
+    static constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+    static constexpr uint8_t NO_DIRECTION = 0xFF;  // 目标格、不可达格和占据格
+
+    FlowField() = default;
+
+    // 以(goalX, goalY)为根重建，pool为空时使用共享线程池。progress非空时每轮汇报一次扩展数，
+    // 被取消时返回false；目标不在地图内或被占据时也返回false，此时流场无效
+    bool build(const OccupancyGrid& occupancy, int goalX, int goalY, ThreadPool* pool = nullptr,
+               PlanProgress* progress = nullptr);
+    // 使流场无效
+    void clear() { built_ = false; }
+
+    bool isBuilt() const { return built_; }
+    int getGoalX() const { return goalX_; }
+    int getGoalY() const { return goalY_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    // 最近一次build的扩展数和生成数
+    const PlannerStats& getStats() const { return stats_; }
+
+    // 格子(x, y)到目标的代价，地图外或不可达时为UNREACHABLE
+    float getCost(int x, int y) const;
+    // 格子(x, y)的前进方向下标（见GRID_DX/GRID_DY），没有方向时为-1
+    int getDirection(int x, int y) const;
+    // 连续坐标所在格（四舍五入）的前进方向，单位向量；没有方向时为零向量
+    glm::vec2 getSteering(float x, float y) const;
+
+    // 从(startX, startY)沿方向场走到目标，写入outPath（复用其容量），不可达时返回false。
+    // pathCost为按移动代价累加的路径长度
+    bool extractPath(int startX, int startY, std::vector<Point>& outPath, double& pathCost) const;
+
+private:
+    // 第一阶段：从相邻图块的边界格为本图块的边界格计算候选代价，写入incoming_和tileMin_[tile]
+    void gatherBorder(const OccupancyGrid& occupancy, int tile);
+    // 第二阶段：把候选代价并入本图块，从代价下降的格子开始在图块内做Dijkstra，
+    // 扩展数写入tileStats_[tile]；边界格代价下降时置borderChanged_[tile]
+    void relaxTile(const OccupancyGrid& occupancy, int tile, std::vector<uint64_t>& heap);
+    // 由积分场计算第[firstRow, lastRow)行的方向
+    void computeDirections(const OccupancyGrid& occupancy, int firstRow, int lastRow);
+
+    int width_ = 0;
+    int height_ = 0;
+    int tilesX_ = 0;
+    int tilesY_ = 0;
+    int goalX_ = -1;
+    int goalY_ = -1;
+    bool built_ = false;
+    PlannerStats stats_;
+
+    std::vector<float> cost_;          // 积分场，按行存放
+    std::vector<float> incoming_;      // 边界格从相邻图块得到的候选代价
+    std::vector<uint8_t> direction_;   // 方向场，按行存放
+    std::vector<uint8_t> pending_;     // 等待处理的图块（相邻图块的边界有变化）
+    std::vector<float> tileMin_;       // 图块最小的有效候选代价，没有时为UNREACHABLE
+    std::vector<uint8_t> borderChanged_;  // 本轮边界格代价有下降的图块
+    std::vector<int> pendingList_;
+    std::vector<int> activeList_;      // 本轮处理的图块
+    std::vector<int> nextList_;
+    std::vector<PlannerStats> tileStats_;  // 本轮每个图块的扩展数和生成数
+};
+
+} // namespace PathGlyph
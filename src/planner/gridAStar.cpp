@@ -0,0 +1,102 @@
+#include "planner/gridAStar.h"
+#include "maze/maze.h"
+#include "planner/planJob.h"
+#include <algorithm>
+
+namespace PathGlyph {
+
+bool GridAStar::search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                       std::vector<Point>& outPath, PlanProgress* progress) {
+    outPath.clear();
+    stats_ = PlannerStats{};
+    space_.resize(maze.getWidth(), maze.getHeight());
+
+    const int width = space_.getWidth();
+    const int height = space_.getHeight();
+    if (startX < 0 || startX >= width || startY < 0 || startY >= height) {
+        return false;
+    }
+    const OccupancyGrid& occupancy = maze.getOccupancy();
+    if (occupancy.isBlocked(goalX, goalY)) {
+        return false;
+    }
+
+    space_.beginGeneration();
+
+    const int32_t startIndex = space_.indexOf(startX, startY);
+    const int32_t goalIndex = space_.indexOf(goalX, goalY);
+    space_.open(startIndex, 0.0, octileDistance(startX, startY, goalX, goalY), -1);
+    ++stats_.nodesGenerated;
+
+    // 离目标最近（启发值最小）的已扩展节点，汇报进度时作为部分路径的终点
+    int32_t bestIndex = startIndex;
+    double bestH = octileDistance(startX, startY, goalX, goalY);
+
+    // A*主循环
+    SearchSpace::OpenEntry current;
+    while (space_.popOpen(current)) {
+        space_.close(current.index);
+        ++stats_.nodesExpanded;
+
+        // 检查是否到达目标
+        if (current.index == goalIndex) {
+            stats_.pathCost = current.g;
+            reconstructPath(goalIndex, outPath);
+            return true;
+        }
+
+        if (progress) {
+            if (current.f - current.g < bestH) {
+                bestH = current.f - current.g;
+                bestIndex = current.index;
+            }
+            if (PlanProgress::shouldReport(stats_.nodesExpanded)) {
+                partialPath_.clear();
+                reconstructPath(bestIndex, partialPath_);
+                if (!progress->report(stats_.nodesExpanded, &partialPath_)) {
+                    return false;
+                }
+            }
+        }
+
+        const int cx = current.index % width;
+        const int cy = current.index / width;
+        // 一次字级查询取得八邻域的占据情况
+        const uint8_t blocked = occupancy.neighborMask(cx, cy);
+
+        // 遍历所有可能的移动方向
+        for (int i = 0; i < 8; ++i) {
+            if (blocked & (1u << i)) {
+                continue;
+            }
+            int nx = cx + GRID_DX[i];
+            int ny = cy + GRID_DY[i];
+
+            int32_t neighbor = space_.indexOf(nx, ny);
+            if (space_.isClosed(neighbor)) {
+                continue;
+            }
+
+            double newG = current.g + ((i % 2 == 0) ? STRAIGHT_COST : DIAGONAL_COST);
+            if (space_.isSeen(neighbor) && newG >= space_.g(neighbor)) {
+                continue;
+            }
+
+            space_.open(neighbor, newG, newG + octileDistance(nx, ny, goalX, goalY), current.index);
+            ++stats_.nodesGenerated;
+        }
+    }
+
+    return false;
+}
+
+void GridAStar::reconstructPath(int32_t goalIndex, std::vector<Point>& outPath) const {
+    const int width = space_.getWidth();
+    // 从目标回溯到起点，再整体翻转
+    for (int32_t index = goalIndex; index != -1; index = space_.parent(index)) {
+        outPath.emplace_back(index % width, index / width);
+    }
+    std::reverse(outPath.begin(), outPath.end());
+}
+
+} // namespace PathGlyph
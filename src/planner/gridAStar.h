@@ -0,0 +1,39 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include "planner/searchSpace.h"
+#include <vector>
+#include <cstdint>
+
+namespace PathGlyph {
+
+class Maze;
+class PlanProgress;
+
+// 基于扁平数组的A*引擎
+// 搜索状态全部放在SearchSpace中，预热之后搜索过程不再进行堆内存分配。
+class GridAStar {
+public:
+    GridAStar() = default;
+
+    // 调整内部数组大小，尺寸不变时不做任何事情
+    void resize(int width, int height) { space_.resize(width, height); }
+
+    // 在maze的静态占据上从(startX, startY)搜索到(goalX, goalY)
+    // 找到路径时写入outPath（复用其容量）并返回true。
+    // progress非空时定期汇报扩展数和部分路径，被取消时返回false
+    bool search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                std::vector<Point>& outPath, PlanProgress* progress = nullptr);
+
+    const PlannerStats& getStats() const { return stats_; }
+
+private:
+    // 从目标下标沿parent回溯到起点
+    void reconstructPath(int32_t goalIndex, std::vector<Point>& outPath) const;
+
+    SearchSpace space_;
+    PlannerStats stats_;
+    std::vector<Point> partialPath_;  // 汇报进度时的临时路径
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,704 @@
+#include "planner/hpaStar.h"
+#include "maze/maze.h"
+#include "planner/planJob.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace PathGlyph {
+
+void HPAStar::setClusterSize(int size) {
+    size = std::max(size, 2);
+    if (size != clusterSize_) {
+        clusterSize_ = size;
+        built_ = false;
+    }
+}
+
+void HPAStar::notifyCellChanged(int x, int y) {
+    if (built_ && x >= 0 && x < width_ && y >= 0 && y < height_) {
+        pendingCells_.push_back(y * width_ + x);
+    }
+}
+
+void HPAStar::clusterBounds(int32_t cluster, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (cluster % clustersX_) * clusterSize_;
+    y0 = (cluster / clustersX_) * clusterSize_;
+    x1 = std::min(x0 + clusterSize_, width_);
+    y1 = std::min(y0 + clusterSize_, height_);
+}
+
+int32_t HPAStar::localIndex(int32_t cluster, int x, int y) const {
+    int x0 = (cluster % clustersX_) * clusterSize_;
+    int y0 = (cluster / clustersX_) * clusterSize_;
+    return local_.indexOf(x - x0, y - y0);
+}
+
+// ---------------------------------------------------------------------------
+// 抽象图构建
+
+void HPAStar::buildAll(const OccupancyGrid& occupancy) {
+    width_ = occupancy.getWidth();
+    height_ = occupancy.getHeight();
+    clustersX_ = (width_ + clusterSize_ - 1) / clusterSize_;
+    clustersY_ = (height_ + clusterSize_ - 1) / clusterSize_;
+
+    const size_t clusterCount = static_cast<size_t>(clustersX_) * static_cast<size_t>(clustersY_);
+    nodes_.clear();
+    freeNodes_.clear();
+    clusterNodes_.assign(clusterCount, {});
+    clusterReady_.assign(clusterCount, 0);
+    borders_.assign(clusterCount * BORDER_KIND_COUNT, {});
+    pendingCells_.clear();
+
+    for (size_t id = 0; id < borders_.size(); ++id) {
+        computeBorder(occupancy, static_cast<int32_t>(id), borders_[id]);
+        for (const Crossing& crossing : borders_[id]) {
+            linkCrossing(crossing);
+        }
+    }
+    built_ = true;
+}
+
+void HPAStar::applyPendingChanges(const OccupancyGrid& occupancy) {
+    std::vector<int32_t> borderIds;
+    std::vector<int32_t> dirtyClusters;
+
+    auto addBorder = [&](int i, int j, int kind) {
+        if (i >= 0 && j >= 0) {
+            borderIds.push_back((j * clustersX_ + i) * BORDER_KIND_COUNT + kind);
+        }
+    };
+
+    for (int32_t cell : pendingCells_) {
+        const int x = cell % width_;
+        const int y = cell / width_;
+        const int32_t cluster = clusterOf(x, y);
+        // 簇内部改变，簇内边一定要重算
+        dirtyClusters.push_back(cluster);
+
+        int x0, y0, x1, y1;
+        clusterBounds(cluster, x0, y0, x1, y1);
+        if (x != x0 && x != x1 - 1 && y != y0 && y != y1 - 1) {
+            continue;
+        }
+
+        // 位于簇的外圈，可能改变与该簇相邻的所有边界（四条边和四个角）
+        const int ci = cluster % clustersX_;
+        const int cj = cluster / clustersX_;
+        addBorder(ci, cj, BORDER_X);
+        addBorder(ci, cj, BORDER_Y);
+        addBorder(ci, cj, BORDER_CORNER);
+        addBorder(ci - 1, cj, BORDER_X);
+        addBorder(ci - 1, cj, BORDER_CORNER);
+        addBorder(ci, cj - 1, BORDER_Y);
+        addBorder(ci, cj - 1, BORDER_CORNER);
+        addBorder(ci - 1, cj - 1, BORDER_CORNER);
+    }
+    pendingCells_.clear();
+
+    std::sort(borderIds.begin(), borderIds.end());
+    borderIds.erase(std::unique(borderIds.begin(), borderIds.end()), borderIds.end());
+
+    for (int32_t id : borderIds) {
+        computeBorder(occupancy, id, crossingScratch_);
+        if (crossingScratch_ == borders_[id]) {
+            continue;
+        }
+        // 入口变化的边界两侧的簇都需要重建
+        for (const Crossing& crossing : borders_[id]) {
+            unlinkCrossing(crossing);
+            dirtyClusters.push_back(clusterOf(crossing.ax, crossing.ay));
+            dirtyClusters.push_back(clusterOf(crossing.bx, crossing.by));
+        }
+        for (const Crossing& crossing : crossingScratch_) {
+            linkCrossing(crossing);
+            dirtyClusters.push_back(clusterOf(crossing.ax, crossing.ay));
+            dirtyClusters.push_back(clusterOf(crossing.bx, crossing.by));
+        }
+        borders_[id].swap(crossingScratch_);
+    }
+
+    std::sort(dirtyClusters.begin(), dirtyClusters.end());
+    dirtyClusters.erase(std::unique(dirtyClusters.begin(), dirtyClusters.end()), dirtyClusters.end());
+    for (int32_t cluster : dirtyClusters) {
+        rebuildCluster(cluster);
+    }
+}
+
+void HPAStar::computeBorder(const OccupancyGrid& occupancy, int32_t borderId,
+                            std::vector<Crossing>& outCrossings) const {
+    outCrossings.clear();
+
+    const int32_t cluster = borderId / BORDER_KIND_COUNT;
+    const int kind = borderId % BORDER_KIND_COUNT;
+    const int ci = cluster % clustersX_;
+    const int cj = cluster / clustersX_;
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+
+    auto isFree = [&](int x, int y) { return !occupancy.isBlocked(x, y); };
+
+    if (kind == BORDER_CORNER) {
+        if (ci + 1 >= clustersX_ || cj + 1 >= clustersY_) {
+            return;
+        }
+        // 角点周围的四个格子分属四个簇，只有两个中间格都被占据时斜穿才是唯一的通路
+        if (isFree(x1 - 1, y1 - 1) && isFree(x1, y1) && !isFree(x1, y1 - 1) && !isFree(x1 - 1, y1)) {
+            outCrossings.push_back({x1 - 1, y1 - 1, x1, y1});
+        }
+        if (isFree(x1, y1 - 1) && isFree(x1 - 1, y1) && !isFree(x1 - 1, y1 - 1) && !isFree(x1, y1)) {
+            outCrossings.push_back({x1, y1 - 1, x1 - 1, y1});
+        }
+        return;
+    }
+
+    // 统一用(s, t)描述边界：s为跨越边界的坐标，t为沿边界的坐标
+    const bool alongY = (kind == BORDER_X);
+    if (alongY ? ci + 1 >= clustersX_ : cj + 1 >= clustersY_) {
+        return;
+    }
+    const int b = alongY ? x1 : y1;  // 相邻簇的第一行/列
+    const int t0 = alongY ? y0 : x0;
+    const int t1 = alongY ? y1 : x1;
+
+    auto freeAt = [&](int s, int t) { return alongY ? isFree(s, t) : isFree(t, s); };
+    auto push = [&](int sa, int ta, int sb, int tb) {
+        if (alongY) {
+            outCrossings.push_back({sa, ta, sb, tb});
+        } else {
+            outCrossings.push_back({ta, sa, tb, sb});
+        }
+    };
+
+    // 直线入口：两侧都空闲的连续段，短段取中点，长段取两端
+    int runStart = -1;
+    for (int t = t0; t <= t1; ++t) {
+        bool open = t < t1 && freeAt(b - 1, t) && freeAt(b, t);
+        if (open && runStart < 0) {
+            runStart = t;
+        } else if (!open && runStart >= 0) {
+            int runEnd = t - 1;
+            if (runEnd - runStart + 1 >= ENTRANCE_SPLIT_LENGTH) {
+                push(b - 1, runStart, b, runStart);
+                push(b - 1, runEnd, b, runEnd);
+            } else {
+                int mid = (runStart + runEnd) / 2;
+                push(b - 1, mid, b, mid);
+            }
+            runStart = -1;
+        }
+    }
+
+    // 对角入口：两个中间格都被占据时才不会被直线入口覆盖
+    for (int t = t0; t + 1 < t1; ++t) {
+        if (freeAt(b - 1, t) && freeAt(b, t + 1) && !freeAt(b, t) && !freeAt(b - 1, t + 1)) {
+            push(b - 1, t, b, t + 1);
+        }
+        if (freeAt(b - 1, t + 1) && freeAt(b, t) && !freeAt(b - 1, t) && !freeAt(b, t + 1)) {
+            push(b - 1, t + 1, b, t);
+        }
+    }
+}
+
+void HPAStar::linkCrossing(const Crossing& crossing) {
+    int32_t a = findNode(crossing.ax, crossing.ay);
+    if (a < 0) {
+        a = createNode(crossing.ax, crossing.ay);
+    }
+    int32_t b = findNode(crossing.bx, crossing.by);
+    if (b < 0) {
+        b = createNode(crossing.bx, crossing.by);
+    }
+    double cost = (crossing.ax != crossing.bx && crossing.ay != crossing.by) ? DIAGONAL_COST
+                                                                               : STRAIGHT_COST;
+    nodes_[a].edges.push_back({b, cost, true});
+    nodes_[b].edges.push_back({a, cost, true});
+}
+
+void HPAStar::unlinkCrossing(const Crossing& crossing) {
+    int32_t a = findNode(crossing.ax, crossing.ay);
+    int32_t b = findNode(crossing.bx, crossing.by);
+    if (a < 0 || b < 0) {
+        return;
+    }
+    auto removeEdge = [this](int32_t from, int32_t to) {
+        std::vector<AbstractEdge>& edges = nodes_[from].edges;
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [to](const AbstractEdge& edge) { return edge.inter && edge.target == to; }),
+                    edges.end());
+    };
+    removeEdge(a, b);
+    removeEdge(b, a);
+}
+
+void HPAStar::rebuildCluster(int32_t cluster) {
+    std::vector<int32_t>& ids = clusterNodes_[cluster];
+
+    for (int32_t id : ids) {
+        std::vector<AbstractEdge>& edges = nodes_[id].edges;
+        edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                   [](const AbstractEdge& edge) { return !edge.inter; }),
+                    edges.end());
+    }
+    // 倒序回收，releaseNode把末尾元素换到当前位置，而末尾元素已经检查过
+    for (size_t k = ids.size(); k-- > 0;) {
+        if (nodes_[ids[k]].edges.empty()) {
+            releaseNode(ids[k]);
+        }
+    }
+    clusterReady_[cluster] = 0;
+}
+
+void HPAStar::ensureCluster(const OccupancyGrid& occupancy, int32_t cluster) {
+    if (clusterReady_[cluster]) {
+        return;
+    }
+    clusterReady_[cluster] = 1;
+
+    // 簇内距离对称，每对入口只搜索一次
+    const std::vector<int32_t>& ids = clusterNodes_[cluster];
+    for (size_t k = 0; k < ids.size(); ++k) {
+        const int32_t u = ids[k];
+        searchCluster(occupancy, cluster, nodes_[u].x, nodes_[u].y, -1, -1);
+        for (size_t m = k + 1; m < ids.size(); ++m) {
+            const int32_t v = ids[m];
+            int32_t index = localIndex(cluster, nodes_[v].x, nodes_[v].y);
+            if (local_.isClosed(index)) {
+                nodes_[u].edges.push_back({v, local_.g(index), false});
+                nodes_[v].edges.push_back({u, local_.g(index), false});
+            }
+        }
+    }
+}
+
+int32_t HPAStar::findNode(int x, int y) const {
+    for (int32_t id : clusterNodes_[clusterOf(x, y)]) {
+        if (nodes_[id].x == x && nodes_[id].y == y) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int32_t HPAStar::createNode(int x, int y) {
+    int32_t id;
+    if (!freeNodes_.empty()) {
+        id = freeNodes_.back();
+        freeNodes_.pop_back();
+    } else {
+        id = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    AbstractNode& node = nodes_[id];
+    node.x = x;
+    node.y = y;
+    node.cluster = clusterOf(x, y);
+    node.edges.clear();
+    clusterNodes_[node.cluster].push_back(id);
+    return id;
+}
+
+void HPAStar::releaseNode(int32_t id) {
+    AbstractNode& node = nodes_[id];
+    std::vector<int32_t>& ids = clusterNodes_[node.cluster];
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end()) {
+        *it = ids.back();
+        ids.pop_back();
+    }
+    node.cluster = -1;
+    node.edges.clear();
+    freeNodes_.push_back(id);
+}
+
+// ---------------------------------------------------------------------------
+// 查询
+
+bool HPAStar::searchCluster(const OccupancyGrid& occupancy, int32_t cluster,
+                            int startX, int startY, int goalX, int goalY) {
+    int x0, y0, x1, y1;
+    clusterBounds(cluster, x0, y0, x1, y1);
+    local_.resize(clusterSize_, clusterSize_);
+    return searchBounded(occupancy, local_, x0, y0, x1, y1, startX, startY, goalX, goalY);
+}
+
+bool HPAStar::searchBounded(const OccupancyGrid& occupancy, SearchSpace& space, int x0, int y0, int x1, int y1,
+                            int startX, int startY, int goalX, int goalY) {
+    space.beginGeneration();
+
+    const int width = space.getWidth();
+    const bool hasGoal = goalX >= 0;
+    const int32_t goalIndex = hasGoal ? space.indexOf(goalX - x0, goalY - y0) : -1;
+    space.open(space.indexOf(startX - x0, startY - y0), 0.0,
+               hasGoal ? octileDistance(startX, startY, goalX, goalY) : 0.0, -1);
+
+    SearchSpace::OpenEntry current;
+    while (space.popOpen(current)) {
+        space.close(current.index);
+        ++stats_.nodesExpanded;
+
+        if (current.index == goalIndex) {
+            return true;
+        }
+
+        const int cx = x0 + current.index % width;
+        const int cy = y0 + current.index / width;
+        const uint8_t blocked = occupancy.neighborMask(cx, cy);
+
+        for (int i = 0; i < 8; ++i) {
+            if (blocked & (1u << i)) {
+                continue;
+            }
+            int nx = cx + GRID_DX[i];
+            int ny = cy + GRID_DY[i];
+            // 不离开区域
+            if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1) {
+                continue;
+            }
+
+            int32_t neighbor = space.indexOf(nx - x0, ny - y0);
+            if (space.isClosed(neighbor)) {
+                continue;
+            }
+            double newG = current.g + ((i % 2 == 0) ? STRAIGHT_COST : DIAGONAL_COST);
+            if (space.isSeen(neighbor) && newG >= space.g(neighbor)) {
+                continue;
+            }
+            double h = hasGoal ? octileDistance(nx, ny, goalX, goalY) : 0.0;
+            space.open(neighbor, newG, newG + h, current.index);
+            ++stats_.nodesGenerated;
+        }
+    }
+
+    // 无目标的遍历总是成功
+    return !hasGoal;
+}
+
+void HPAStar::connectTemporary(const OccupancyGrid& occupancy, int32_t id, bool toNode) {
+    const int32_t cluster = nodes_[id].cluster;
+    searchCluster(occupancy, cluster, nodes_[id].x, nodes_[id].y, -1, -1);
+    for (int32_t other : clusterNodes_[cluster]) {
+        if (other == id) {
+            continue;
+        }
+        int32_t index = localIndex(cluster, nodes_[other].x, nodes_[other].y);
+        if (!local_.isClosed(index)) {
+            continue;
+        }
+        if (toNode) {
+            nodes_[other].edges.push_back({id, local_.g(index), false});
+        } else {
+            nodes_[id].edges.push_back({other, local_.g(index), false});
+        }
+    }
+}
+
+void HPAStar::disconnectTemporary(int32_t id, bool toNode) {
+    if (toNode) {
+        for (int32_t other : clusterNodes_[nodes_[id].cluster]) {
+            std::vector<AbstractEdge>& edges = nodes_[other].edges;
+            edges.erase(std::remove_if(edges.begin(), edges.end(),
+                                       [id](const AbstractEdge& edge) { return edge.target == id; }),
+                        edges.end());
+        }
+    }
+    releaseNode(id);
+}
+
+void HPAStar::connectEscapes(const OccupancyGrid& occupancy, int32_t startNode) {
+    const int x = nodes_[startNode].x;
+    const int y = nodes_[startNode].y;
+    const uint8_t blocked = occupancy.neighborMask(x, y);
+    for (int i = 0; i < 8; ++i) {
+        if (blocked & (1u << i)) {
+            continue;
+        }
+        int nx = x + GRID_DX[i];
+        int ny = y + GRID_DY[i];
+        const int32_t cluster = clusterOf(nx, ny);
+        if (cluster == nodes_[startNode].cluster) {
+            continue;  // 同簇的邻格已由connectTemporary覆盖
+        }
+        int32_t id = findNode(nx, ny);
+        if (id < 0) {
+            // 先算好该簇的簇内边，避免把临时节点算进去
+            ensureCluster(occupancy, cluster);
+            id = createNode(nx, ny);
+            connectTemporary(occupancy, id, false);
+            escapeNodes_.push_back(id);
+        }
+        nodes_[startNode].edges.push_back({id, (i % 2 == 0) ? STRAIGHT_COST : DIAGONAL_COST, true});
+    }
+}
+
+bool HPAStar::searchAbstract(const OccupancyGrid& occupancy, int32_t startNode, int32_t goalNode,
+                             PlanProgress* progress) {
+    abstractPath_.clear();
+    if (abstract_.getWidth() < static_cast<int>(nodes_.size())) {
+        // 预留余量，避免增量编辑每新增一个节点就重新分配
+        abstract_.resize(static_cast<int>(nodes_.size() + nodes_.size() / 2 + 64), 1);
+    }
+    abstract_.beginGeneration();
+
+    const int goalX = nodes_[goalNode].x;
+    const int goalY = nodes_[goalNode].y;
+    abstract_.open(startNode, 0.0, octileDistance(nodes_[startNode].x, nodes_[startNode].y, goalX, goalY), -1);
+    ++stats_.nodesGenerated;
+
+    SearchSpace::OpenEntry current;
+    while (abstract_.popOpen(current)) {
+        abstract_.close(current.index);
+        ++stats_.nodesExpanded;
+        if (progress && PlanProgress::shouldReport(stats_.nodesExpanded) &&
+            !progress->report(stats_.nodesExpanded)) {
+            return false;
+        }
+
+        if (current.index == goalNode) {
+            stats_.pathCost = current.g;
+            for (int32_t id = goalNode; id != -1; id = abstract_.parent(id)) {
+                abstractPath_.push_back(id);
+            }
+            std::reverse(abstractPath_.begin(), abstractPath_.end());
+            return true;
+        }
+
+        ensureCluster(occupancy, nodes_[current.index].cluster);
+        for (const AbstractEdge& edge : nodes_[current.index].edges) {
+            if (abstract_.isClosed(edge.target)) {
+                continue;
+            }
+            double newG = current.g + edge.cost;
+            if (abstract_.isSeen(edge.target) && newG >= abstract_.g(edge.target)) {
+                continue;
+            }
+            const AbstractNode& target = nodes_[edge.target];
+            abstract_.open(edge.target, newG, newG + octileDistance(target.x, target.y, goalX, goalY),
+                           current.index);
+            ++stats_.nodesGenerated;
+        }
+    }
+    return false;
+}
+
+void HPAStar::refinePath(const OccupancyGrid& occupancy, const std::vector<int32_t>& abstractPath,
+                         std::vector<Point>& outPath) {
+    waypoints_.clear();
+    waypoints_.push_back(outPath.size());
+    outPath.emplace_back(nodes_[abstractPath.front()].x, nodes_[abstractPath.front()].y);
+    for (size_t k = 1; k < abstractPath.size(); ++k) {
+        const AbstractNode& from = nodes_[abstractPath[k - 1]];
+        const AbstractNode& to = nodes_[abstractPath[k]];
+        if (from.cluster != to.cluster) {
+            // 簇间边总是一步
+            outPath.emplace_back(to.x, to.y);
+        } else {
+            int x0, y0, x1, y1;
+            clusterBounds(from.cluster, x0, y0, x1, y1);
+            searchCluster(occupancy, from.cluster, from.x, from.y, to.x, to.y);
+            appendLocalPath(local_, x0, y0, to.x, to.y, outPath);
+        }
+        waypoints_.push_back(outPath.size() - 1);
+    }
+}
+
+void HPAStar::appendLocalPath(const SearchSpace& space, int x0, int y0, int goalX, int goalY,
+                              std::vector<Point>& outPath) {
+    const int width = space.getWidth();
+    // 回溯时不含起点，追加后再翻转这一段
+    const size_t first = outPath.size();
+    for (int32_t index = space.indexOf(goalX - x0, goalY - y0); space.parent(index) != -1;
+         index = space.parent(index)) {
+        outPath.emplace_back(x0 + index % width, y0 + index / width);
+    }
+    std::reverse(outPath.begin() + static_cast<std::ptrdiff_t>(first), outPath.end());
+}
+
+double HPAStar::smoothPath(const OccupancyGrid& occupancy, std::vector<Point>& path) {
+    // 各格到起点的累计代价，用于比较两个路点之间的细化路径和直达线段
+    prefixCost_.resize(path.size());
+    prefixCost_[0] = 0.0;
+    for (size_t k = 1; k < path.size(); ++k) {
+        const bool diagonal = path[k].x != path[k - 1].x && path[k].y != path[k - 1].y;
+        prefixCost_[k] = prefixCost_[k - 1] + (diagonal ? DIAGONAL_COST : STRAIGHT_COST);
+    }
+
+    // 同一跳内的细化已是簇内最短路，只需尝试跨过至少一个路点的线段；
+    // 从最远的路点往回找，第一条可通行且更短的线段即替换这一段
+    const double range = SMOOTH_RANGE_CLUSTERS * clusterSize_;
+    smoothed_.clear();
+    smoothed_.push_back(path.front());
+    double cost = 0.0;
+    size_t i = 0;
+    while (i + 1 < waypoints_.size()) {
+        const int ax = static_cast<int>(path[waypoints_[i]].x);
+        const int ay = static_cast<int>(path[waypoints_[i]].y);
+        size_t next = i + 1;
+        for (size_t j = waypoints_.size() - 1; j > i + 1; --j) {
+            const int bx = static_cast<int>(path[waypoints_[j]].x);
+            const int by = static_cast<int>(path[waypoints_[j]].y);
+            const double direct = octileDistance(ax, ay, bx, by);
+            if (direct > range || direct >= prefixCost_[waypoints_[j]] - prefixCost_[waypoints_[i]] - 1e-9) {
+                continue;
+            }
+            if (appendDirectSegment(occupancy, ax, ay, bx, by, smoothed_)) {
+                next = j;
+                cost += direct;
+                break;
+            }
+        }
+        if (next == i + 1) {
+            smoothed_.insert(smoothed_.end(), path.begin() + static_cast<std::ptrdiff_t>(waypoints_[i] + 1),
+                             path.begin() + static_cast<std::ptrdiff_t>(waypoints_[next] + 1));
+            cost += prefixCost_[waypoints_[next]] - prefixCost_[waypoints_[i]];
+        }
+        i = next;
+    }
+    path.swap(smoothed_);
+    return cost;
+}
+
+bool HPAStar::appendDirectSegment(const OccupancyGrid& occupancy, int ax, int ay, int bx, int by,
+                                  std::vector<Point>& outPath) {
+    const int sx = (bx > ax) - (bx < ax);
+    const int sy = (by > ay) - (by < ay);
+    const int dx = std::abs(bx - ax);
+    const int dy = std::abs(by - ay);
+    const int diagonal = std::min(dx, dy);
+    const int straight = std::max(dx, dy) - diagonal;
+    // 直行部分沿较长的轴
+    const int tx = dx > dy ? sx : 0;
+    const int ty = dx > dy ? 0 : sy;
+
+    for (int order = 0; order < 2; ++order) {
+        const size_t mark = outPath.size();
+        int x = ax;
+        int y = ay;
+        bool open = true;
+        for (int step = 0; step < diagonal + straight; ++step) {
+            // order为0时先斜后直，为1时先直后斜
+            const bool diagonalStep = order == 0 ? step < diagonal : step >= straight;
+            const int mx = diagonalStep ? sx : tx;
+            const int my = diagonalStep ? sy : ty;
+            if (occupancy.neighborMask(x, y) & (1u << directionIndex(mx, my))) {
+                open = false;
+                break;
+            }
+            x += mx;
+            y += my;
+            outPath.emplace_back(x, y);
+        }
+        if (open) {
+            return true;
+        }
+        outPath.resize(mark);
+        if (diagonal == 0 || straight == 0) {
+            break;  // 只有一种走法
+        }
+    }
+    return false;
+}
+
+bool HPAStar::search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                     std::vector<Point>& outPath, PlanProgress* progress) {
+    outPath.clear();
+    const OccupancyGrid& occupancy = maze.getOccupancy();
+
+    // 先修复抽象图，统计只计入本次查询的搜索量
+    if (!built_ || occupancy.getWidth() != width_ || occupancy.getHeight() != height_) {
+        buildAll(occupancy);
+    } else if (!pendingCells_.empty()) {
+        applyPendingChanges(occupancy);
+    }
+    stats_ = PlannerStats{};
+
+    if (startX < 0 || startX >= width_ || startY < 0 || startY >= height_ ||
+        occupancy.isBlocked(goalX, goalY)) {
+        return false;
+    }
+
+    // 起点和目标在同一簇、相邻簇或相距不远时，先在两端所在簇的包围矩形（外扩NEAR_QUERY_MARGIN圈簇）
+    // 内做受限A*：短查询经过边界入口往往要绕远，直达路径已是直线距离时不必再查抽象图
+    const int32_t startCluster = clusterOf(startX, startY);
+    const int32_t goalCluster = clusterOf(goalX, goalY);
+    const int ci0 = std::min(startX, goalX) / clusterSize_;
+    const int ci1 = std::max(startX, goalX) / clusterSize_;
+    const int cj0 = std::min(startY, goalY) / clusterSize_;
+    const int cj1 = std::max(startY, goalY) / clusterSize_;
+    const double straightDistance = octileDistance(startX, startY, goalX, goalY);
+    double directCost = -1.0;
+    if ((ci1 - ci0 <= 1 && cj1 - cj0 <= 1) || straightDistance <= NEAR_QUERY_CLUSTERS * clusterSize_) {
+        const int x0 = std::max(ci0 - NEAR_QUERY_MARGIN, 0) * clusterSize_;
+        const int y0 = std::max(cj0 - NEAR_QUERY_MARGIN, 0) * clusterSize_;
+        const int x1 = std::min((ci1 + 1 + NEAR_QUERY_MARGIN) * clusterSize_, width_);
+        const int y1 = std::min((cj1 + 1 + NEAR_QUERY_MARGIN) * clusterSize_, height_);
+        const int extent = (NEAR_QUERY_CLUSTERS + 1 + 2 * NEAR_QUERY_MARGIN) * clusterSize_;
+        near_.resize(extent, extent);
+        if (searchBounded(occupancy, near_, x0, y0, x1, y1, startX, startY, goalX, goalY)) {
+            directCost = near_.g(near_.indexOf(goalX - x0, goalY - y0));
+            outPath.emplace_back(startX, startY);
+            appendLocalPath(near_, x0, y0, goalX, goalY, outPath);
+            if (directCost <= straightDistance + 1e-9) {
+                stats_.pathCost = directCost;
+                return true;
+            }
+        }
+    }
+
+    // 临时节点不参与簇内边的计算，先把两端所在簇的簇内边算好
+    ensureCluster(occupancy, startCluster);
+    ensureCluster(occupancy, goalCluster);
+
+    // 把起点和目标临时接入抽象图（本身就是入口时直接使用）
+    int32_t startNode = findNode(startX, startY);
+    const bool temporaryStart = startNode < 0;
+    if (temporaryStart) {
+        startNode = createNode(startX, startY);
+        connectTemporary(occupancy, startNode, false);
+        if (occupancy.isBlocked(startX, startY)) {
+            connectEscapes(occupancy, startNode);
+        }
+    }
+    int32_t goalNode = findNode(goalX, goalY);
+    const bool temporaryGoal = goalNode < 0;
+    if (temporaryGoal) {
+        goalNode = createNode(goalX, goalY);
+        connectTemporary(occupancy, goalNode, true);
+    }
+
+    bool found = searchAbstract(occupancy, startNode, goalNode, progress);
+    if (progress && progress->isCancelled()) {
+        // 被取消时也要断开临时节点，只是不返回簇内直达的结果
+        found = false;
+        outPath.clear();
+    } else if (found) {
+        // 细化并平滑抽象路径，比受限搜索的路径短时才替换
+        refined_.clear();
+        refinePath(occupancy, abstractPath_, refined_);
+        const double refinedCost = smoothPath(occupancy, refined_);
+        if (directCost < 0.0 || refinedCost < directCost) {
+            outPath.swap(refined_);
+            stats_.pathCost = refinedCost;
+        } else {
+            stats_.pathCost = directCost;
+        }
+    } else if (directCost >= 0.0) {
+        found = true;
+        stats_.pathCost = directCost;
+    }
+
+    if (temporaryGoal) {
+        disconnectTemporary(goalNode, true);
+    }
+    for (int32_t id : escapeNodes_) {
+        disconnectTemporary(id, false);
+    }
+    escapeNodes_.clear();
+    if (temporaryStart) {
+        disconnectTemporary(startNode, false);
+    }
+    return found;
+}
+
+} // namespace PathGlyph
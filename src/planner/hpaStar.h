@@ -0,0 +1,169 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include "planner/searchSpace.h"
+#include <vector>
+#include <cstdint>
+
+namespace PathGlyph {
+
+class Maze;
+class OccupancyGrid;
+class PlanProgress;
+
+// 分层A*（HPA*）
+// 把网格划分为clusterSize x clusterSize的簇，在相邻簇的边界上选取入口格作为抽象节点：
+// 跨边界的一对入口之间是簇间边，同一簇内的入口之间是簇内边，代价为只在簇内行走的最短距离。
+// 查询时把起点和目标临时接入所在簇，在抽象图上做A*，再只对路径经过的簇内段做受限A*细化，
+// 最后把相邻路点间可以直达的抽象跳转替换为直达线段（平滑）。
+// 两端相距不远时先在其所在簇外扩一圈的矩形内做受限A*，短查询不必绕经边界入口。
+// 障碍物编辑只登记格子，下次查询时重算受影响的边界，只有入口或内部发生变化的簇才重建簇内边。
+// 簇内边在抽象搜索第一次进入该簇时才计算，大地图上只为查询实际经过的簇付出构建代价。
+// 结果是近似最优的：路径总是可行；最短路径完全落在受限矩形内时代价与整图A*相同，
+// 否则只保证不高于抽象图上的最优路径（只能经过入口格），没有固定的比例上界。
+// 实测：随机地图（含查询间的障碍物编辑）上平均高出不到1%，最坏约7%；
+// 通道狭长的仓库地图上平均约3%，个别需要穿过多个簇的查询可高出三成以上。
+class HPAStar {
+public:
+    static constexpr int DEFAULT_CLUSTER_SIZE = 16;
+
+    HPAStar() = default;
+
+    // 设置簇边长，抽象图在下次查询时重建
+    void setClusterSize(int size);
+    int getClusterSize() const { return clusterSize_; }
+
+    // 丢弃抽象图，下次查询时整体重建
+    void invalidate() { built_ = false; }
+    // 登记一个占据状态改变的格子，下次查询时增量修复（抽象图未建立时不做任何事情）
+    void notifyCellChanged(int x, int y);
+
+    // 从(startX, startY)搜索到(goalX, goalY)，找到路径时逐格写入outPath并返回true。
+    // progress非空时在抽象搜索中定期汇报扩展数并检查取消，被取消时返回false
+    bool search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                std::vector<Point>& outPath, PlanProgress* progress = nullptr);
+
+    // 当前抽象图中的入口节点数量
+    size_t getAbstractNodeCount() const { return nodes_.size() - freeNodes_.size(); }
+    const PlannerStats& getStats() const { return stats_; }
+
+private:
+    // 边界类型，每个簇拥有其+x侧、+y侧以及(+x, +y)角上的边界
+    enum BorderKind {
+        BORDER_X = 0,
+        BORDER_Y = 1,
+        BORDER_CORNER = 2,
+        BORDER_KIND_COUNT = 3
+    };
+
+    // 入口连续段长度达到该值时在两端各放一个入口，否则只在中点放一个
+    static constexpr int ENTRANCE_SPLIT_LENGTH = 6;
+    // 起点和目标位于相邻簇或八方向距离不超过该数量的簇宽时，先在两端所在簇的包围矩形内做受限A*
+    static constexpr int NEAR_QUERY_CLUSTERS = 2;
+    // 受限A*的区域在包围矩形外再扩展的簇数，绕过障碍物的短路径常会离开两端所在的簇
+    static constexpr int NEAR_QUERY_MARGIN = 1;
+    // 平滑时直达线段的最大八方向长度（簇宽的倍数），限制每个路点的检查量
+    static constexpr int SMOOTH_RANGE_CLUSTERS = 2;
+
+    struct AbstractEdge {
+        int32_t target;
+        double cost;
+        bool inter;  // true为簇间边，false为簇内边
+    };
+
+    struct AbstractNode {
+        int x = 0;
+        int y = 0;
+        int32_t cluster = -1;  // -1表示节点槽位空闲
+        std::vector<AbstractEdge> edges;
+    };
+
+    // 一对跨越簇边界、可以一步到达的格子
+    struct Crossing {
+        int ax, ay;
+        int bx, by;
+        bool operator==(const Crossing& other) const {
+            return ax == other.ax && ay == other.ay && bx == other.bx && by == other.by;
+        }
+    };
+
+    int32_t clusterOf(int x, int y) const {
+        return (y / clusterSize_) * clustersX_ + (x / clusterSize_);
+    }
+    // 簇的格子范围[x0, x1) x [y0, y1)
+    void clusterBounds(int32_t cluster, int& x0, int& y0, int& x1, int& y1) const;
+
+    // 抽象图构建
+    void buildAll(const OccupancyGrid& occupancy);
+    void applyPendingChanges(const OccupancyGrid& occupancy);
+    void computeBorder(const OccupancyGrid& occupancy, int32_t borderId,
+                       std::vector<Crossing>& outCrossings) const;
+    void linkCrossing(const Crossing& crossing);
+    void unlinkCrossing(const Crossing& crossing);
+    // 清除簇内边并回收不再有簇间边的节点，簇内边留待ensureCluster重新计算
+    void rebuildCluster(int32_t cluster);
+    // 簇内边尚未计算时计算之
+    void ensureCluster(const OccupancyGrid& occupancy, int32_t cluster);
+
+    int32_t findNode(int x, int y) const;
+    int32_t createNode(int x, int y);
+    void releaseNode(int32_t id);
+
+    // 在簇内做受限搜索：goalX < 0时为不带目标的Dijkstra（遍历整个簇），否则为到目标的A*
+    // 结果保留在local_中，按localIndex读取
+    bool searchCluster(const OccupancyGrid& occupancy, int32_t cluster,
+                       int startX, int startY, int goalX, int goalY);
+    // 只在[x0, x1) x [y0, y1)内移动的搜索，space以(x0, y0)为原点寻址，宽高不小于区域
+    bool searchBounded(const OccupancyGrid& occupancy, SearchSpace& space, int x0, int y0, int x1, int y1,
+                       int startX, int startY, int goalX, int goalY);
+    int32_t localIndex(int32_t cluster, int x, int y) const;
+    // 为临时起点/目标节点连接同簇入口，toNode为true时添加指向该节点的边
+    void connectTemporary(const OccupancyGrid& occupancy, int32_t id, bool toNode);
+    void disconnectTemporary(int32_t id, bool toNode);
+    // 起点被占据时可能只能斜穿到相邻簇，为这些邻格建立临时节点
+    void connectEscapes(const OccupancyGrid& occupancy, int32_t startNode);
+
+    // 在抽象图上搜索，路径写入abstractPath_，代价写入stats_.pathCost
+    bool searchAbstract(const OccupancyGrid& occupancy, int32_t startNode, int32_t goalNode,
+                        PlanProgress* progress);
+    // 把抽象路径细化为逐格路径，每个抽象节点在路径中的下标记入waypoints_
+    void refinePath(const OccupancyGrid& occupancy, const std::vector<int32_t>& abstractPath,
+                    std::vector<Point>& outPath);
+    // 沿space中的parent从目标回溯到搜索起点，按顺序追加（不含起点）
+    static void appendLocalPath(const SearchSpace& space, int x0, int y0, int goalX, int goalY,
+                                std::vector<Point>& outPath);
+    // 路径平滑：两个路点之间存在可通行且更短的直达线段时，用它替换中间经过的抽象跳转，返回平滑后的代价
+    double smoothPath(const OccupancyGrid& occupancy, std::vector<Point>& path);
+    // 沿一条八方向最短折线（先斜后直或先直后斜）从(ax, ay)走到(bx, by)，可通行时追加到outPath（不含起点）
+    static bool appendDirectSegment(const OccupancyGrid& occupancy, int ax, int ay, int bx, int by,
+                                    std::vector<Point>& outPath);
+
+    int clusterSize_ = DEFAULT_CLUSTER_SIZE;
+    int width_ = 0;
+    int height_ = 0;
+    int clustersX_ = 0;
+    int clustersY_ = 0;
+    bool built_ = false;
+
+    std::vector<AbstractNode> nodes_;
+    std::vector<int32_t> freeNodes_;                 // 空闲的节点槽位
+    std::vector<std::vector<int32_t>> clusterNodes_; // 每个簇包含的节点
+    std::vector<uint8_t> clusterReady_;              // 簇内边是否已计算
+    std::vector<std::vector<Crossing>> borders_;     // 按 cluster * BORDER_KIND_COUNT + kind 寻址
+    std::vector<int32_t> pendingCells_;              // 待修复的格子
+
+    SearchSpace local_;     // 簇内搜索，尺寸为一个簇
+    SearchSpace near_;      // 近距离查询的受限搜索，边长为(NEAR_QUERY_CLUSTERS + 1 + 2 * NEAR_QUERY_MARGIN)个簇宽
+    SearchSpace abstract_;  // 抽象图搜索，按节点编号寻址（高度为1）
+    std::vector<Crossing> crossingScratch_;
+    std::vector<int32_t> abstractPath_;
+    std::vector<int32_t> escapeNodes_;               // connectEscapes建立的临时节点
+    std::vector<size_t> waypoints_;                  // 细化路径中抽象节点的下标
+    std::vector<double> prefixCost_;                 // 平滑时各格到起点的累计代价
+    std::vector<Point> refined_;                     // 细化后的抽象路径，与受限搜索的结果比较
+    std::vector<Point> smoothed_;
+
+    PlannerStats stats_;
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,364 @@
+#include "planner/jumpPointSearch.h"
+#include "maze/maze.h"
+#include "planner/planJob.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace PathGlyph {
+
+namespace {
+
+constexpr size_t JUMP_PROGRESS_INTERVAL = 64;
+
+inline int sign(int v) { return (v > 0) - (v < 0); }
+inline uint8_t dirBit(int dir) { return static_cast<uint8_t>(1u << (dir & 7)); }
+inline bool isDirBlocked(uint8_t blocked, int dir) { return (blocked & dirBit(dir)) != 0; }
+
+} // namespace
+
+void JumpPointSearch::resize(int width, int height) {
+    if (width == space_.getWidth() && height == space_.getHeight()) {
+        return;
+    }
+    space_.resize(width, height);
+    jumpTable_.clear();
+    tablesValid_ = false;
+}
+
+// 直线移动：侧面被挡而斜前方可走时，斜前方为强制邻居
+bool JumpPointSearch::hasForcedStraight(uint8_t blocked, int dir) {
+    return (isDirBlocked(blocked, dir + 2) && !isDirBlocked(blocked, dir + 1)) ||
+           (isDirBlocked(blocked, dir + 6) && !isDirBlocked(blocked, dir + 7));
+}
+
+// 对角移动：来向一侧被挡而其外侧斜向可走时，该斜向为强制邻居
+bool JumpPointSearch::hasForcedDiagonal(uint8_t blocked, int dir) {
+    return (isDirBlocked(blocked, dir + 3) && !isDirBlocked(blocked, dir + 2)) ||
+           (isDirBlocked(blocked, dir + 5) && !isDirBlocked(blocked, dir + 6));
+}
+
+uint8_t JumpPointSearch::prunedDirections(uint8_t blocked, int arrival) {
+    uint8_t dirs = 0;
+    if (arrival < 0) {
+        // 起点：所有方向
+        dirs = 0xFF;
+    } else if (arrival % 2 == 0) {
+        dirs = dirBit(arrival);
+        if (isDirBlocked(blocked, arrival + 2) && !isDirBlocked(blocked, arrival + 1)) {
+            dirs |= dirBit(arrival + 1);
+        }
+        if (isDirBlocked(blocked, arrival + 6) && !isDirBlocked(blocked, arrival + 7)) {
+            dirs |= dirBit(arrival + 7);
+        }
+    } else {
+        dirs = dirBit(arrival) | dirBit(arrival + 1) | dirBit(arrival + 7);
+        if (isDirBlocked(blocked, arrival + 3) && !isDirBlocked(blocked, arrival + 2)) {
+            dirs |= dirBit(arrival + 2);
+        }
+        if (isDirBlocked(blocked, arrival + 5) && !isDirBlocked(blocked, arrival + 6)) {
+            dirs |= dirBit(arrival + 6);
+        }
+    }
+    return static_cast<uint8_t>(dirs & ~blocked);
+}
+
+bool JumpPointSearch::jumpStraight(const OccupancyGrid& occupancy, int x, int y, int dir,
+                                   int goalX, int goalY, int& outX, int& outY) const {
+    const int dx = GRID_DX[dir];
+    const int dy = GRID_DY[dir];
+    while (true) {
+        x += dx;
+        y += dy;
+        if (occupancy.isBlocked(x, y)) {
+            return false;
+        }
+        if ((x == goalX && y == goalY) || hasForcedStraight(occupancy.neighborMask(x, y), dir)) {
+            outX = x;
+            outY = y;
+            return true;
+        }
+    }
+}
+
+bool JumpPointSearch::jumpDiagonal(const OccupancyGrid& occupancy, int x, int y, int dir,
+                                   int goalX, int goalY, int& outX, int& outY) const {
+    const int dx = GRID_DX[dir];
+    const int dy = GRID_DY[dir];
+    int unusedX = 0;
+    int unusedY = 0;
+    while (true) {
+        x += dx;
+        y += dy;
+        if (occupancy.isBlocked(x, y)) {
+            return false;
+        }
+        // 到达目标、存在强制邻居，或沿两个分量方向能跳到跳点时停下
+        if ((x == goalX && y == goalY) ||
+            hasForcedDiagonal(occupancy.neighborMask(x, y), dir) ||
+            jumpStraight(occupancy, x, y, (dir + 7) & 7, goalX, goalY, unusedX, unusedY) ||
+            jumpStraight(occupancy, x, y, (dir + 1) & 7, goalX, goalY, unusedX, unusedY)) {
+            outX = x;
+            outY = y;
+            return true;
+        }
+    }
+}
+
+bool JumpPointSearch::lookupSuccessor(int x, int y, int dir, int goalX, int goalY,
+                                      int& outX, int& outY) const {
+    const int dx = GRID_DX[dir];
+    const int dy = GRID_DY[dir];
+    const int dist = jumpTable_[space_.indexOf(x, y)][dir];
+    const int reach = std::abs(dist);
+
+    // 目标落在本方向可达范围内时，直接以目标（或目标所在行列上的点）作为后继
+    if (dir % 2 == 0) {
+        bool onRay = dx != 0 ? (goalY == y && (goalX - x) * dx > 0)
+                             : (goalX == x && (goalY - y) * dy > 0);
+        int steps = std::abs(goalX - x) + std::abs(goalY - y);
+        if (onRay && steps <= reach) {
+            outX = goalX;
+            outY = goalY;
+            return true;
+        }
+    } else if ((goalX - x) * dx > 0 && (goalY - y) * dy > 0) {
+        int steps = std::min(std::abs(goalX - x), std::abs(goalY - y));
+        if (steps <= reach) {
+            outX = x + dx * steps;
+            outY = y + dy * steps;
+            return true;
+        }
+    }
+
+    if (dist > 0) {
+        outX = x + dx * dist;
+        outY = y + dy * dist;
+        return true;
+    }
+    return false;
+}
+
+int16_t JumpPointSearch::computeEntry(const OccupancyGrid& occupancy, int x, int y, int dir) const {
+    const int nx = x + GRID_DX[dir];
+    const int ny = y + GRID_DY[dir];
+    if (occupancy.isBlocked(nx, ny)) {
+        return 0;
+    }
+
+    const uint8_t blocked = occupancy.neighborMask(nx, ny);
+    const auto& next = jumpTable_[space_.indexOf(nx, ny)];
+    bool isJumpPoint = (dir % 2 == 0)
+        ? hasForcedStraight(blocked, dir)
+        : hasForcedDiagonal(blocked, dir) || next[(dir + 7) & 7] > 0 || next[(dir + 1) & 7] > 0;
+    if (isJumpPoint) {
+        return 1;
+    }
+
+    // 超出上限时把下游格当作伪跳点，搜索时仍会沿原方向继续
+    int16_t prev = next[dir];
+    if (prev > 0) {
+        return prev < MAX_JUMP ? static_cast<int16_t>(prev + 1) : 1;
+    }
+    return prev > -MAX_JUMP ? static_cast<int16_t>(prev - 1) : 1;
+}
+
+void JumpPointSearch::buildTables(const OccupancyGrid& occupancy) {
+    resize(occupancy.getWidth(), occupancy.getHeight());
+    const int width = space_.getWidth();
+    const int height = space_.getHeight();
+    jumpTable_.assign(static_cast<size_t>(width) * static_cast<size_t>(height), {});
+
+    // 先算直线方向，对角方向依赖直线表项；每个方向按“下游先算”的顺序扫描
+    static constexpr int ORDER[8] = {0, 2, 4, 6, 1, 3, 5, 7};
+    for (int dir : ORDER) {
+        const int dx = GRID_DX[dir];
+        const int dy = GRID_DY[dir];
+        for (int j = 0; j < height; ++j) {
+            int y = dy > 0 ? height - 1 - j : j;
+            for (int i = 0; i < width; ++i) {
+                int x = dx > 0 ? width - 1 - i : i;
+                jumpTable_[space_.indexOf(x, y)][dir] = computeEntry(occupancy, x, y, dir);
+            }
+        }
+    }
+    tablesValid_ = true;
+}
+
+void JumpPointSearch::propagate(const OccupancyGrid& occupancy, int x, int y, int dir) {
+    const int dx = GRID_DX[dir];
+    const int dy = GRID_DY[dir];
+    const int width = space_.getWidth();
+    const int height = space_.getHeight();
+
+    for (int cx = x - dx, cy = y - dy;
+         cx >= 0 && cx < width && cy >= 0 && cy < height;
+         cx -= dx, cy -= dy) {
+        int32_t index = space_.indexOf(cx, cy);
+        int16_t value = computeEntry(occupancy, cx, cy, dir);
+        if (value == jumpTable_[index][dir]) {
+            break;
+        }
+        jumpTable_[index][dir] = value;
+        if (dir % 2 == 0) {
+            changedCells_.push_back(index);
+        }
+    }
+}
+
+void JumpPointSearch::updateCell(const OccupancyGrid& occupancy, int x, int y) {
+    if (!tablesValid_) {
+        return;
+    }
+    const int width = space_.getWidth();
+    const int height = space_.getHeight();
+    changedCells_.clear();
+
+    // 该格及其八邻域的占据/强制邻居状态可能改变，先沿直线方向向回传播
+    for (int dir = 0; dir < 8; dir += 2) {
+        for (int my = std::max(0, y - 1); my <= std::min(height - 1, y + 1); ++my) {
+            for (int mx = std::max(0, x - 1); mx <= std::min(width - 1, x + 1); ++mx) {
+                propagate(occupancy, mx, my, dir);
+            }
+        }
+    }
+
+    // 对角表项依赖下游格的直线表项，从3x3块和所有直线表项改变的格子向回传播
+    for (int dir = 1; dir < 8; dir += 2) {
+        for (int my = std::max(0, y - 1); my <= std::min(height - 1, y + 1); ++my) {
+            for (int mx = std::max(0, x - 1); mx <= std::min(width - 1, x + 1); ++mx) {
+                propagate(occupancy, mx, my, dir);
+            }
+        }
+        for (int32_t index : changedCells_) {
+            propagate(occupancy, index % width, index / width, dir);
+        }
+    }
+}
+
+bool JumpPointSearch::search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                             bool usePrecomputed, std::vector<Point>& outPath, PlanProgress* progress) {
+    outPath.clear();
+    stats_ = PlannerStats{};
+    resize(maze.getWidth(), maze.getHeight());
+
+    const int width = space_.getWidth();
+    const int height = space_.getHeight();
+    if (startX < 0 || startX >= width || startY < 0 || startY >= height) {
+        return false;
+    }
+    const OccupancyGrid& occupancy = maze.getOccupancy();
+    if (occupancy.isBlocked(goalX, goalY)) {
+        return false;
+    }
+    if (usePrecomputed && !tablesValid_) {
+        buildTables(occupancy);
+    }
+
+    space_.beginGeneration();
+
+    const int32_t startIndex = space_.indexOf(startX, startY);
+    const int32_t goalIndex = space_.indexOf(goalX, goalY);
+    space_.open(startIndex, 0.0, octileDistance(startX, startY, goalX, goalY), -1);
+    ++stats_.nodesGenerated;
+
+    // 离目标最近的已扩展跳点，汇报进度时作为部分路径的终点
+    int32_t bestIndex = startIndex;
+    double bestH = octileDistance(startX, startY, goalX, goalY);
+
+    SearchSpace::OpenEntry current;
+    while (space_.popOpen(current)) {
+        space_.close(current.index);
+        ++stats_.nodesExpanded;
+
+        if (current.index == goalIndex) {
+            stats_.pathCost = current.g;
+            reconstructPath(goalIndex, outPath);
+            return true;
+        }
+
+        if (progress) {
+            if (current.f - current.g < bestH) {
+                bestH = current.f - current.g;
+                bestIndex = current.index;
+            }
+            // 每个跳点都要沿直线扫描很远，扩展数远少于A*，汇报得更频繁
+            if (PlanProgress::shouldReport(stats_.nodesExpanded, JUMP_PROGRESS_INTERVAL)) {
+                partialPath_.clear();
+                reconstructPath(bestIndex, partialPath_);
+                if (!progress->report(stats_.nodesExpanded, &partialPath_)) {
+                    return false;
+                }
+            }
+        }
+
+        const int cx = current.index % width;
+        const int cy = current.index / width;
+
+        // 由父节点方向确定到达方向，起点没有到达方向
+        int arrival = -1;
+        int32_t parent = space_.parent(current.index);
+        if (parent >= 0) {
+            arrival = directionIndex(sign(cx - parent % width), sign(cy - parent / width));
+        }
+        const uint8_t dirs = prunedDirections(occupancy.neighborMask(cx, cy), arrival);
+
+        for (int dir = 0; dir < 8; ++dir) {
+            if (!(dirs & dirBit(dir))) {
+                continue;
+            }
+
+            int nx = 0;
+            int ny = 0;
+            bool found = usePrecomputed
+                ? lookupSuccessor(cx, cy, dir, goalX, goalY, nx, ny)
+                : (dir % 2 == 0 ? jumpStraight(occupancy, cx, cy, dir, goalX, goalY, nx, ny)
+                                : jumpDiagonal(occupancy, cx, cy, dir, goalX, goalY, nx, ny));
+            if (!found) {
+                continue;
+            }
+
+            int32_t successor = space_.indexOf(nx, ny);
+            if (space_.isClosed(successor)) {
+                continue;
+            }
+
+            // 跳跃段只沿单一方向，八方向距离即为其精确代价
+            double newG = current.g + octileDistance(cx, cy, nx, ny);
+            if (space_.isSeen(successor) && newG >= space_.g(successor)) {
+                continue;
+            }
+
+            space_.open(successor, newG, newG + octileDistance(nx, ny, goalX, goalY), current.index);
+            ++stats_.nodesGenerated;
+        }
+    }
+
+    return false;
+}
+
+void JumpPointSearch::reconstructPath(int32_t goalIndex, std::vector<Point>& outPath) const {
+    const int width = space_.getWidth();
+
+    // 从目标回溯，每段跳跃逐格展开（不含段起点，由下一段输出），最后整体翻转
+    for (int32_t index = goalIndex; index != -1; index = space_.parent(index)) {
+        int x = index % width;
+        int y = index / width;
+        int32_t parent = space_.parent(index);
+        if (parent < 0) {
+            outPath.emplace_back(x, y);
+            break;
+        }
+        int px = parent % width;
+        int py = parent / width;
+        int sx = sign(px - x);
+        int sy = sign(py - y);
+        while (x != px || y != py) {
+            outPath.emplace_back(x, y);
+            x += sx;
+            y += sy;
+        }
+    }
+    std::reverse(outPath.begin(), outPath.end());
+}
+
+} // namespace PathGlyph
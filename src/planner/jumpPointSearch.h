@@ -0,0 +1,77 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include "planner/searchSpace.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+
+namespace PathGlyph {
+
+class Maze;
+class OccupancyGrid;
+class PlanProgress;
+
+// 跳点搜索（JPS / JPS+）
+// 适用于8连通、均匀代价、允许穿角的网格，与GridAStar使用同一套移动规则，
+// 因此返回的路径代价与A*一致，但只把跳点放入开集。
+// JPS在搜索时沿方向逐格“跳跃”；JPS+预先为每格每个方向计算跳跃距离，
+// 搜索时一次查表即可得到后继。障碍物编辑后只沿受影响的行、列和对角线
+// 向回传播更新跳跃表，遇到取值不变的格子即停止。
+class JumpPointSearch {
+public:
+    JumpPointSearch() = default;
+
+    // 调整内部数组大小，尺寸变化时跳跃表失效
+    void resize(int width, int height);
+
+    // 从(startX, startY)搜索到(goalX, goalY)，usePrecomputed为true时使用JPS+跳跃表
+    // 找到路径时按网格逐格写入outPath并返回true；progress的用法与GridAStar::search相同
+    bool search(const Maze& maze, int startX, int startY, int goalX, int goalY,
+                bool usePrecomputed, std::vector<Point>& outPath, PlanProgress* progress = nullptr);
+
+    // 跳跃表维护
+    bool hasTables() const { return tablesValid_; }
+    void invalidateTables() { tablesValid_ = false; }
+    void buildTables(const OccupancyGrid& occupancy);
+    // 单个格子的占据状态改变后增量更新跳跃表（表未建立时不做任何事情）
+    void updateCell(const OccupancyGrid& occupancy, int x, int y);
+
+    const PlannerStats& getStats() const { return stats_; }
+
+private:
+    // 跳跃距离上限，超过时插入一个伪跳点，保证int16_t不溢出
+    static constexpr int16_t MAX_JUMP = 32767;
+
+    // 根据到达方向和邻域占据计算需要继续搜索的方向（自然邻居 + 强制邻居）
+    static uint8_t prunedDirections(uint8_t blocked, int arrival);
+    static bool hasForcedStraight(uint8_t blocked, int dir);
+    static bool hasForcedDiagonal(uint8_t blocked, int dir);
+
+    // JPS：沿dir方向跳跃，找到跳点（或目标）时写入(outX, outY)
+    bool jumpStraight(const OccupancyGrid& occupancy, int x, int y, int dir,
+                      int goalX, int goalY, int& outX, int& outY) const;
+    bool jumpDiagonal(const OccupancyGrid& occupancy, int x, int y, int dir,
+                      int goalX, int goalY, int& outX, int& outY) const;
+    // JPS+：查表得到dir方向上的后继
+    bool lookupSuccessor(int x, int y, int dir, int goalX, int goalY, int& outX, int& outY) const;
+
+    // 由下游格子(x, y) + dir的表项推出(x, y)处dir方向的表项
+    // 正数：距离下一个跳点的步数；非正数：到墙之前可走的步数取负
+    int16_t computeEntry(const OccupancyGrid& occupancy, int x, int y, int dir) const;
+    // 从(x, y)逆着dir方向重算表项，直到取值不再变化
+    void propagate(const OccupancyGrid& occupancy, int x, int y, int dir);
+
+    // 把跳点序列展开为逐格路径
+    void reconstructPath(int32_t goalIndex, std::vector<Point>& outPath) const;
+
+    SearchSpace space_;
+    PlannerStats stats_;
+    std::vector<Point> partialPath_;  // 汇报进度时的临时路径
+
+    std::vector<std::array<int16_t, 8>> jumpTable_;  // 每格8个方向的跳跃距离
+    std::vector<int32_t> changedCells_;              // 增量更新时直线表项改变的格子
+    bool tablesValid_ = false;
+};
+
+} // namespace PathGlyph
@@ -0,0 +1,34 @@
+#include "planner/planJob.h"
+
+namespace PathGlyph {
+
+bool PlanProgress::report(size_t nodesExpanded, const std::vector<Point>* partialPath) {
+    nodesExpanded_.store(nodesExpanded, std::memory_order_relaxed);
+    if (partialPath) {
+        std::lock_guard<std::mutex> lock(partialMutex_);
+        partialPath_ = *partialPath;
+        partialRevision_.fetch_add(1, std::memory_order_release);
+    }
+    return !isCancelled();
+}
+
+uint64_t PlanProgress::copyPartialPath(std::vector<Point>& path) const {
+    std::lock_guard<std::mutex> lock(partialMutex_);
+    path = partialPath_;
+    return partialRevision_.load(std::memory_order_relaxed);
+}
+
+void PlanJob::wait() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return isDone(); });
+}
+
+void PlanJob::finish(PlanStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_.store(status, std::memory_order_release);
+    }
+    finished_.notify_all();
+}
+
+} // namespace PathGlyph
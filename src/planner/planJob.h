@@ -0,0 +1,99 @@
+#pragma once
+#include "common/types.h"
+#include "planner/planner.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace PathGlyph {
+
+// 规划进度与取消 - 在执行规划的线程和其他线程之间共享
+// 规划器每扩展PROGRESS_INTERVAL个节点汇报一次扩展数和当前最优的部分路径
+// （从起点到启发值最小的已扩展节点），并检查是否已被取消；取消后规划器尽快返回false。
+class PlanProgress {
+public:
+    static constexpr size_t PROGRESS_INTERVAL = 4096;
+
+    // 扩展数达到汇报间隔时返回true，规划器据此决定是否调用report。
+    // 单次扩展开销大的规划器（如跳点搜索）可以传入更小的间隔
+    static bool shouldReport(size_t nodesExpanded, size_t interval = PROGRESS_INTERVAL) {
+        return nodesExpanded % interval == 0;
+    }
+
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    size_t getNodesExpanded() const { return nodesExpanded_.load(std::memory_order_relaxed); }
+    // 规划线程：更新扩展数，partialPath非空时同时替换部分路径。返回false表示已被取消
+    bool report(size_t nodesExpanded, const std::vector<Point>* partialPath = nullptr);
+
+    // 部分路径的修订号，每次report新的部分路径时递增
+    uint64_t getPartialRevision() const { return partialRevision_.load(std::memory_order_acquire); }
+    // 复制最近汇报的部分路径，返回其修订号
+    uint64_t copyPartialPath(std::vector<Point>& path) const;
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> nodesExpanded_{0};
+    std::atomic<uint64_t> partialRevision_{0};
+    mutable std::mutex partialMutex_;
+    std::vector<Point> partialPath_;
+};
+
+// 异步规划的状态
+enum class PlanStatus {
+    RUNNING,    // 排队或执行中
+    SUCCEEDED,  // 找到路径
+    FAILED,     // 搜索完毕但没有路径
+    CANCELLED   // 被取消，结果无效
+};
+
+// 一次异步全局规划的句柄，由Maze::submitPlan创建并在线程池中执行
+// 完成前只能读取进度；完成后路径和统计不再变化，可以在任意线程读取。
+class PlanJob {
+public:
+    PlanJob(PlannerType planner, int startX, int startY, int goalX, int goalY)
+        : planner_(planner), startX_(startX), startY_(startY), goalX_(goalX), goalY_(goalY) {}
+
+    PlanJob(const PlanJob&) = delete;
+    PlanJob& operator=(const PlanJob&) = delete;
+
+    PlannerType getPlannerType() const { return planner_; }
+
+    PlanStatus getStatus() const { return status_.load(std::memory_order_acquire); }
+    bool isDone() const { return getStatus() != PlanStatus::RUNNING; }
+    // 阻塞到作业完成（包括被取消）
+    void wait() const;
+    // 请求取消，不等待；作业在下一次汇报进度时停止
+    void cancel() { progress_.cancel(); }
+
+    const PlanProgress& getProgress() const { return progress_; }
+
+    // 完成后有效：成功时为逐格路径
+    const std::vector<Point>& getPath() const { return path_; }
+    const PlannerStats& getStats() const { return stats_; }
+
+private:
+    friend class Maze;
+
+    // 执行线程：写完结果后设置状态并唤醒等待者
+    void finish(PlanStatus status);
+
+    const PlannerType planner_;
+    const int startX_;
+    const int startY_;
+    const int goalX_;
+    const int goalY_;
+
+    PlanProgress progress_;
+    std::vector<Point> path_;
+    PlannerStats stats_;
+
+    std::atomic<PlanStatus> status_{PlanStatus::RUNNING};
+    mutable std::mutex mutex_;
+    mutable std::condition_variable finished_;
+};
+
+} // namespace PathGlyph
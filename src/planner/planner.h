@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace PathGlyph {
+
+// 8邻域方向（上、右、下、左及四个对角线），偶数下标为直线方向，奇数下标为对角线方向
+inline constexpr int GRID_DX[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+inline constexpr int GRID_DY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// 由单位位移(dx, dy)求方向下标，(0, 0)返回-1
+inline int directionIndex(int dx, int dy) {
+    static constexpr int LOOKUP[9] = {7, 0, 1, 6, -1, 2, 5, 4, 3};
+    return LOOKUP[(dx + 1) * 3 + (dy + 1)];
+}
+
+// 移动代价（对角线移动代价为1.414，垂直/水平移动代价为1.0）
+inline constexpr double STRAIGHT_COST = 1.0;
+inline constexpr double DIAGONAL_COST = 1.414;
+
+// 八方向距离启发式，与上面的移动代价一致，因此是可采纳且一致的
+inline double octileDistance(int x1, int y1, int x2, int y2) {
+    int dx = x1 > x2 ? x1 - x2 : x2 - x1;
+    int dy = y1 > y2 ? y1 - y2 : y2 - y1;
+    int diagonal = std::min(dx, dy);
+    int straight = std::max(dx, dy) - diagonal;
+    return diagonal * DIAGONAL_COST + straight * STRAIGHT_COST;
+}
+
+// 一次搜索的统计信息
+struct PlannerStats {
+    size_t nodesExpanded = 0;   // 扩展（出队并处理）的节点数
+    size_t nodesGenerated = 0;  // 生成（入队）的节点数
+    double pathCost = 0.0;      // 找到的路径代价
+};
+
+} // namespace PathGlyph
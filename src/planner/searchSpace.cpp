@@ -0,0 +1,36 @@
+#include "planner/searchSpace.h"
+
+namespace PathGlyph {
+
+void SearchSpace::resize(int width, int height) {
+    if (width == width_ && height == height_) {
+        return;
+    }
+
+    width_ = width;
+    height_ = height;
+
+    size_t cellCount = static_cast<size_t>(width_) * static_cast<size_t>(height_);
+    g_.assign(cellCount, 0.0);
+    f_.assign(cellCount, 0.0);
+    parent_.assign(cellCount, -1);
+    seenStamp_.assign(cellCount, 0);
+    closedStamp_.assign(cellCount, 0);
+    generation_ = 0;
+
+    open_.clear();
+    open_.reserve(cellCount);
+}
+
+void SearchSpace::beginGeneration() {
+    ++generation_;
+    if (generation_ == 0) {
+        // 代数回绕，旧标记可能与新代数冲突，整体清零一次
+        std::fill(seenStamp_.begin(), seenStamp_.end(), 0);
+        std::fill(closedStamp_.begin(), closedStamp_.end(), 0);
+        generation_ = 1;
+    }
+    open_.clear();
+}
+
+} // namespace PathGlyph
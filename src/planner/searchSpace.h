@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace PathGlyph {
+
+// 网格搜索的公共状态 - 供各个基于A*的规划器复用
+// g/f/parent 按 y * width + x 下标寻址，数组在多次查询间复用。
+// 每次搜索递增代数计数器，只有 stamp 等于当前代数的格子才视为已访问，
+// 因此搜索之间无需清空数组；预热之后不再进行堆内存分配。
+class SearchSpace {
+public:
+    // 开集条目 - 二叉堆中只存放下标和排序键，过期条目出队时惰性丢弃
+    struct OpenEntry {
+        double f;
+        double g;
+        int32_t index;
+    };
+
+    // 调整内部数组大小，尺寸不变时不做任何事情
+    void resize(int width, int height);
+    // 开始新一代搜索，代数回绕时才真正清空标记数组
+    void beginGeneration();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int32_t indexOf(int x, int y) const { return y * width_ + x; }
+
+    bool isSeen(int32_t index) const { return seenStamp_[index] == generation_; }
+    bool isClosed(int32_t index) const { return closedStamp_[index] == generation_; }
+    void close(int32_t index) { closedStamp_[index] = generation_; }
+
+    double g(int32_t index) const { return g_[index]; }
+    double f(int32_t index) const { return f_[index]; }
+    int32_t parent(int32_t index) const { return parent_[index]; }
+
+    // 记录一个节点的新代价并放入开集
+    void open(int32_t index, double g, double f, int32_t parent) {
+        seenStamp_[index] = generation_;
+        g_[index] = g;
+        f_[index] = f;
+        parent_[index] = parent;
+        open_.push_back({f, g, index});
+        std::push_heap(open_.begin(), open_.end(), openCompare);
+    }
+
+    bool openEmpty() const { return open_.empty(); }
+
+    // 弹出f最小的有效条目，开集耗尽时返回false
+    bool popOpen(OpenEntry& entry) {
+        while (!open_.empty()) {
+            std::pop_heap(open_.begin(), open_.end(), openCompare);
+            entry = open_.back();
+            open_.pop_back();
+            // 惰性删除：已关闭或已被更优代价取代的条目直接跳过
+            if (!isClosed(entry.index) && entry.g <= g_[entry.index]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // 开集比较：f小者优先，f相同时g大者优先（更靠近目标）
+    static bool openCompare(const OpenEntry& a, const OpenEntry& b) {
+        return a.f > b.f || (a.f == b.f && a.g < b.g);
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+
+    std::vector<double> g_;              // 起点到该格的代价
+    std::vector<double> f_;              // g + h
+    std::vector<int32_t> parent_;        // 父格下标，起点为-1
+    std::vector<uint32_t> seenStamp_;    // 等于generation_表示本次搜索已生成
+    std::vector<uint32_t> closedStamp_;  // 等于generation_表示本次搜索已关闭
+    uint32_t generation_ = 0;
+
+    std::vector<OpenEntry> open_;        // 开集（二叉堆），容量跨搜索保留
+};
+
+} // namespace PathGlyph
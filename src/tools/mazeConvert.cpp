@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+
+#include "maze/mazeFile.h"
+
+using namespace PathGlyph;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <maze.json> [output.pgmaze]\n"
+              << "  Converts a JSON maze into the memory-mapped binary format.\n"
+              << "  The output defaults to the input path with the extension replaced by .pgmaze.\n";
+}
+
+std::string defaultOutput(const std::string& input) {
+    size_t slash = input.find_last_of("/\\");
+    size_t dot = input.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return input + MAZE_FILE_EXTENSION;
+    }
+    return input.substr(0, dot) + MAZE_FILE_EXTENSION;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3 || std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h") {
+        printUsage(argv[0]);
+        return argc < 2 || argc > 3 ? 1 : 0;
+    }
+
+    const std::string input = argv[1];
+    const std::string output = argc == 3 ? argv[2] : defaultOutput(input);
+
+    MazeFileData maze;
+    std::string error;
+    if (!readMazeJson(input, maze, error)) {
+        std::cerr << input << ": " << error << std::endl;
+        return 1;
+    }
+    if (!writeMazeFile(output, maze)) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << input << " -> " << output << " (" << maze.width << "x" << maze.height << ", "
+              << maze.dynamicObstacles.size() << " dynamic obstacles)" << std::endl;
+    return 0;
+}
@@ -2,6 +2,8 @@
 #include "gui/imgui_impl_glfw.h"
 #include "gui/imgui_impl_opengl3.h"
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
 
 namespace PathGlyph {
 
@@ -86,11 +88,52 @@ void ImGuiWindow::drawControlPanel() {
             ImGui::Checkbox("Show Wireframe", &currentState_->showWireframe);
             ImGui::Checkbox("Show Path", &currentState_->showPath);
             ImGui::Checkbox("Show Obstacles", &currentState_->showObstacles);
+            ImGui::Checkbox("Show Clearance", &currentState_->showClearance);
         }
         
         ImGui::Separator();
         
         ImGui::Text("Path Controls:");
+        
+        // 全局规划算法选择
+        PlannerType plannerType = simulation_->getPlannerType();
+        if (ImGui::RadioButton("A*", plannerType == PlannerType::ASTAR)) {
+            simulation_->setPlannerType(PlannerType::ASTAR);
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("JPS", plannerType == PlannerType::JPS)) {
+            simulation_->setPlannerType(PlannerType::JPS);
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("JPS+", plannerType == PlannerType::JPS_PLUS)) {
+            simulation_->setPlannerType(PlannerType::JPS_PLUS);
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("D* Lite", plannerType == PlannerType::DSTAR_LITE)) {
+            simulation_->setPlannerType(PlannerType::DSTAR_LITE);
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("HPA*", plannerType == PlannerType::HPA_STAR)) {
+            simulation_->setPlannerType(PlannerType::HPA_STAR);
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("Flow Field", plannerType == PlannerType::FLOW_FIELD)) {
+            simulation_->setPlannerType(PlannerType::FLOW_FIELD);
+        }
+
+        // 固定步长频率、随机种子和群体规模，种子和群体规模在下次开始仿真时生效
+        float tickRate = simulation_->getTickRate();
+        if (ImGui::SliderFloat("Tick Rate (Hz)", &tickRate, Simulation::MIN_TICK_RATE, Simulation::MAX_TICK_RATE, "%.0f")) {
+            simulation_->setTickRate(tickRate);
+        }
+        int seed = static_cast<int>(simulation_->getSeed());
+        if (ImGui::InputInt("Seed", &seed)) {
+            simulation_->setSeed(static_cast<uint32_t>(seed));
+        }
+        int crowdSize = static_cast<int>(simulation_->getCrowdSize());
+        if (ImGui::InputInt("Crowd Agents", &crowdSize, 100, 1000)) {
+            simulation_->setCrowdSize(static_cast<size_t>(std::max(crowdSize, 0)));
+        }
 
         if (ImGui::Button("Start Simulation", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
             currentState_->shouldStartSimulation = true;
@@ -99,17 +142,31 @@ void ImGuiWindow::drawControlPanel() {
             currentState_->shouldResetState = true;
         }
         
-        // 显示当前仿真状态
+        // 显示当前仿真状态，仿真在自己的线程中推进，这里只读取它发布的快照
+        const SimulationSnapshot& snapshot = simulation_->getSnapshot();
         const char* stateText = "Idle";
-        if (simulation_->isRunning()) {
+        if (snapshot.state == SimulationState::PLANNING) {
+            stateText = "Planning";
+        } else if (snapshot.state == SimulationState::RUNNING) {
             stateText = "Running";
-        } else if (simulation_->isFinished()) {
+        } else if (snapshot.state == SimulationState::FINISHED) {
             stateText = "Finished";
         }
         ImGui::Text("Simulation State: %s", stateText);
         
         // 如果仿真正在运行或已完成，显示仿真时间
-        ImGui::Text("Simulation Time: %.2f s", simulation_->getSimulationTime());
+        ImGui::Text("Simulation Time: %.2f s", snapshot.simulationTime);
+        
+        // 最近一次全局规划的统计，规划中只有扩展节点数，随搜索进度更新
+        const PlannerStats& stats = snapshot.plannerStats;
+        ImGui::Text("Nodes Expanded: %zu", stats.nodesExpanded);
+        ImGui::Text("Path Cost: %.2f", stats.pathCost);
+        if (!snapshot.current.agents.empty()) {
+            ImGui::Text("Crowd Arrived: %zu/%zu", snapshot.crowdArrived, snapshot.current.agents.size());
+        }
+        
+        ImGui::Separator();
+        drawProfiler();
     } else {
         // 编辑模式下的控制选项
         ImGui::Text("Edit Type:");
@@ -159,4 +216,34 @@ void ImGuiWindow::drawControlPanel() {
     
     ImGui::End();
 }
+
+void ImGuiWindow::drawProfiler() {
+    if (!ImGui::CollapsingHeader("Profiler")) {
+        return;
+    }
+    
+    Profiler& profiler = Profiler::shared();
+    bool enabled = profiler.isEnabled();
+    if (ImGui::Checkbox("Enable Profiling", &enabled)) {
+        profiler.setEnabled(enabled);
+    }
+    
+    profiler.snapshot(profileZones_);
+    for (const ProfileZone& zone : profileZones_) {
+        if (zone.count == 0) {
+            continue;
+        }
+        // 历史是环形缓冲，写满后从head开始才是时间顺序
+        int offset = zone.count == ProfileZone::HISTORY_SIZE ? static_cast<int>(zone.head) : 0;
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.2f ms (avg %.2f, max %.2f)", zone.last, zone.average, zone.peak);
+        
+        ImGui::Text("%s %s", zone.gpu ? "[GPU]" : "[CPU]", zone.name.c_str());
+        ImGui::PushID(&zone);
+        ImGui::PlotLines("##history", zone.history.data(), static_cast<int>(zone.count), offset,
+                         overlay, 0.0f, std::max(zone.peak, 0.1f) * 1.1f,
+                         ImVec2(ImGui::GetContentRegionAvail().x, 40.0f));
+        ImGui::PopID();
+    }
+}
 } // namespace PathGlyph 
\ No newline at end of file
@@ -4,10 +4,12 @@
 #include <memory>
 #include <string>
 #include <functional>
+#include <vector>
 #include <GLFW/glfw3.h>
 
 #include "common/types.h"
 #include "core/simulation.h"
+#include "common/profiler.h"
 
 namespace PathGlyph {
 
@@ -34,6 +36,10 @@ private:
     float sidePanelWidth_ = 250.0f;  // 侧边栏宽度
     std::shared_ptr<EditState> currentState_;  // 当前编辑状态
     std::shared_ptr<Simulation> simulation_;
+    std::vector<ProfileZone> profileZones_;  // 每帧从Profiler复制的计时数据
+    
+    // 性能分析面板：每个区域一条滚动历史曲线
+    void drawProfiler();
 };
 
 } // namespace PathGlyph 
\ No newline at end of file
@@ -18,6 +18,10 @@ if is_mode("debug") then
     set_optimize("none")
 end
 
+-- 数学函数不设置errno、浮点运算不考虑陷阱：GCC/Clang才能向量化含std::sqrt和条件选择的结构数组循环
+-- （动态障碍物、DWA评估）。两者都不改变计算结果
+add_cxflags("-fno-math-errno", "-fno-trapping-math", {tools = {"gcc", "clang"}})
+
 -- 定义目标
 target("PathGlyph")
     -- 设置为二进制目标
@@ -25,8 +29,8 @@ target("PathGlyph")
     -- 设置语言标准
     set_languages("c++20")
     
-    -- 添加源文件
-    add_files("src/**.cpp")
+    -- 添加源文件（无界面运行器、基准程序和转换工具有自己的main，单独成为目标）
+    add_files("src/**.cpp|headless/**.cpp|bench/**.cpp|tools/**.cpp")
     
     -- 添加ImGui源文件
     add_files("thirdparty/imgui/*.cpp")
@@ -53,3 +57,52 @@ target("PathGlyph")
         add_links("opengl32")
     end
     add_defines("GLFW_INCLUDE_NONE")
+
+-- 无界面仿真运行器，不依赖GLFW/OpenGL，可在没有显示的CI机器上批量运行场景
+target("pathglyph_headless")
+    set_kind("binary")
+    set_languages("c++20")
+
+    add_files("src/headless/*.cpp")
+    add_files("src/core/simulation.cpp", "src/core/agentSet.cpp")
+    add_files("src/maze/*.cpp")
+    add_files("src/planner/*.cpp")
+    add_files("src/common/*.cpp")
+
+    add_includedirs("src")
+    add_includedirs("thirdparty/tinygltf")
+
+    if is_plat("linux") then
+        add_links("pthread")
+    end
+
+-- 规划算法基准程序：读取MovingAI格式的.map/.scen，对每种算法输出耗时、扩展节点数、最优性差距和峰值内存
+target("pathglyph_bench")
+    set_kind("binary")
+    set_languages("c++20")
+
+    add_files("src/bench/*.cpp")
+    add_files("src/headless/headlessRunner.cpp")
+    add_files("src/core/simulation.cpp", "src/core/agentSet.cpp")
+    add_files("src/maze/*.cpp")
+    add_files("src/planner/*.cpp")
+    add_files("src/common/*.cpp")
+
+    add_includedirs("src")
+    add_includedirs("thirdparty/tinygltf")
+
+    if is_plat("linux") then
+        add_links("pthread")
+    end
+
+-- 迷宫格式转换工具：把JSON迷宫转换为可内存映射的二进制格式（.pgmaze）
+target("pathglyph_convert")
+    set_kind("binary")
+    set_languages("c++20")
+
+    add_files("src/tools/mazeConvert.cpp")
+    add_files("src/maze/mazeFile.cpp")
+    add_files("src/maze/mazeJson.cpp")
+
+    add_includedirs("src")
+    add_includedirs("thirdparty/tinygltf")